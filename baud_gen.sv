@@ -1,27 +1,44 @@
-// baud rate generater (divisor) 
-// divided by (dvsr+1)
-// Listing 12.1
+// baud rate generater (fractional divisor)
+// divided by (dvsr+1) + dvsr_frac/256 on average:
+// each period is dvsr+1 or dvsr+2 clocks; an 8-bit accumulator adds
+// dvsr_frac per period and its carry stretches the next period
+// (dvsr_frac=0: the original integer divisor, Listing 12.1)
 module baud_gen
    (
     input  logic clk, reset,
     input  logic [10:0] dvsr,
+    input  logic [7:0] dvsr_frac,
     output logic tick
    );
 
    // declaration
-   logic [10:0] r_reg;
-   logic [10:0] r_next;
+   logic [11:0] r_reg;
+   logic [11:0] r_next;
+   logic [7:0] acc_reg, acc_next;
+   logic ext_reg, ext_next;     // current period is one clock longer
+   logic [8:0] acc_sum;
+   logic wrap;
 
    // body
    // register
    always_ff @(posedge clk, posedge reset)
-      if (reset)
+      if (reset) begin
          r_reg <= 0;
-      else
+         acc_reg <= 0;
+         ext_reg <= 1'b0;
+      end
+      else begin
          r_reg <= r_next;
+         acc_reg <= acc_next;
+         ext_reg <= ext_next;
+      end
 
    // next-state logic
-   assign r_next = (r_reg==dvsr) ? 0 : r_reg + 1;
+   assign acc_sum = acc_reg + dvsr_frac;
+   assign wrap = (r_reg == {1'b0, dvsr} + ext_reg);
+   assign r_next = wrap ? 0 : r_reg + 1;
+   assign acc_next = wrap ? acc_sum[7:0] : acc_reg;
+   assign ext_next = wrap ? acc_sum[8] : ext_reg;
    // output logic
    assign tick = (r_reg==1);
 endmodule
\ No newline at end of file
@@ -0,0 +1,220 @@
+/*****************************************************************//**
+ * @file chu_fmt.h
+ *
+ * @brief Division-free integer to text conversion
+ *
+ * Detailed description:
+ *  - the MicroBlaze MCS has no hardware divider; "n % base" and
+ *    "n / base" per digit are calls to a software division routine
+ *  - base 2/8/16: shift and mask
+ *  - base 10: two digits per step from a 200-byte table; n/100 is a
+ *    multiply by a reciprocal (exact for any 32-bit n)
+ *  - 64-bit base 10 (e.g., timer ticks): 4 digits per step, splitting
+ *    n in 16-bit limbs so each step is a 32-bit reciprocal multiply;
+ *    the rest is converted with the 32-bit routine once n < 2^32
+ *  - each function writes the digits backward, ending just before end,
+ *    and returns a pointer to the first digit (no terminator, no sign)
+ *  - fractions: a Q0.32 fraction gives one decimal digit per integer
+ *    multiply by 10 (digits are truncated, not rounded); fmt_dbl_split()
+ *    takes a double apart into sign, integer part and Q0.32 fraction
+ *    with integer operations on its IEEE-754 bits, so a double is
+ *    formatted without floating-point (soft-float) library calls
+ *  - usage:
+ *      char buf[12], *s;
+ *      buf[11] = '\0';
+ *      s = fmt_dec32(&buf[11], 1234);   // s -> "1234"
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _CHU_FMT_H_INCLUDED
+#define _CHU_FMT_H_INCLUDED
+
+#include <stdint.h>
+#include <string.h>
+
+/** "00" to "99" */
+inline const char *fmt_digit_pairs() {
+   static const char pairs[201] =
+         "00010203040506070809" "10111213141516171819"
+         "20212223242526272829" "30313233343536373839"
+         "40414243444546474849" "50515253545556575859"
+         "60616263646566676869" "70717273747576777879"
+         "80818283848586878889" "90919293949596979899";
+   return (pairs);
+}
+
+/** n / 100 for any 32-bit n */
+inline uint32_t fmt_div100(uint32_t n) {
+   return ((uint32_t) (((uint64_t) n * 1374389535u) >> 37));
+}
+
+/** n / 10000 for any 32-bit n */
+inline uint32_t fmt_div10000(uint32_t n) {
+   return ((uint32_t) (((uint64_t) n * 3518437209u) >> 45));
+}
+
+/**
+ * 32-bit unsigned in base 10
+ * @param end one past the last digit
+ * @return first digit
+ *
+ */
+inline char *fmt_dec32(char *end, uint32_t n) {
+   const char *pairs = fmt_digit_pairs();
+   uint32_t q, r;
+
+   while (n >= 100) {
+      q = fmt_div100(n);
+      r = n - q * 100;
+      *--end = pairs[2 * r + 1];
+      *--end = pairs[2 * r];
+      n = q;
+   }
+   if (n >= 10) {
+      *--end = pairs[2 * n + 1];
+      *--end = pairs[2 * n];
+   } else {
+      *--end = (char) ('0' + n);
+   }
+   return (end);
+}
+
+/**
+ * 64-bit unsigned in base 10
+ * @param end one past the last digit
+ * @return first digit
+ *
+ */
+inline char *fmt_dec64(char *end, uint64_t n) {
+   const char *pairs = fmt_digit_pairs();
+   uint32_t x, q, r, hi;
+   uint64_t quo;
+   int i;
+
+   while (n >> 32) {
+      // n / 10000 by 16-bit limbs (x < 10000 * 2^16 fits 32 bits)
+      quo = 0;
+      r = 0;
+      for (i = (n >> 48) ? 3 : 2; i >= 0; i--) {
+         x = r << 16 | ((uint32_t) (n >> (16 * i)) & 0xffff);
+         q = fmt_div10000(x);
+         r = x - q * 10000;
+         quo = quo << 16 | q;
+      }
+      hi = fmt_div100(r);
+      r = r - hi * 100;
+      *--end = pairs[2 * r + 1];
+      *--end = pairs[2 * r];
+      *--end = pairs[2 * hi + 1];
+      *--end = pairs[2 * hi];
+      n = quo;
+   }
+   return (fmt_dec32(end, (uint32_t) n));
+}
+
+/**
+ * 32-bit unsigned in base 2, 8 or 16 (lowercase)
+ * @param end one past the last digit
+ * @param shift log2(base): 1, 3 or 4
+ * @return first digit
+ *
+ */
+inline char *fmt_pow2_32(char *end, uint32_t n, int shift) {
+   uint32_t mask = (1u << shift) - 1;
+
+   do {
+      *--end = "0123456789abcdef"[n & mask];
+      n = n >> shift;
+   } while (n);
+   return (end);
+}
+
+/**
+ * 64-bit unsigned in base 2, 8 or 16 (lowercase)
+ * @param end one past the last digit
+ * @param shift log2(base): 1, 3 or 4
+ * @return first digit
+ *
+ */
+inline char *fmt_pow2_64(char *end, uint64_t n, int shift) {
+   uint32_t mask = (1u << shift) - 1;
+
+   do {
+      *--end = "0123456789abcdef"[(uint32_t) n & mask];
+      n = n >> shift;
+   } while (n);
+   return (end);
+}
+
+/**
+ * decimal digits of a Q0.32 fraction (truncated)
+ * @param p first digit (written forward)
+ * @param fq fraction * 2^32
+ * @param digit # of digits
+ * @return one past the last digit
+ *
+ */
+inline char *fmt_frac_q32(char *p, uint32_t fq, int digit) {
+   uint64_t t;
+
+   while (digit-- > 0) {
+      t = (uint64_t) fq * 10;
+      *p++ = (char) ('0' + (uint32_t) (t >> 32));
+      fq = (uint32_t) t;
+   }
+   return (p);
+}
+
+/**
+ * split a double into sign, integer part and Q0.32 fraction
+ * @param f value
+ * @param ip integer part of |f| (saturated at 2^32-1; 0 for nan)
+ * @param fq fraction of |f| * 2^32, rounded up (without carry into ip),
+ *        so a decimal stored slightly low (0.29 is 0.28999...) still
+ *        gives its digits
+ * @return 1 if f < 0; 0 otherwise
+ *
+ */
+inline int fmt_dbl_split(double f, uint32_t *ip, uint32_t *fq) {
+   uint64_t bits, m, low;
+   int e, s, neg;
+
+   memcpy(&bits, &f, sizeof(bits));
+   neg = (int) (bits >> 63) && (bits << 1) != 0;
+   e = (int) (bits >> 52) & 0x7ff;
+   m = bits & 0x000fffffffffffffULL;
+   *ip = 0;
+   *fq = 0;
+   if (e == 0x7ff) {
+      if (m == 0)
+         *ip = 0xffffffff;      // inf
+      return (neg);
+   }
+   if (e == 0)
+      return (neg);             // zero and subnormals print as 0
+   m = m | 0x0010000000000000ULL;
+   s = 1075 - e;                // |f| = m * 2^-s
+   if (s <= 20) {
+      *ip = 0xffffffff;         // |f| >= 2^32
+      return (neg);
+   }
+   if (s < 64) {
+      *ip = (uint32_t) (m >> s);
+      low = m & ((1ULL << s) - 1);
+   } else {
+      low = m;
+   }
+   if (s <= 32) {
+      *fq = (uint32_t) (low << (32 - s));
+   } else if (s - 32 < 64) {
+      low = (low + ((1ULL << (s - 32)) - 1)) >> (s - 32);
+      *fq = (low >> 32) ? 0xffffffff : (uint32_t) low;
+   } else {
+      *fq = 1;
+   }
+   return (neg);
+}
+
+#endif  // _CHU_FMT_H_INCLUDED
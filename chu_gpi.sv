@@ -1,3 +1,6 @@
+// offsets from chu_io_map.svh (generated from chu_io_map.def)
+`include "chu_io_map.svh"
+
 module chu_gpi
    #(parameter W = 8) // width of input port
    (
@@ -24,7 +27,8 @@ module chu_gpi
       else   
          rd_data_reg <= din;
        
-   assign rd_data[W-1:0] = rd_data_reg;
+   // slot read interface
+   assign rd_data[W-1:0] = (addr == `GPI_DATA_REG) ? rd_data_reg : 0;
    assign rd_data[31:W] = 0;
 endmodule
 
@@ -1,3 +1,6 @@
+// offsets from chu_io_map.svh (generated from chu_io_map.def)
+`include "chu_io_map.svh"
+
 module chu_gpo
    #(parameter W = 8)  // width of output port
    (
@@ -27,7 +30,7 @@ module chu_gpo
          if (wr_en)
             buf_reg <= wr_data[W-1:0];
    // decoding logic 
-   assign wr_en = cs && write;
+   assign wr_en = cs && write && (addr == `GPO_DATA_REG);
    // slot read interface
    assign rd_data =  0;
    // external output  
@@ -1,3 +1,6 @@
+// offsets/fields from chu_io_map.svh (generated from chu_io_map.def)
+`include "chu_io_map.svh"
+
 module chu_i2c_core
    (
     input  logic clk,
@@ -23,7 +26,8 @@ module chu_i2c_core
    // instantiate spi controller
    i2c_master i2c_unit
    (
-    .din(wr_data[7:0]), .cmd(wr_data[10:8]),
+    .din(wr_data[`I2C_DIN_MSB:`I2C_DIN_LSB]),
+    .cmd(wr_data[`I2C_CMD_MSB:`I2C_CMD_LSB]),
     .dvsr(dvsr_reg), .done_tick(), .*
    );
        
@@ -35,8 +39,8 @@ module chu_i2c_core
          if (wr_dvsr)
              dvsr_reg <= wr_data[15:0];
    // decoding
-   assign wr_dvsr = cs & write & ~addr[0];
-   assign wr_i2c  = cs & write & addr[0];
+   assign wr_dvsr = cs & write & (addr[0]==`I2C_DVSR_REG);
+   assign wr_i2c  = cs & write & (addr[0]==`I2C_WR_REG);
    // read data  
    assign rd_data = {22'b0, ack, ready, dout};
 endmodule  
@@ -24,24 +24,34 @@
 TimerCore _sys_timer(get_slot_addr(BRIDGE_BASE, TIMER_SLOT));
 UartCore uart(get_slot_addr(BRIDGE_BASE, UART_SLOT));
 
+// current system time in clocks
+uint64_t now_tick() {
+   return (_sys_timer.read_tick());
+}
+
 // current system time in microsecond
 unsigned long now_us() {
-   return ((unsigned long) _sys_timer.read_time());
+   return ((unsigned long) TimerCore::tick2us(_sys_timer.read_tick()));
 }
 
-// current system time in ms
+// current system time in ms (one conversion; not us / 1000)
 unsigned long now_ms() {
-   return ((unsigned long) _sys_timer.read_time() / 1000);
+   return ((unsigned long) TimerCore::tick2ms(_sys_timer.read_tick()));
 }
 
 // idle for t microseconds
 void sleep_us(unsigned long int t) {
-   _sys_timer.sleep(uint64_t(t));
+   _sys_timer.sleep_tick(TimerCore::us2tick(t));
 }
 
 // idle for t ms
 void sleep_ms(unsigned long int t) {
-   _sys_timer.sleep(uint64_t(1000 * t));
+   _sys_timer.sleep_tick(TimerCore::ms2tick(t));
+}
+
+// idle until an absolute time in clocks
+void sleep_until_tick(uint64_t tick) {
+   _sys_timer.sleep_until(tick);
 }
 
 // debug asserted
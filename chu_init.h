@@ -45,6 +45,13 @@ extern "C" {
 #define TIMER_SLOT 0
 #define UART_SLOT 1
 
+/**
+ * Current system "up time" in clocks (SYS_CLK_FREQ MHz).
+ * @note use with TimerCore::us2tick()/ms2tick() to keep deadlines in
+ *       clocks without unit conversion
+ */
+uint64_t now_tick();
+
 /**
  * Current system "up time" in microsecond.
  */
@@ -67,21 +74,30 @@ void sleep_us(unsigned long int t);
  */
 void sleep_ms(unsigned long int t);
 
+/**
+ * idle until the system "up time" reaches tick (clocks).
+ * @param tick absolute time as returned by now_tick()
+ * @note returns at once if tick has passed
+ */
+void sleep_until_tick(uint64_t tick);
+
 
 /**********************************************************************
  * debug(): function to facilitate debugging
  *  - send a one0line message via "uart"
  *  - controlled by _DEBUG
  *  - _DEBUG must be defined in individual file
- *  - replaced with debug_off() when _DEBUG not defined
+ *  - expands to nothing when _DEBUG not defined (no call, arguments
+ *    not evaluated)
  *  - replaced with debug_on() when _DEBUG defined
  *  - debug_on()print a 1-line message (a string plus 2 numbers)
+ *  - leveled logging that can stay in production code: chu_log.h
  *
  *********************************************************************/
 
 /**
  * dummy function.
- @note substitute debug() when _DEBUG is not defined
+ @note kept for old code; debug() no longer calls it
  */
 void debug_off();
 
@@ -95,7 +111,7 @@ void debug_off();
 void debug_on(const char *str, int n1, int n2);
 
 #ifndef _DEBUG
-#define debug(str, n1, n2) debug_off()
+#define debug(str, n1, n2) ((void) 0)
 #endif // not _DEBUG#ifdef _DEBUG
 #define debug(str, n1, n2) debug_on((str), (n1), (n2))
 #endif // not _DEBUG#ifdef __cplusplus
@@ -0,0 +1,133 @@
+/*****************************************************************//**
+ * @file chu_io_batch.h
+ *
+ * @brief Batched (scatter-gather) MMIO writes
+ *
+ * Detailed description:
+ *  - IoBatch is a list of (address, data) write descriptors that may
+ *    span several slots; flush() issues them back to back with
+ *    io_wr_burst() (one call into the simulated/co-simulated bus)
+ *  - a driver given a batch with set_batch() (GpoCore, PwmCore,
+ *    SsegCore) queues its register writes instead of issuing them;
+ *    the application flushes once after updating all outputs
+ *  - a queued write to an address already in the list replaces its
+ *    data (only the last value reaches the core); so only for
+ *    registers without write side effects
+ *  - a full batch is flushed before the next write is queued
+ *  - io_queue() is a macro so that access accounting in chu_io_rw.h
+ *    counts each write at the driver method that queued it (a write
+ *    that replaces a pending one is not counted)
+ *  - usage:
+ *      IoBatch out;
+ *      sseg.set_batch(&out);
+ *      pwm.set_batch(&out);
+ *      ... update sseg and pwm ...
+ *      out.flush();
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _CHU_IO_BATCH_H_INCLUDED
+#define _CHU_IO_BATCH_H_INCLUDED
+
+#include "chu_io_rw.h"
+
+#ifndef IO_BATCH_SIZE
+#define IO_BATCH_SIZE 16      // max # pending writes
+#endif
+
+/**
+ * pending write list
+ */
+class IoBatch {
+public:
+   IoBatch() {
+      n = 0;
+      n_queued = 0;
+      n_flush = 0;
+   }
+
+   /**
+    * queue a write (use io_queue() in drivers)
+    * @param addr byte address of the register
+    * @param data 32-bit data
+    * @return 1 if appended; 0 if it replaced the data of a pending write
+    */
+   int add(uint32_t addr, uint32_t data) {
+      int i;
+
+      n_queued++;
+      for (i = 0; i < n; i++) {
+         if (desc[i].addr == addr) {
+            desc[i].data = data;
+            return (0);
+         }
+      }
+      if (n == IO_BATCH_SIZE)
+         flush();
+      desc[n].addr = addr;
+      desc[n].data = data;
+      n++;
+      return (1);
+   }
+
+   /**
+    * issue all pending writes in queued order
+    */
+   void flush() {
+      if (n == 0)
+         return;
+      io_wr_burst(desc, n);
+      n_flush++;
+      n = 0;
+   }
+
+   /** # pending writes */
+   int pending() {
+      return (n);
+   }
+
+   /** # writes queued (incl. replaced ones) */
+   unsigned long queued() {
+      return (n_queued);
+   }
+
+   /** # non-empty flushes */
+   unsigned long flushes() {
+      return (n_flush);
+   }
+
+private:
+   IoWrDesc desc[IO_BATCH_SIZE];
+   int n;
+   unsigned long n_queued;
+   unsigned long n_flush;
+};
+
+/**
+ * queue a register write into a batch
+ * @param batch IoBatch object
+ * @param base_addr base address of an io core
+ * @param offset register word offset
+ * @param data 32-bit data
+ */
+#ifdef _IO_STATS_USED
+#define io_queue(batch, base_addr, offset, data) \
+   ((batch).add((uint32_t)((base_addr) + 4*(offset)), (uint32_t)(data)) \
+      ? io_stat_count((uint32_t)((base_addr) + 4*(offset)), 1, IO_STAT_SITE) \
+      : (void) 0)
+#else
+#define io_queue(batch, base_addr, offset, data) \
+   ((void) (batch).add((uint32_t)((base_addr) + 4*(offset)), (uint32_t)(data)))
+#endif
+
+/**
+ * queue a write if a batch is given; write immediately otherwise
+ * @param batch_p pointer to an IoBatch; 0 for immediate write
+ */
+#define io_write_or_queue(batch_p, base_addr, offset, data) \
+   ((batch_p) ? io_queue(*(batch_p), base_addr, offset, data) \
+              : (void) io_write(base_addr, offset, data))
+
+#endif  // _CHU_IO_BATCH_H_INCLUDED
@@ -0,0 +1,346 @@
+/*****************************************************************//**
+ * @file chu_io_cosim.cpp
+ *
+ * @brief implementation of the Verilator co-simulation backend
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _SIM_IO_ACCESS_USED
+#define _SIM_IO_ACCESS_USED
+#endif
+
+#include <stdio.h>
+#include "verilated.h"
+#include "Vmmio_sys_cosim.h"
+#include "Vmmio_sys_cosim__Dpi.h"
+#include "chu_io_rw.h"
+#include "uart_core.h"
+#include "chu_io_cosim.h"
+
+/**********************************************************************
+ * backend selection
+ **********************************************************************/
+CosimBus &cosim_bus() {
+   // constructed on first use (global driver constructors access the bus)
+   static CosimBus bus;
+   return (bus);
+}
+
+// overrides the weak default in chu_io_sim.cpp
+SimBusBackend *sim_default_backend() {
+   return (&cosim_bus());
+}
+
+// xadc DRP read (cosim_xadc_fpro.sv); channel code to SimXadc register
+int cosim_xadc_data(int channel) {
+   int reg;
+
+   switch (channel) {
+   case 0x00: reg = 4; break;   // temp
+   case 0x01: reg = 5; break;   // vccint
+   case 0x13: reg = 0; break;   // vaux3
+   case 0x1a: reg = 1; break;   // vaux10
+   case 0x12: reg = 2; break;   // vaux2
+   case 0x1b: reg = 3; break;   // vaux11
+   default: return (0);
+   }
+   return ((int) cosim_bus().adc().read(reg));
+}
+
+/**********************************************************************
+ * CosimBus
+ **********************************************************************/
+CosimBus::CosimBus() : xadc(0) {
+   ctx = new VerilatedContext;
+   top = new Vmmio_sys_cosim(ctx);
+   clk = 0;
+   access_cycles = DEF_ACCESS_CYCLES;
+   n_rd = 0;
+   n_wr = 0;
+   for (int i = 0; i < 8; i++)
+      sseg_ptn[i] = 0xff;
+   uart_dvsr = 0;
+   tx_state = 0;
+   tx_bit = 0;
+   tx_next = 0;
+   tx_shreg = 0;
+   rx_bit = -1;
+   rx_next = 0;
+   rx_frame = 0;
+   echo = 1;
+   i2c_state = I2C_IDLE;
+   scl_prev = 1;
+   sda_prev = 1;
+   i2c_bit = 0;
+   i2c_shreg = 0;
+   i2c_addr_phase = 0;
+   i2c_sel = 0;
+   i2c_rd = 0;
+   i2c_mack = 0;
+   sda_low = 0;
+   top->clk = 0;
+   top->mmio_cs = 0;
+   top->mmio_wr = 0;
+   top->mmio_rd = 0;
+   top->mmio_addr = 0;
+   top->mmio_wr_data = 0;
+   top->sw = 0;
+   top->rx = 1;
+   top->sda_slave_low = 0;
+   reset();
+}
+
+CosimBus::~CosimBus() {
+   top->final();
+   fflush(stdout);
+   delete top;
+   delete ctx;
+}
+
+void CosimBus::reset() {
+   top->reset = 1;
+   for (int i = 0; i < RESET_CYCLES; i++)
+      step();
+   top->reset = 0;
+   top->eval();
+}
+
+// one system clock: rising edge, pin models, falling edge
+void CosimBus::step() {
+   top->clk = 1;
+   top->eval();
+   clk++;
+   uart_pins();
+   i2c_pins();
+   for (int i = 0; i < 8; i++)
+      if (((top->an >> i) & 0x01) == 0)
+         sseg_ptn[i] = top->sseg;
+   top->clk = 0;
+   top->eval();
+}
+
+void CosimBus::advance(uint64_t n) {
+   for (uint64_t i = 0; i < n; i++)
+      step();
+}
+
+// chu_mcs_bridge: word address; i/o space when addr[23] = 0
+uint32_t CosimBus::read(uint32_t addr) {
+   uint32_t data;
+
+   n_rd++;
+   if ((addr & 0xff800000) != BRIDGE_BASE) {
+      advance(access_cycles);
+      return (0);
+   }
+   top->mmio_addr = (addr >> 2) & 0x001fffff;
+   top->mmio_cs = 1;
+   top->mmio_rd = 1;
+   top->eval();
+   data = top->mmio_rd_data;   // combinational read path
+   step();
+   top->mmio_cs = 0;
+   top->mmio_rd = 0;
+   advance(access_cycles - 1);
+   return (data);
+}
+
+// one clock with mmio_wr asserted (no clock if addr is not mmio)
+void CosimBus::strobe_wr(uint32_t addr, uint32_t data) {
+   uint32_t fp_addr;
+
+   n_wr++;
+   if ((addr & 0xff800000) != BRIDGE_BASE)
+      return;
+   fp_addr = (addr >> 2) & 0x001fffff;
+   // snoop the uart divisor for the line models (slot 1, reg 1)
+   if (fp_addr == ((uint32_t) S1_UART1 << 5 | UartCore::DVSR_REG))
+      uart_dvsr = data & (UART_DVSR_FIELD | UART_DVSR_FRAC_FIELD);
+   top->mmio_addr = fp_addr;
+   top->mmio_wr_data = data;
+   top->mmio_cs = 1;
+   top->mmio_wr = 1;
+   step();
+   top->mmio_cs = 0;
+   top->mmio_wr = 0;
+}
+
+void CosimBus::write(uint32_t addr, uint32_t data) {
+   uint64_t start = clk;
+
+   strobe_wr(addr, data);
+   advance(start + access_cycles - clk);
+}
+
+void CosimBus::write_burst(const IoWrDesc *desc, int n) {
+   uint64_t start = clk;
+
+   for (int i = 0; i < n; i++)
+      strobe_wr(desc[i].addr, desc[i].data);
+   advance(start + (uint64_t) n * access_cycles - clk);
+}
+
+void CosimBus::set_sw(uint32_t data) {
+   top->sw = data & 0xffff;
+}
+
+uint32_t CosimBus::led() {
+   return (top->led);
+}
+
+uint32_t CosimBus::pwm() {
+   return (top->pwm);
+}
+
+int CosimBus::timer_irq() {
+   return (top->timer_irq);
+}
+
+int CosimBus::wdt_reset() {
+   return (top->wdt_reset);
+}
+
+/**********************************************************************
+ * uart line models
+ **********************************************************************/
+// 16 baud ticks per bit; a tick every dvsr+1+frac/256 clocks
+uint64_t CosimBus::bit_cycles() {
+   uint32_t dvsr = (uart_dvsr & UART_DVSR_FIELD) >> UART_DVSR_LSB;
+   uint32_t frac = (uart_dvsr & UART_DVSR_FRAC_FIELD) >> UART_DVSR_FRAC_LSB;
+
+   return ((uint64_t) (256 * (dvsr + 1) + frac) / 16);
+}
+
+void CosimBus::uart_pins() {
+   uint64_t bc = bit_cycles();
+
+   // tx: wait for start bit, then sample in the middle of each bit
+   if (tx_state == 0) {
+      if (top->tx == 0 && uart_dvsr != 0) {
+         tx_state = 1;
+         tx_bit = 0;
+         tx_shreg = 0;
+         tx_next = clk + bc / 2 + bc;
+      }
+   } else if (clk >= tx_next) {
+      if (tx_bit < 8) {
+         tx_shreg = (tx_shreg >> 1) | (top->tx ? 0x80 : 0x00);
+         tx_bit++;
+         tx_next = tx_next + bc;
+      } else {
+         // stop bit; framing errors are not checked
+         log.push_back((char) tx_shreg);
+         if (echo) {
+            putchar(tx_shreg);
+            fflush(stdout);
+         }
+         tx_state = 0;
+      }
+   }
+   // rx: shift out {stop, data, start}, lsb first
+   if (rx_bit < 0) {
+      if (!rx_queue.empty() && uart_dvsr != 0) {
+         rx_frame = (uint16_t) (0x200 | (rx_queue.front() << 1));
+         rx_queue.pop_front();
+         rx_bit = 0;
+         rx_next = clk;
+      }
+   } else if (clk >= rx_next) {
+      if (rx_bit < 10) {
+         top->rx = (rx_frame >> rx_bit) & 0x01;
+         rx_bit++;
+         rx_next = rx_next + bc;
+      } else {
+         top->rx = 1;
+         rx_bit = -1;
+      }
+   }
+}
+
+/**********************************************************************
+ * i2c slave (ADT7420 at SimAdt7420::DEV_ADDR)
+ **********************************************************************/
+//  - sda changes only while scl is low; START/STOP are sda edges
+//    while scl is high
+//  - data/ack sampled on scl rising edge, driven on scl falling edge
+void CosimBus::i2c_pins() {
+   int scl = top->scl;
+   int sda = top->sda;
+
+   if (scl && scl_prev && sda != sda_prev) {
+      if (!sda) {   // START or repeated START
+         i2c_state = I2C_RX;
+         i2c_addr_phase = 1;
+      } else {      // STOP
+         i2c_state = I2C_IDLE;
+      }
+      i2c_bit = 0;
+      i2c_shreg = 0;
+      sda_low = 0;
+   } else if (scl && !scl_prev) {   // rising edge: sample
+      if (i2c_state == I2C_RX) {
+         i2c_shreg = (uint8_t) ((i2c_shreg << 1) | sda);
+         i2c_bit++;
+      } else if (i2c_state == I2C_TX_ACK) {
+         i2c_mack = !sda;
+      }
+   } else if (!scl && scl_prev) {   // falling edge: drive
+      switch (i2c_state) {
+      case I2C_RX:
+         if (i2c_bit == 8) {
+            if (i2c_addr_phase) {
+               i2c_sel = ((i2c_shreg >> 1) == SimAdt7420::DEV_ADDR);
+               i2c_rd = i2c_shreg & 0x01;
+               if (i2c_sel && !i2c_rd)
+                  sensor.start_write();
+            } else if (i2c_sel) {
+               sensor.write(i2c_shreg);
+            }
+            sda_low = i2c_sel;   // ack
+            i2c_state = I2C_RX_ACK;
+         }
+         break;
+      case I2C_RX_ACK:
+         sda_low = 0;
+         i2c_bit = 0;
+         i2c_shreg = 0;
+         if (!i2c_sel) {
+            i2c_state = I2C_IDLE;
+         } else if (i2c_addr_phase && i2c_rd) {
+            i2c_shreg = sensor.read();
+            sda_low = !(i2c_shreg & 0x80);
+            i2c_state = I2C_TX;
+         } else {
+            i2c_state = I2C_RX;
+         }
+         i2c_addr_phase = 0;
+         break;
+      case I2C_TX:
+         i2c_bit++;
+         if (i2c_bit == 8) {
+            sda_low = 0;   // release for master ack
+            i2c_state = I2C_TX_ACK;
+         } else {
+            sda_low = !((i2c_shreg << i2c_bit) & 0x80);
+         }
+         break;
+      case I2C_TX_ACK:
+         if (i2c_mack) {
+            i2c_bit = 0;
+            i2c_shreg = sensor.read();
+            sda_low = !(i2c_shreg & 0x80);
+            i2c_state = I2C_TX;
+         } else {
+            i2c_state = I2C_IDLE;
+         }
+         break;
+      default:
+         break;
+      }
+   }
+   scl_prev = scl;
+   sda_prev = sda;
+   top->sda_slave_low = sda_low;
+}
@@ -0,0 +1,129 @@
+/*****************************************************************//**
+ * @file chu_io_cosim.h
+ *
+ * @brief Verilator co-simulation backend of the simulated FPro bus
+ *
+ * Detailed description:
+ *  - drives the FPro bus of the Verilated mmio_sys_sampler RTL
+ *    (wrapped by mmio_sys_cosim.sv) from io_read()/io_write()
+ *  - each access is a single-clock mmio_cs/mmio_rd/mmio_wr cycle as
+ *    generated by chu_mcs_bridge, followed by idle clocks so that an
+ *    access takes access_cycles clocks (MCS load/store latency)
+ *  - a burst (io_wr_burst()) drives its writes on consecutive clocks
+ *    and then idles for the remaining clocks of all n accesses
+ *  - the RTL runs every clock; the timer, fifo, baud rate and i2c
+ *    timing are therefore those of the hardware
+ *  - pin-level models attached to the board pins:
+ *    - uart: tx line decoder (tx_log()) and rx line serializer
+ *    - i2c: ADT7420 slave (open-drain sda; reuses SimAdt7420)
+ *    - xadc: cosim_xadc_fpro.sv returns the SimXadc register values
+ *  - linking chu_io_cosim.cpp makes the co-simulation the default
+ *    backend (sim_default_backend()), so unmodified applications run
+ *    against the RTL; see cosim_main.cpp for the build
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ *********************************************************************/
+
+#ifndef _CHU_IO_COSIM_H_INCLUDED
+#define _CHU_IO_COSIM_H_INCLUDED
+
+#include <inttypes.h>
+#include <deque>
+#include <string>
+#include "chu_io_sim.h"
+
+class VerilatedContext;
+class Vmmio_sys_cosim;
+
+/**
+ * co-simulation bus:
+ *  - owns the Verilated model; time advances only through bus accesses
+ *    and advance()
+ */
+class CosimBus : public SimBusBackend {
+public:
+   enum {
+      DEF_ACCESS_CYCLES = SimBus::DEF_ACCESS_CYCLES,
+      RESET_CYCLES = 4
+   };
+   CosimBus();
+   ~CosimBus();
+   uint32_t read(uint32_t addr);
+   void write(uint32_t addr, uint32_t data);
+   void write_burst(const IoWrDesc *desc, int n);
+
+   /** assert reset for RESET_CYCLES clocks */
+   void reset();
+   /** # clocks since construction */
+   uint64_t cycle() { return clk; }
+   /** run n clocks with the bus idle */
+   void advance(uint64_t n);
+   /** set # clocks consumed by each bus access (min 1) */
+   void set_access_cycles(uint32_t n) { access_cycles = (n < 1) ? 1 : n; }
+   unsigned long reads() { return n_rd; }
+   unsigned long writes() { return n_wr; }
+
+   /* board pins */
+   void set_sw(uint32_t data);
+   uint32_t led();
+   uint32_t pwm();
+   /** system timer alarm interrupt line */
+   int timer_irq();
+   /** watchdog reset request line */
+   int wdt_reset();
+   /** 8-bit pattern of digit pos (0 is rightmost) as last driven */
+   uint8_t sseg(int pos) { return sseg_ptn[pos & 0x07]; }
+
+   /* uart line */
+   /** bytes decoded from the tx line */
+   std::string &tx_log() { return log; }
+   void set_echo(int on) { echo = on; }
+   /** send a byte on the rx line */
+   void rx_push(uint8_t byte) { rx_queue.push_back(byte); }
+
+   /* attached devices */
+   SimXadc &adc() { return xadc; }
+   SimAdt7420 &adt7420() { return sensor; }
+
+private:
+   VerilatedContext *ctx;
+   Vmmio_sys_cosim *top;
+   uint64_t clk;
+   uint32_t access_cycles;
+   unsigned long n_rd, n_wr;
+   uint8_t sseg_ptn[8];
+   SimXadc xadc;
+   SimAdt7420 sensor;
+   // uart line models (bit time snooped from dvsr register writes)
+   uint32_t uart_dvsr;
+   int tx_state, tx_bit;
+   uint64_t tx_next;
+   uint8_t tx_shreg;
+   std::deque<uint8_t> rx_queue;
+   int rx_bit;
+   uint64_t rx_next;
+   uint16_t rx_frame;
+   std::string log;
+   int echo;
+   // i2c slave
+   enum { I2C_IDLE, I2C_RX, I2C_RX_ACK, I2C_TX, I2C_TX_ACK } i2c_state;
+   int scl_prev, sda_prev;
+   int i2c_bit;
+   uint8_t i2c_shreg;
+   int i2c_addr_phase, i2c_sel, i2c_rd, i2c_mack;
+   int sda_low;
+
+   uint64_t bit_cycles();
+   void step();
+   void strobe_wr(uint32_t addr, uint32_t data);
+   void uart_pins();
+   void i2c_pins();
+};
+
+/**
+ * return the co-simulation bus (created on first use)
+ */
+CosimBus &cosim_bus();
+
+#endif  // _CHU_IO_COSIM_H_INCLUDED
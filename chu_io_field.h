@@ -0,0 +1,119 @@
+/*****************************************************************//**
+ * @file chu_io_field.h
+ *
+ * @brief Compile-time register and bit-field descriptors
+ *
+ * Detailed description:
+ *  - IoReg<OFFSET, ACCESS, COUNT> describes a register of a core
+ *  - IoField<REG, LSB, WIDTH> describes a bit field of a register;
+ *    mask and shift are constants, so get()/test()/put() compile to
+ *    a single and/shift
+ *  - the descriptors of all cores are generated into chu_io_regs.h
+ *    from chu_io_map.def
+ *  - io_read_reg()/io_write_reg()/io_read_field() reject a read of a
+ *    write-only register (and vice versa) at compile time
+ *  - usage:
+ *      if (io_read_field(base_addr, uart_regs::RX_EMPT)) ...
+ *      io_write_reg(base_addr, uart_regs::WR_DATA_REG, byte);
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _CHU_IO_FIELD_H_INCLUDED
+#define _CHU_IO_FIELD_H_INCLUDED
+
+#include "chu_io_rw.h"
+
+/**
+ * register access
+ */
+enum {
+   IO_RD = 1,   /**< readable */
+   IO_WR = 2,   /**< writable */
+   IO_RW = 3
+};
+
+/**
+ * register descriptor
+ * @param OFFSET word offset within the slot
+ * @param ACCESS IO_RD, IO_WR or IO_RW
+ * @param COUNT # consecutive registers of an array (e.g., pwm duty)
+ */
+template <int OFFSET, int ACCESS, int COUNT = 1>
+struct IoReg {
+   static_assert(OFFSET >= 0 && COUNT >= 1 && OFFSET + COUNT <= 32,
+                 "register outside the 32-word slot");
+   static constexpr int offset = OFFSET;
+   static constexpr int access = ACCESS;
+   static constexpr int count = COUNT;
+};
+
+/**
+ * bit-field descriptor
+ * @param REG register containing the field
+ * @param LSB position of the least significant bit
+ * @param WIDTH # bits
+ */
+template <class REG, int LSB, int WIDTH>
+struct IoField {
+   static_assert(LSB >= 0 && WIDTH >= 1 && LSB + WIDTH <= 32,
+                 "field outside the 32-bit register");
+   typedef REG reg;
+   static constexpr int lsb = LSB;
+   static constexpr int width = WIDTH;
+   static constexpr uint32_t mask =
+         (uint32_t) (((1ULL << WIDTH) - 1) << LSB);   /**< field in place */
+
+   /** extract the field from a register word (right justified) */
+   static constexpr uint32_t get(uint32_t word) {
+      return ((word & mask) >> LSB);
+   }
+
+   /** 1 if any bit of the field is set */
+   static constexpr int test(uint32_t word) {
+      return ((word & mask) != 0);
+   }
+
+   /** position a value in the field */
+   static constexpr uint32_t put(uint32_t value) {
+      return ((value << LSB) & mask);
+   }
+
+   /** replace the field of a register word */
+   static constexpr uint32_t replace(uint32_t word, uint32_t value) {
+      return ((word & ~mask) | put(value));
+   }
+};
+
+/* access checks used by the macros below */
+template <class REG>
+struct IoRdCheck {
+   static_assert(REG::access & IO_RD, "register is write-only");
+   static constexpr int offset = REG::offset;
+};
+
+template <class REG>
+struct IoWrCheck {
+   static_assert(REG::access & IO_WR, "register is read-only");
+   static constexpr int offset = REG::offset;
+};
+
+/**
+ * read/write a register through its descriptor
+ *  - macros (not functions) so that access accounting in chu_io_rw.h
+ *    still records the calling driver method
+ */
+#define io_read_reg(base_addr, REG) \
+   io_read((base_addr), IoRdCheck<REG>::offset)
+
+#define io_write_reg(base_addr, REG, data) \
+   io_write((base_addr), IoWrCheck<REG>::offset, (data))
+
+/**
+ * read a register and extract a field
+ */
+#define io_read_field(base_addr, FIELD) \
+   (FIELD::get(io_read_reg((base_addr), FIELD::reg)))
+
+#endif  // _CHU_IO_FIELD_H_INCLUDED
@@ -6,10 +6,10 @@
  * file contains constants to specify io and video configuration:
  *   - base address the subsystem
  *   - slot # with a symbolic constant
- *   - definitions must match the io_cfg.vhd of the hardware platform
- *   - file should be updated when io subsystem changes
- *   - if desired, include multiple configuration and
- *     use #ifdef to select desired one
+ *   - register offsets and field masks of each core
+ *   - generated by gen_io_map.py from chu_io_map.def; edit the
+ *     .def file and regenerate (chu_io_map.svh is generated from the
+ *     same description, so hardware and firmware maps always match)
  *
  *
  * @author p chu
@@ -26,21 +26,24 @@ extern "C" {
 /**********************************************************************
  * Xilinx nexys4 ddr board "sampler/daisy" configuration
  *********************************************************************/
-// #ifdef _NEXYS4
 
 // system clock rate in MHz; used for timer and uart
 #define SYS_CLK_FREQ 100
 
-//io base address for microBlaze MCS
+// io base address for microBlaze MCS
 #define BRIDGE_BASE 0xc0000000
 
+// video frame buffer
+#define FRAME_OFFSET 0x00c00000
+#define FRAME_BASE BRIDGE_BASE+FRAME_OFFSET
+
 // slot module definition
 // format: Slot#_ModuleType_Name
 #define S0_SYS_TIMER  0
 #define S1_UART1      1
 #define S2_LED        2
 #define S3_SW         3
-#define S4_USER       4
+#define S4_WDT        4
 #define S5_XDAC       5
 #define S6_PWM        6
 #define S7_BTN        7
@@ -61,11 +64,130 @@ extern "C" {
 #define V6_GRAY      6
 #define V7_BAR       7
 
-// video frame buffer
-#define FRAME_OFFSET 0x00c00000
-#define FRAME_BASE  BRIDGE_BASE+FRAME_OFFSET
+// timer core (chu_timer)
+#define TIMER_COUNTER_LOWER_REG 0   // lower 32 bits of counter
+#define TIMER_COUNTER_UPPER_REG 1   // upper 16 bits, latched when lower is read
+#define TIMER_COUNTER_UPPER_FIELD 0x0000ffff
+#define TIMER_COUNTER_UPPER_LSB 0
+#define TIMER_CTRL_REG 2   // control register
+#define TIMER_GO_FIELD 0x00000001   // enable bit
+#define TIMER_GO_LSB 0
+#define TIMER_CLR_FIELD 0x00000002   // clear bit (1-clock pulse)
+#define TIMER_CLR_LSB 1
+#define TIMER_IE_FIELD 0x00000004   // alarm interrupt enable
+#define TIMER_IE_LSB 2
+#define TIMER_STATUS_REG 2   // alarm status register
+#define TIMER_MATCH_FIELD 0x00000001   // sticky: counter reached compare value
+#define TIMER_MATCH_LSB 0
+#define TIMER_ARMED_FIELD 0x00000002   // compare armed
+#define TIMER_ARMED_LSB 1
+#define TIMER_CMP_LOWER_REG 3   // lower 32 bits of compare value; disarms
+#define TIMER_CMP_UPPER_REG 4   // upper 16 bits of compare value and arm bit
+#define TIMER_CMP_UPPER_FIELD 0x0000ffff
+#define TIMER_CMP_UPPER_LSB 0
+#define TIMER_ARM_FIELD 0x00010000   // arm compare (0: disarm); clears MATCH
+#define TIMER_ARM_LSB 16
+
+// uart core (chu_uart)
+#define UART_RD_DATA_REG 0   // rx data/status register
+#define UART_RX_DATA_FIELD 0x000000ff   // read data
+#define UART_RX_DATA_LSB 0
+#define UART_RX_EMPT_FIELD 0x00000100   // rx fifo empty
+#define UART_RX_EMPT_LSB 8
+#define UART_TX_FULL_FIELD 0x00000200   // tx fifo full
+#define UART_TX_FULL_LSB 9
+#define UART_DVSR_REG 1   // baud rate divisor register
+#define UART_DVSR_FIELD 0x000007ff   // baud tick every dvsr+1 clocks
+#define UART_DVSR_LSB 0
+#define UART_DVSR_FRAC_FIELD 0x00ff0000   // plus dvsr_frac/256 clock (average)
+#define UART_DVSR_FRAC_LSB 16
+#define UART_LEVEL_REG 1   // fifo fill levels
+#define UART_RX_USED_FIELD 0x0000ffff   // bytes in the rx fifo
+#define UART_RX_USED_LSB 0
+#define UART_TX_FREE_FIELD 0xffff0000   // free entries in the tx fifo
+#define UART_TX_FREE_LSB 16
+#define UART_WR_DATA_REG 2   // wr data register
+#define UART_TX_DATA_FIELD 0x000000ff
+#define UART_TX_DATA_LSB 0
+#define UART_RM_RD_DATA_REG 3   // remove read data (dummy write)
+
+// gpo core (chu_gpo)
+#define GPO_DATA_REG 0   // output data register
+
+// gpi core (chu_gpi)
+#define GPI_DATA_REG 0   // input data register
+
+// debounce core (chu_debounce_core)
+#define DEBOUNCE_NORMAL_DATA_REG 0   // un-treated input data register
+#define DEBOUNCE_DB_DATA_REG 1   // debounced input data register
+
+// pwm core (chu_io_pwm_core)
+#define PWM_DVSR_REG 0   // pwm divisor register
+#define PWM_DUTY_REG_BASE 16   // channel 0-15 duty cycle registers
+#define PWM_DUTY_REG_BASE_COUNT 16
+#define PWM_DUTY_FIELD 0x000007ff   // R+1 bits (R = 10)
+#define PWM_DUTY_LSB 0
+
+// sseg core (chu_led_mux_core)
+#define SSEG_DATA_LOW_REG 0   // 32-bit data for right 4 digits
+#define SSEG_DATA_HIGH_REG 1   // 32-bit data for left 4 digits
+
+// xadc core (chu_xadc_core)
+#define XADC_ADC_0_REG 0   // 16-bit data from Nexys-4 adc input #0-3
+#define XADC_ADC_0_REG_COUNT 4
+#define XADC_ADC_DATA_FIELD 0x0000fff0   // 12-bit conversion result
+#define XADC_ADC_DATA_LSB 4
+#define XADC_TMP_REG 4   // FPGA internal temperature
+#define XADC_TMP_DATA_FIELD 0x0000fff0
+#define XADC_TMP_DATA_LSB 4
+#define XADC_VCC_REG 5   // FPGA internal core voltage
+#define XADC_VCC_DATA_FIELD 0x0000fff0
+#define XADC_VCC_DATA_LSB 4
+
+// i2c core (chu_i2c_core)
+#define I2C_DVSR_REG 0   // i2c clock divisor register
+#define I2C_DVSR_FIELD 0x0000ffff
+#define I2C_DVSR_LSB 0
+#define I2C_WR_REG 1   // write data/command register
+#define I2C_DIN_FIELD 0x000000ff
+#define I2C_DIN_LSB 0
+#define I2C_CMD_FIELD 0x00000700
+#define I2C_CMD_LSB 8
+#define I2C_CMD_START 0
+#define I2C_CMD_WR 1
+#define I2C_CMD_RD 2
+#define I2C_CMD_STOP 3
+#define I2C_CMD_RESTART 4
+#define I2C_RD_REG 0   // read data/status register
+#define I2C_DOUT_FIELD 0x000000ff
+#define I2C_DOUT_LSB 0
+#define I2C_READY_FIELD 0x00000100
+#define I2C_READY_LSB 8
+#define I2C_ACK_FIELD 0x00000200   // 0: slave acked last byte
+#define I2C_ACK_LSB 9
 
-// #endif    // _NEXYS4
+// wdt core (chu_watchdog)
+#define WDT_CTRL_REG 0   // control register
+#define WDT_EN_FIELD 0x00000001   // enable; counter reloaded when set
+#define WDT_EN_LSB 0
+#define WDT_CLR_FLAG_FIELD 0x00000002   // clear the reset flag (1-clock pulse)
+#define WDT_CLR_FLAG_LSB 1
+#define WDT_STATUS_REG 0   // status register
+#define WDT_EN_ST_FIELD 0x00000001   // enabled
+#define WDT_EN_ST_LSB 0
+#define WDT_RST_FLAG_FIELD 0x00000002   // last reset caused by the watchdog
+#define WDT_RST_FLAG_LSB 1
+#define WDT_LOAD_REG 1   // timeout in clocks
+#define WDT_COUNT_REG 1   // clocks left before reset
+#define WDT_KICK_REG 2   // kick: reload counter and store tag
+#define WDT_TAG_FIELD 0x0000ffff   // tag kept across the watchdog reset
+#define WDT_TAG_LSB 0
+#define WDT_KEY_FIELD 0xffff0000   // kick ignored unless KEY matches
+#define WDT_KEY_LSB 16
+#define WDT_KEY_MAGIC 23294
+#define WDT_TAG_REG 2   // tag of the last kick
+#define WDT_LAST_TAG_FIELD 0x0000ffff
+#define WDT_LAST_TAG_LSB 0
 /*********************************************************************/
 
 #ifdef __cplusplus
@@ -10,7 +10,9 @@
 // register map
 // 0x10 to 0x1f for pwm duty cycles
 // 0x00 for frequency divisor 
+// offsets from chu_io_map.svh (generated from chu_io_map.def)
 //==================================================================
+`include "chu_io_map.svh"
 
 module chu_io_pwm_core
    #(parameter W = 6,  // width (# bits) of output port
@@ -47,8 +49,9 @@ module chu_io_pwm_core
    // wrapping circuit
    //*****************************************************************
    //  decoding 
-   assign duty_array_en = cs && write && addr[4];
-   assign dvsr_en = cs && write && addr==5'b00000;
+   assign duty_array_en = cs && write && (addr >= `PWM_DUTY_REG_BASE) &&
+                          (addr < `PWM_DUTY_REG_BASE + `PWM_DUTY_REG_BASE_COUNT);
+   assign dvsr_en = cs && write && (addr == `PWM_DVSR_REG);
    // register for divisor
    always_ff @(posedge clk, posedge reset)
       if (reset)
@@ -59,7 +62,7 @@ module chu_io_pwm_core
    // register file for duty cycles 
    always_ff @(posedge clk)
       if (duty_array_en)
-         duty_2d_reg[addr[3:0]] <= wr_data[R:0];
+         duty_2d_reg[addr - `PWM_DUTY_REG_BASE] <= wr_data[R:0];
    //*****************************************************************
    //  multi-bit PWM 
    //*****************************************************************
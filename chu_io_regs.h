@@ -0,0 +1,135 @@
+/*****************************************************************//**
+ * @file chu_io_regs.h
+ *
+ * @brief typed register/field descriptors of the io cores
+ *
+ * Detailed description:
+ *  - generated by gen_io_map.py from chu_io_map.def; do not edit
+ *  - one namespace per core (e.g., uart_regs); see chu_io_field.h
+ *  - usage:
+ *      empty = io_read_field(base_addr, uart_regs::RX_EMPT);
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _CHU_IO_REGS_H_INCLUDED
+#define _CHU_IO_REGS_H_INCLUDED
+
+#include "chu_io_field.h"
+
+/* timer core (chu_timer) */
+namespace timer_regs {
+typedef IoReg<0, IO_RD> COUNTER_LOWER_REG;   // lower 32 bits of counter
+typedef IoReg<1, IO_RD> COUNTER_UPPER_REG;   // upper 16 bits, latched when lower is read
+typedef IoField<COUNTER_UPPER_REG, 0, 16> COUNTER_UPPER;
+typedef IoReg<2, IO_WR> CTRL_REG;   // control register
+typedef IoField<CTRL_REG, 0, 1> GO;   // enable bit
+typedef IoField<CTRL_REG, 1, 1> CLR;   // clear bit (1-clock pulse)
+typedef IoField<CTRL_REG, 2, 1> IE;   // alarm interrupt enable
+typedef IoReg<2, IO_RD> STATUS_REG;   // alarm status register
+typedef IoField<STATUS_REG, 0, 1> MATCH;   // sticky: counter reached compare value
+typedef IoField<STATUS_REG, 1, 1> ARMED;   // compare armed
+typedef IoReg<3, IO_WR> CMP_LOWER_REG;   // lower 32 bits of compare value; disarms
+typedef IoReg<4, IO_WR> CMP_UPPER_REG;   // upper 16 bits of compare value and arm bit
+typedef IoField<CMP_UPPER_REG, 0, 16> CMP_UPPER;
+typedef IoField<CMP_UPPER_REG, 16, 1> ARM;   // arm compare (0: disarm); clears MATCH
+}
+
+/* uart core (chu_uart) */
+namespace uart_regs {
+typedef IoReg<0, IO_RD> RD_DATA_REG;   // rx data/status register
+typedef IoField<RD_DATA_REG, 0, 8> RX_DATA;   // read data
+typedef IoField<RD_DATA_REG, 8, 1> RX_EMPT;   // rx fifo empty
+typedef IoField<RD_DATA_REG, 9, 1> TX_FULL;   // tx fifo full
+typedef IoReg<1, IO_WR> DVSR_REG;   // baud rate divisor register
+typedef IoField<DVSR_REG, 0, 11> DVSR;   // baud tick every dvsr+1 clocks
+typedef IoField<DVSR_REG, 16, 8> DVSR_FRAC;   // plus dvsr_frac/256 clock (average)
+typedef IoReg<1, IO_RD> LEVEL_REG;   // fifo fill levels
+typedef IoField<LEVEL_REG, 0, 16> RX_USED;   // bytes in the rx fifo
+typedef IoField<LEVEL_REG, 16, 16> TX_FREE;   // free entries in the tx fifo
+typedef IoReg<2, IO_WR> WR_DATA_REG;   // wr data register
+typedef IoField<WR_DATA_REG, 0, 8> TX_DATA;
+typedef IoReg<3, IO_WR> RM_RD_DATA_REG;   // remove read data (dummy write)
+}
+
+/* gpo core (chu_gpo) */
+namespace gpo_regs {
+typedef IoReg<0, IO_WR> DATA_REG;   // output data register
+}
+
+/* gpi core (chu_gpi) */
+namespace gpi_regs {
+typedef IoReg<0, IO_RD> DATA_REG;   // input data register
+}
+
+/* debounce core (chu_debounce_core) */
+namespace debounce_regs {
+typedef IoReg<0, IO_RD> NORMAL_DATA_REG;   // un-treated input data register
+typedef IoReg<1, IO_RD> DB_DATA_REG;   // debounced input data register
+}
+
+/* pwm core (chu_io_pwm_core) */
+namespace pwm_regs {
+typedef IoReg<0, IO_WR> DVSR_REG;   // pwm divisor register
+typedef IoReg<16, IO_WR, 16> DUTY_REG_BASE;   // channel 0-15 duty cycle registers
+typedef IoField<DUTY_REG_BASE, 0, 11> DUTY;   // R+1 bits (R = 10)
+}
+
+/* sseg core (chu_led_mux_core) */
+namespace sseg_regs {
+typedef IoReg<0, IO_WR> DATA_LOW_REG;   // 32-bit data for right 4 digits
+typedef IoReg<1, IO_WR> DATA_HIGH_REG;   // 32-bit data for left 4 digits
+}
+
+/* xadc core (chu_xadc_core) */
+namespace xadc_regs {
+typedef IoReg<0, IO_RD, 4> ADC_0_REG;   // 16-bit data from Nexys-4 adc input #0-3
+typedef IoField<ADC_0_REG, 4, 12> ADC_DATA;   // 12-bit conversion result
+typedef IoReg<4, IO_RD> TMP_REG;   // FPGA internal temperature
+typedef IoField<TMP_REG, 4, 12> TMP_DATA;
+typedef IoReg<5, IO_RD> VCC_REG;   // FPGA internal core voltage
+typedef IoField<VCC_REG, 4, 12> VCC_DATA;
+}
+
+/* i2c core (chu_i2c_core) */
+namespace i2c_regs {
+typedef IoReg<0, IO_WR> DVSR_REG;   // i2c clock divisor register
+typedef IoField<DVSR_REG, 0, 16> DVSR;
+typedef IoReg<1, IO_WR> WR_REG;   // write data/command register
+typedef IoField<WR_REG, 0, 8> DIN;
+typedef IoField<WR_REG, 8, 3> CMD;
+enum {
+   CMD_START = 0,
+   CMD_WR = 1,
+   CMD_RD = 2,
+   CMD_STOP = 3,
+   CMD_RESTART = 4
+};
+typedef IoReg<0, IO_RD> RD_REG;   // read data/status register
+typedef IoField<RD_REG, 0, 8> DOUT;
+typedef IoField<RD_REG, 8, 1> READY;
+typedef IoField<RD_REG, 9, 1> ACK;   // 0: slave acked last byte
+}
+
+/* wdt core (chu_watchdog) */
+namespace wdt_regs {
+typedef IoReg<0, IO_WR> CTRL_REG;   // control register
+typedef IoField<CTRL_REG, 0, 1> EN;   // enable; counter reloaded when set
+typedef IoField<CTRL_REG, 1, 1> CLR_FLAG;   // clear the reset flag (1-clock pulse)
+typedef IoReg<0, IO_RD> STATUS_REG;   // status register
+typedef IoField<STATUS_REG, 0, 1> EN_ST;   // enabled
+typedef IoField<STATUS_REG, 1, 1> RST_FLAG;   // last reset caused by the watchdog
+typedef IoReg<1, IO_WR> LOAD_REG;   // timeout in clocks
+typedef IoReg<1, IO_RD> COUNT_REG;   // clocks left before reset
+typedef IoReg<2, IO_WR> KICK_REG;   // kick: reload counter and store tag
+typedef IoField<KICK_REG, 0, 16> TAG;   // tag kept across the watchdog reset
+typedef IoField<KICK_REG, 16, 16> KEY;   // kick ignored unless KEY matches
+enum {
+   KEY_MAGIC = 23294
+};
+typedef IoReg<2, IO_RD> TAG_REG;   // tag of the last kick
+typedef IoField<TAG_REG, 0, 16> LAST_TAG;
+}
+
+#endif  // _CHU_IO_REGS_H_INCLUDED
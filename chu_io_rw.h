@@ -15,6 +15,14 @@
 extern "C" {
 #endif
 
+/**
+ * write descriptor of a burst (see io_wr_burst())
+ */
+typedef struct {
+   uint32_t addr;   // byte address of the register
+   uint32_t data;   // 32-bit data
+} IoWrDesc;
+
 /**********************************************************************
  * generic low-level read and write access
  *  - offset: 32-bit word offset relative to base
@@ -22,7 +30,48 @@ extern "C" {
  *  - must bypass data cache for I/O access
  *  - may be replaced with vendor provided macros
  *   (if _VENDOR_IO_ACCESS_USED is defined)
+ *  - _SIM_IO_ACCESS_USED routes all accesses to the host-side
+ *    simulated FPro bus (see chu_io_sim.h)
+ *  - io_rd_raw()/io_wr_raw() perform the access; io_read()/io_write()
+ *    add the optional trace and accounting below
  *********************************************************************/
+#ifdef _SIM_IO_ACCESS_USED
+#define _VENDOR_IO_ACCESS_USED
+
+/**
+ * read a register of the simulated bus.
+ * @param addr byte address of the register
+ * @return 32-bit data of the register
+ * @note implemented in chu_io_sim.cpp
+ */
+uint32_t sim_io_read(uint32_t addr);
+
+/**
+ * write a register of the simulated bus.
+ * @param addr byte address of the register
+ * @param data 32-bit data
+ * @note implemented in chu_io_sim.cpp
+ */
+void sim_io_write(uint32_t addr, uint32_t data);
+
+/**
+ * write a list of registers of the simulated bus in one call.
+ * @param desc write descriptors, issued in order
+ * @param n # descriptors
+ * @note implemented in chu_io_sim.cpp
+ */
+void sim_io_write_burst(const IoWrDesc *desc, int n);
+
+#define io_rd_raw(base_addr, offset) \
+   sim_io_read((uint32_t)((base_addr) + 4*(offset)))
+
+#define io_wr_raw(base_addr, offset, data) \
+   sim_io_write((uint32_t)((base_addr) + 4*(offset)), (uint32_t)(data))
+
+#define io_wr_burst_raw(desc, n) sim_io_write_burst((desc), (n))
+
+#endif  // _SIM_IO_ACCESS_USED
+
 #ifndef _VENDOR_IO_ACCESS_USED
 
 /**
@@ -32,7 +81,7 @@ extern "C" {
  * @return 32-bit data of the register
  * @note macro calculates the byte address of the register and then read
  */
-#define io_read(base_addr, offset) \
+#define io_rd_raw(base_addr, offset) \
    (*(volatile uint32_t *)((base_addr) + 4*(offset)))
 
 /**
@@ -41,10 +90,138 @@ extern "C" {
  * @param offset register word offset
  * @param data 32-bit data
  */
-#define io_write(base_addr, offset, data) \
+#define io_wr_raw(base_addr, offset, data) \
    (*(volatile uint32_t *)((base_addr) + 4*(offset)) = (data))
 
+/**
+ * write a list of registers back to back
+ * @param desc write descriptors, issued in order
+ * @param n # descriptors
+ */
+#define io_wr_burst_raw(desc, n) \
+   do { \
+      const IoWrDesc *d_ = (desc); \
+      for (int i_ = 0; i_ < (n); i_++) \
+         *(volatile uint32_t *)(d_[i_].addr) = d_[i_].data; \
+   } while (0)
+
 #endif  // _VENDOR_IO_ACCESS_USED
+
+/**********************************************************************
+ * io access trace
+ *  - enabled when _IO_TRACE_USED is defined
+ *  - each access is appended to a RAM ring buffer after it is
+ *    performed (read data is known then)
+ *  - control and stream-out functions are in chu_io_trace.h
+ *  - not applied to vendor provided io_read()/io_write()
+ *********************************************************************/
+#ifdef io_rd_raw
+#ifdef _IO_TRACE_USED
+
+/**
+ * record an io read.
+ * @param addr byte address of the register
+ * @param data data read
+ * @return data
+ * @note implemented in chu_io_trace.cpp
+ */
+uint32_t io_trace_rd(uint32_t addr, uint32_t data);
+
+/**
+ * record an io write.
+ * @param addr byte address of the register
+ * @param data data to be written
+ * @return data
+ * @note implemented in chu_io_trace.cpp
+ */
+uint32_t io_trace_wr(uint32_t addr, uint32_t data);
+
+#define io_rd_trc(base_addr, offset) \
+   io_trace_rd((uint32_t)((base_addr) + 4*(offset)), io_rd_raw(base_addr, offset))
+
+#define io_wr_trc(base_addr, offset, data) \
+   io_wr_raw(base_addr, offset, \
+             io_trace_wr((uint32_t)((base_addr) + 4*(offset)), (uint32_t)(data)))
+
+#define io_wr_burst_trc(desc, n) \
+   do { \
+      const IoWrDesc *t_ = (desc); \
+      io_wr_burst_raw(t_, (n)); \
+      for (int j_ = 0; j_ < (n); j_++) \
+         io_trace_wr(t_[j_].addr, t_[j_].data); \
+   } while (0)
+
+#else
+
+#define io_rd_trc(base_addr, offset) io_rd_raw(base_addr, offset)
+#define io_wr_trc(base_addr, offset, data) io_wr_raw(base_addr, offset, data)
+#define io_wr_burst_trc(desc, n) io_wr_burst_raw(desc, n)
+
+#endif  // _IO_TRACE_USED
+#endif  // io_rd_raw
+
+/**********************************************************************
+ * io access accounting
+ *  - enabled when _IO_STATS_USED is defined
+ *  - each access is counted per slot and per calling function
+ *    (site) before it is performed
+ *  - report and budget functions are in chu_io_stat.h
+ *  - not applied to vendor provided io_read()/io_write()
+ *********************************************************************/
+#ifdef io_rd_raw
+#ifdef _IO_STATS_USED
+
+/**
+ * count an io access.
+ * @param addr byte address of the register
+ * @param wr 0 for read; 1 for write
+ * @param site name of the calling function
+ * @note implemented in chu_io_stat.cpp
+ */
+void io_stat_count(uint32_t addr, int wr, const char *site);
+
+#ifdef __GNUC__
+#define IO_STAT_SITE __PRETTY_FUNCTION__
+#else
+#define IO_STAT_SITE __func__
+#endif
+
+#define io_read(base_addr, offset) \
+   (io_stat_count((uint32_t)((base_addr) + 4*(offset)), 0, IO_STAT_SITE), \
+    io_rd_trc(base_addr, offset))
+
+#define io_write(base_addr, offset, data) \
+   (io_stat_count((uint32_t)((base_addr) + 4*(offset)), 1, IO_STAT_SITE), \
+    io_wr_trc(base_addr, offset, data))
+
+#else
+
+#define io_read(base_addr, offset) io_rd_trc(base_addr, offset)
+#define io_write(base_addr, offset, data) io_wr_trc(base_addr, offset, data)
+
+#endif  // _IO_STATS_USED
+#endif  // io_rd_raw
+
+/**********************************************************************
+ * burst write
+ *  - io_wr_burst() issues a list of writes in one call; the simulated
+ *    bus passes the whole list to its backend
+ *  - traced per entry but not counted here; IoBatch (chu_io_batch.h)
+ *    counts each entry when it is queued, so the site is the driver
+ *    method that produced it
+ *  - falls back to one io_write() per entry with vendor provided
+ *    io_read()/io_write()
+ *********************************************************************/
+#ifdef io_rd_raw
+#define io_wr_burst(desc, n) io_wr_burst_trc(desc, n)
+#else
+#define io_wr_burst(desc, n) \
+   do { \
+      const IoWrDesc *d_ = (desc); \
+      for (int i_ = 0; i_ < (n); i_++) \
+         io_write(d_[i_].addr, 0, d_[i_].data); \
+   } while (0)
+#endif
 /**
  * calculate base address of a memory mapped io slot.
  * @param base base-address of FPro system.
@@ -0,0 +1,86 @@
+/*****************************************************************//**
+ * @file chu_io_shadow.h
+ *
+ * @brief Shadow registers for write-only MMIO cores
+ *
+ * Detailed description:
+ *  - chu_gpo, chu_io_pwm_core and chu_led_mux_core return 0 on read,
+ *    so a driver cannot tell whether a write changes the core state
+ *  - IoShadow keeps the last value written to each register and
+ *    drops a write that would store the same value again
+ *  - a register is unknown until first written (e.g., after reset or
+ *    invalidate()); that write always goes to the core
+ *  - only for registers without write side effects
+ *  - the driver still issues io_write(), so access accounting
+ *    (chu_io_stat.h) attributes the write to the driver method
+ *  - usage (inside a driver):
+ *      IoShadow<2> regs;      // registers 0 and 1
+ *      if (regs.update(DATA_REG, data))
+ *         io_write(base_addr, DATA_REG, data);
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _CHU_IO_SHADOW_H_INCLUDED
+#define _CHU_IO_SHADOW_H_INCLUDED
+
+#include "chu_init.h"
+
+/**
+ * shadow copy of registers 0 to N-1 of a core (N <= 32)
+ */
+template <int N>
+class IoShadow {
+   static_assert(N >= 1 && N <= 32, "valid bits are one 32-bit word");
+public:
+   // constant initialization: safe as a static member of a template
+   // driver (slot_cores.h), whose constructor may run first
+   constexpr IoShadow() : reg_buf(), valid(0), n_wr(0), n_sup(0) {
+   }
+
+   /**
+    * record a register write
+    * @param reg register # (0 to N-1)
+    * @param data 32-bit data
+    * @return 1 if the write must go to the core; 0 if reg already holds data
+    * @note reg outside 0 to N-1 is not tracked (always 1)
+    */
+   int update(int reg, uint32_t data) {
+      if (reg < 0 || reg >= N)
+         return (1);
+      if (bit_read(valid, reg) && reg_buf[reg] == data) {
+         n_sup++;
+         return (0);
+      }
+      reg_buf[reg] = data;
+      bit_set(valid, reg);
+      n_wr++;
+      return (1);
+   }
+
+   /**
+    * mark all registers unknown; next write of each goes to the core
+    */
+   void invalidate() {
+      valid = 0;
+   }
+
+   /** # writes passed to the core */
+   unsigned long writes() {
+      return (n_wr);
+   }
+
+   /** # writes dropped because the register already held the value */
+   unsigned long suppressed() {
+      return (n_sup);
+   }
+
+private:
+   uint32_t reg_buf[N];   // last written values
+   uint32_t valid;        // bit i: reg_buf[i] matches the core
+   unsigned long n_wr;
+   unsigned long n_sup;
+};
+
+#endif  // _CHU_IO_SHADOW_H_INCLUDED
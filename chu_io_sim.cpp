@@ -0,0 +1,638 @@
+/*****************************************************************//**
+ * @file chu_io_sim.cpp
+ *
+ * @brief implementation of the host-side simulated FPro bus
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _SIM_IO_ACCESS_USED
+#define _SIM_IO_ACCESS_USED
+#endif
+
+#include <stdio.h>
+#include "chu_io_rw.h"
+#include "chu_io_sim.h"
+
+/**********************************************************************
+ * backend selection
+ **********************************************************************/
+static SimBusBackend *cur_backend = 0;
+
+SimBus &sim_bus() {
+   // constructed on first use; drivers are global objects whose
+   // constructors access the bus during static initialization
+   static SimBus bus;
+   return (bus);
+}
+
+void sim_io_set_backend(SimBusBackend *backend) {
+   cur_backend = backend;
+}
+
+__attribute__((weak)) SimBusBackend *sim_default_backend() {
+   return (&sim_bus());
+}
+
+SimBusBackend *sim_io_get_backend() {
+   if (cur_backend == 0)
+      return (sim_default_backend());
+   return (cur_backend);
+}
+
+uint32_t sim_io_read(uint32_t addr) {
+   return (sim_io_get_backend()->read(addr));
+}
+
+void sim_io_write(uint32_t addr, uint32_t data) {
+   sim_io_get_backend()->write(addr, data);
+}
+
+void sim_io_write_burst(const IoWrDesc *desc, int n) {
+   sim_io_get_backend()->write_burst(desc, n);
+}
+
+/**********************************************************************
+ * SimTimer
+ **********************************************************************/
+SimTimer::SimTimer(SimBus *bus_p) : SimSlot(bus_p) {
+   // bus clock not yet initialized; SimBus::SimBus() calls reset()
+   count_reg = 0;
+   upper_reg = 0;
+   cmp_reg = 0;
+   last_cycle = 0;
+   go = 0;
+   ie = 0;
+   armed = 0;
+   match = 0;
+}
+
+void SimTimer::reset() {
+   count_reg = 0;
+   upper_reg = 0;
+   cmp_reg = 0;
+   last_cycle = bus->cycle();
+   go = 0;
+   ie = 0;
+   armed = 0;
+   match = 0;
+}
+
+void SimTimer::update() {
+   uint64_t now = bus->cycle();
+
+   if (go)
+      count_reg = (count_reg + (now - last_cycle)) & 0x0000ffffffffffffULL;
+   last_cycle = now;
+   if (armed && count_reg >= cmp_reg)
+      match = 1;
+}
+
+uint64_t SimTimer::count() {
+   update();
+   return (count_reg);
+}
+
+int SimTimer::irq() {
+   update();
+   return (match && ie);
+}
+
+// reg 0: lower 32 bits, latches upper 16 bits; reg 1: latched upper
+// 16 bits; reg 2: status (bit 0 match, bit 1 armed); addr[1:0] decoded
+uint32_t SimTimer::read(int reg) {
+   update();
+   switch (reg & 0x03) {
+   case 1:
+      return (upper_reg);
+   case 2:
+      return ((uint32_t) (armed << 1 | match));
+   default:
+      upper_reg = (uint32_t) (count_reg >> 32) & 0x0000ffff;
+      return ((uint32_t) count_reg);
+   }
+}
+
+// reg 2: bit 0 go, bit 1 clear pulse, bit 2 irq enable;
+// reg 3: compare lower (disarms); reg 4: compare upper, bit 16 arm
+void SimTimer::write(int reg, uint32_t data) {
+   update();
+   switch (reg & 0x07) {
+   case 2:
+      if (data & 0x02)
+         count_reg = 0;
+      go = data & 0x01;
+      ie = (data >> 2) & 0x01;
+      break;
+   case 3:
+      cmp_reg = (cmp_reg & 0xffff00000000ULL) | data;
+      armed = 0;
+      match = 0;
+      break;
+   case 4:
+      cmp_reg = (cmp_reg & 0xffffffffULL) | (uint64_t) (data & 0xffff) << 32;
+      armed = (data >> 16) & 0x01;
+      match = 0;
+      // a compare value already reached matches at once
+      update();
+      break;
+   }
+}
+
+/**********************************************************************
+ * SimUart
+ **********************************************************************/
+SimUart::SimUart(SimBus *bus_p) : SimSlot(bus_p) {
+   echo = 1;
+   reset();
+}
+
+void SimUart::reset() {
+   dvsr_reg = 0;
+   frac_reg = 0;
+   tx_fifo.clear();
+   rx_fifo.clear();
+   tx_done_cycle = 0;
+   log.clear();
+}
+
+// 1 start bit, 8 data bits, 1 stop bit; 16 baud ticks per bit;
+// baud_gen runs 256 periods in 256*(dvsr+1)+frac clocks and ticks once
+// in each period that reaches count 1: all of them when dvsr > 0, only
+// the frac stretched ones when dvsr = 0 (no tick when frac is also 0)
+uint64_t SimUart::frame_cycles() {
+   uint64_t clocks = (uint64_t) 256 * (dvsr_reg + 1) + frac_reg;
+   uint64_t ticks = (dvsr_reg == 0) ? frac_reg : 256;
+
+   if (ticks == 0)
+      return (0);
+   return (10 * 16 * clocks / ticks);
+}
+
+void SimUart::update() {
+   uint64_t now = bus->cycle();
+   uint64_t fc = frame_cycles();
+
+   if (fc == 0)
+      return;
+   while (!tx_fifo.empty() && tx_done_cycle <= now) {
+      uint8_t byte = tx_fifo.front();
+      tx_fifo.pop_front();
+      log.push_back((char) byte);
+      if (echo) {
+         putchar(byte);
+         fflush(stdout);
+      }
+      tx_done_cycle = tx_done_cycle + fc;
+   }
+}
+
+void SimUart::drain() {
+   while (!tx_fifo.empty()) {
+      log.push_back((char) tx_fifo.front());
+      if (echo)
+         putchar(tx_fifo.front());
+      tx_fifo.pop_front();
+   }
+   fflush(stdout);
+}
+
+std::string &SimUart::tx_log() {
+   update();
+   return (log);
+}
+
+void SimUart::rx_push(uint8_t byte) {
+   if (rx_fifo.size() < FIFO_DEPTH)
+      rx_fifo.push_back(byte);
+}
+
+// reg 0: {22'b0, tx_full, rx_empty, rx_data}; reg 1: {tx_free, rx_used}
+uint32_t SimUart::read(int reg) {
+   uint32_t data;
+
+   update();
+   if ((reg & 0x03) == 1)
+      return ((uint32_t) (FIFO_DEPTH - tx_fifo.size()) << 16 | (uint32_t) rx_fifo.size());
+   data = 0;
+   if (tx_fifo.size() >= FIFO_DEPTH)
+      data = data | 0x200;
+   if (rx_fifo.empty())
+      data = data | 0x100;
+   else
+      data = data | rx_fifo.front();
+   return (data);
+}
+
+// reg 1: dvsr; reg 2: tx data; reg 3: remove rx head
+void SimUart::write(int reg, uint32_t data) {
+   update();
+   switch (reg & 0x03) {
+   case 1:
+      dvsr_reg = (data & UART_DVSR_FIELD) >> UART_DVSR_LSB;
+      frac_reg = (data & UART_DVSR_FRAC_FIELD) >> UART_DVSR_FRAC_LSB;
+      break;
+   case 2:
+      if (tx_fifo.size() < FIFO_DEPTH) {
+         if (tx_fifo.empty())
+            tx_done_cycle = bus->cycle() + frame_cycles();
+         tx_fifo.push_back((uint8_t) data);
+      }
+      break;
+   case 3:
+      if (!rx_fifo.empty())
+         rx_fifo.pop_front();
+      break;
+   default:
+      break;
+   }
+}
+
+/**********************************************************************
+ * SimXadc
+ **********************************************************************/
+SimXadc::SimXadc(SimBus *bus_p) : SimSlot(bus_p) {
+   reset();
+}
+
+void SimXadc::reset() {
+   for (int i = 0; i < 6; i++)
+      data_reg[i] = 0;
+}
+
+// addr[2:0]: 0-3 adc, 4 temp, 5-7 vcc
+uint32_t SimXadc::read(int reg) {
+   int ch = reg & 0x07;
+
+   if (ch > 5)
+      ch = 5;
+   return ((uint32_t) data_reg[ch]);
+}
+
+void SimXadc::set_raw(int ch, uint16_t raw) {
+   if (ch >= 0 && ch < 6)
+      data_reg[ch] = raw;
+}
+
+// temp = adc*503.975/4096 - 273.15 (12-bit result in 16-bit MSBs)
+void SimXadc::set_temp(double c) {
+   int code = (int) ((c + 273.15) * 4096.0 / 503.975 + 0.5);
+
+   if (code < 0)
+      code = 0;
+   if (code > 4095)
+      code = 4095;
+   data_reg[4] = (uint16_t) (code << 4);
+}
+
+// vcc = 3*adc/4096
+void SimXadc::set_vcc(double v) {
+   int code = (int) (v / 3.0 * 4096.0 + 0.5);
+
+   if (code > 4095)
+      code = 4095;
+   data_reg[5] = (uint16_t) (code << 4);
+}
+
+/**********************************************************************
+ * SimPwm
+ **********************************************************************/
+SimPwm::SimPwm(SimBus *bus_p) : SimSlot(bus_p) {
+   reset();
+}
+
+void SimPwm::reset() {
+   dvsr_reg = 0;
+   for (int i = 0; i < W; i++)
+      duty_reg[i] = 0;
+   n_wr = 0;
+}
+
+// 0x00: divisor; 0x10-0x1f: duty cycles (R+1 bits)
+void SimPwm::write(int reg, uint32_t data) {
+   n_wr++;
+   if (reg & 0x10) {
+      if ((reg & 0x0f) < W)
+         duty_reg[reg & 0x0f] = data & ((1 << (R + 1)) - 1);
+   } else if (reg == 0) {
+      dvsr_reg = data;
+   }
+}
+
+/**********************************************************************
+ * SimSseg
+ **********************************************************************/
+void SimSseg::reset() {
+   d_reg[0] = 0;
+   d_reg[1] = 0;
+   n_wr = 0;
+}
+
+// addr[0]: 0 for right 4 digits, 1 for left 4 digits
+void SimSseg::write(int reg, uint32_t data) {
+   n_wr++;
+   d_reg[reg & 0x01] = data;
+}
+
+uint8_t SimSseg::ptn(int pos) {
+   return ((uint8_t) (d_reg[(pos >> 2) & 0x01] >> (8 * (pos & 0x03))));
+}
+
+/**********************************************************************
+ * SimAdt7420
+ **********************************************************************/
+void SimAdt7420::reset() {
+   for (int i = 0; i < (int) sizeof(regs); i++)
+      regs[i] = 0;
+   regs[0x0b] = 0xcb;   // manufacturer id
+   ptr = 0;
+   first_wr = 0;
+   set_temp(25.0);
+}
+
+// 13-bit two's complement, 0.0625 C per lsb, left justified by 3 bits
+void SimAdt7420::set_temp(double c) {
+   int code;
+   uint16_t raw;
+
+   code = (int) (c * 16.0 + ((c < 0.0) ? -0.5 : 0.5));
+   raw = (uint16_t) ((code & 0x1fff) << 3);
+   regs[0x00] = (uint8_t) (raw >> 8);
+   regs[0x01] = (uint8_t) raw;
+}
+
+void SimAdt7420::write(uint8_t data) {
+   if (first_wr) {
+      ptr = data % sizeof(regs);
+      first_wr = 0;
+   } else {
+      regs[ptr] = data;
+      ptr = (ptr + 1) % sizeof(regs);
+   }
+}
+
+uint8_t SimAdt7420::read() {
+   uint8_t data = regs[ptr];
+
+   ptr = (ptr + 1) % sizeof(regs);
+   return (data);
+}
+
+/**********************************************************************
+ * SimI2c
+ **********************************************************************/
+SimI2c::SimI2c(SimBus *bus_p) : SimSlot(bus_p) {
+   reset();
+}
+
+void SimI2c::reset() {
+   state = IDLE;
+   dvsr_reg = 0;
+   busy_until = 0;
+   addr_phase = 0;
+   dev_sel = 0;
+   rd_mode = 0;
+   dout = 0;
+   ack = 0;
+   sensor.reset();
+}
+
+int SimI2c::ready() {
+   return (bus->cycle() >= busy_until);
+}
+
+// {22'b0, ack, ready, dout}
+uint32_t SimI2c::read(int /* reg */) {
+   return (((uint32_t) ack << 9) | ((uint32_t) ready() << 8) | dout);
+}
+
+// reg 0 (addr[0]=0): divisor; reg 1: {cmd, din}
+// timing (in clocks, q = dvsr) follows the i2c_master fsm:
+//   start 3q+2; restart 5q+3; stop 4q+2; byte 37(q+1)
+void SimI2c::write(int reg, uint32_t data) {
+   uint64_t q = dvsr_reg;
+   int cmd = (data >> 8) & 0x07;
+   uint8_t din = (uint8_t) data;
+
+   if ((reg & 0x01) == 0) {
+      dvsr_reg = data & 0xffff;
+      return;
+   }
+   if (!ready())
+      return;       // fsm not in idle/hold; command dropped
+   if (state == IDLE) {
+      if (cmd != 0)
+         return;    // only start accepted in idle
+      state = HOLD;
+      addr_phase = 1;
+      busy_until = bus->cycle() + 3 * q + 2;
+      return;
+   }
+   switch (cmd) {
+   case 0:   // start in hold behaves as restart
+   case 4:
+      addr_phase = 1;
+      busy_until = bus->cycle() + 5 * q + 3;
+      break;
+   case 3:   // stop
+      state = IDLE;
+      dev_sel = 0;
+      busy_until = bus->cycle() + 4 * q + 2;
+      break;
+   case 1:   // write byte; dout echoes the bits on sda
+      if (addr_phase) {
+         addr_phase = 0;
+         dev_sel = ((din >> 1) == SimAdt7420::DEV_ADDR);
+         rd_mode = din & 0x01;
+         if (dev_sel && !rd_mode)
+            sensor.start_write();
+      } else if (dev_sel && !rd_mode) {
+         sensor.write(din);
+      }
+      dout = din;
+      ack = dev_sel ? 0 : 1;   // sda pulled up when nobody acks
+      busy_until = bus->cycle() + 37 * (q + 1);
+      break;
+   case 2:   // read byte; 9th bit is the master's own ack/nack
+      if (dev_sel && rd_mode)
+         dout = sensor.read();
+      else
+         dout = 0xff;
+      ack = din & 0x01;
+      busy_until = bus->cycle() + 37 * (q + 1);
+      break;
+   default:
+      break;
+   }
+}
+
+/**********************************************************************
+ * SimWdt
+ **********************************************************************/
+SimWdt::SimWdt(SimBus *bus_p) : SimSlot(bus_p) {
+   // bus clock not yet initialized; SimBus::SimBus() calls reset()
+   load_reg = 0xffffffff;
+   count_reg = 0xffffffff;
+   tag_reg = 0;
+   last_cycle = 0;
+   rst_cycle = 0;
+   n_rst = 0;
+   en = 0;
+   flag = 0;
+}
+
+// board reset (por)
+void SimWdt::reset() {
+   load_reg = 0xffffffff;
+   count_reg = 0xffffffff;
+   tag_reg = 0;
+   last_cycle = bus->cycle();
+   rst_cycle = 0;
+   n_rst = 0;
+   en = 0;
+   flag = 0;
+}
+
+void SimWdt::update() {
+   uint64_t now = bus->cycle();
+
+   if (en) {
+      if (now - last_cycle >= count_reg) {
+         rst_cycle = last_cycle + count_reg;
+         count_reg = 0;
+         en = 0;
+         flag = 1;
+         n_rst++;
+      } else {
+         count_reg = count_reg - (uint32_t) (now - last_cycle);
+      }
+   }
+   last_cycle = now;
+}
+
+unsigned long SimWdt::resets() {
+   update();
+   return (n_rst);
+}
+
+// reg 0: status (bit 0 en, bit 1 flag); reg 1: count; reg 2: tag
+uint32_t SimWdt::read(int reg) {
+   update();
+   switch (reg & 0x03) {
+   case 0:
+      return ((uint32_t) (flag << 1 | en));
+   case 1:
+      return (count_reg);
+   case 2:
+      return (tag_reg);
+   default:
+      return (0);
+   }
+}
+
+// reg 0: bit 0 en, bit 1 clear flag; reg 1: timeout; reg 2: key/tag kick
+void SimWdt::write(int reg, uint32_t data) {
+   update();
+   switch (reg & 0x03) {
+   case 0:
+      if ((data & 0x01) && !en)
+         count_reg = load_reg;
+      en = data & 0x01;
+      if (data & 0x02)
+         flag = 0;
+      break;
+   case 1:
+      load_reg = data;
+      break;
+   case 2:
+      if (en && (data >> 16) == WDT_KEY_MAGIC) {
+         count_reg = load_reg;
+         tag_reg = data & 0xffff;
+      }
+      break;
+   }
+}
+
+/**********************************************************************
+ * SimBus
+ **********************************************************************/
+SimBus::SimBus()
+      : timer(this), uart(this), led(this), sw(this), wdt(this), adc(this),
+        pwm(this), sseg(this), i2c(this), unused(this) {
+   clk = 0;
+   access_cycles = DEF_ACCESS_CYCLES;
+   n_rd = 0;
+   n_wr = 0;
+   n_burst = 0;
+   for (int i = 0; i < N_SLOT; i++)
+      slots[i] = &unused;
+   slots[S0_SYS_TIMER] = &timer;
+   slots[S1_UART1] = &uart;
+   slots[S2_LED] = &led;
+   slots[S3_SW] = &sw;
+   slots[S4_WDT] = &wdt;
+   slots[S5_XDAC] = &adc;
+   slots[S6_PWM] = &pwm;
+   slots[S8_SSEG] = &sseg;
+   slots[S10_I2C] = &i2c;
+   reset();
+}
+
+// bytes still queued at exit would be sent by the hardware
+SimBus::~SimBus() {
+   uart.drain();
+}
+
+void SimBus::reset() {
+   clk = 0;
+   n_rd = 0;
+   n_wr = 0;
+   n_burst = 0;
+   for (int i = 0; i < N_SLOT; i++)
+      slots[i]->reset();
+}
+
+// chu_mcs_bridge: word address = addr[31:2]; mmio when addr[23] = 0
+// chu_mmio_controller: slot = word_addr[10:5]; reg = word_addr[4:0]
+SimSlot *SimBus::decode(uint32_t addr, int *reg) {
+   uint32_t word_addr;
+
+   if ((addr >> 24) != ((uint32_t) BRIDGE_BASE >> 24) || (addr & 0x00800000))
+      return (&unused);
+   word_addr = (addr >> 2) & 0x001fffff;
+   *reg = word_addr & 0x1f;
+   return (slots[(word_addr >> 5) & 0x3f]);
+}
+
+uint32_t SimBus::read(uint32_t addr) {
+   int reg = 0;
+   SimSlot *slot = decode(addr, &reg);
+
+   clk += access_cycles;
+   n_rd++;
+   return (slot->read(reg));
+}
+
+void SimBus::write(uint32_t addr, uint32_t data) {
+   int reg = 0;
+   SimSlot *slot = decode(addr, &reg);
+
+   clk += access_cycles;
+   n_wr++;
+   slot->write(reg, data);
+}
+
+// same clocks as n single writes; decoded and dispatched in one call
+void SimBus::write_burst(const IoWrDesc *desc, int n) {
+   int i, reg = 0;
+   SimSlot *slot;
+
+   for (i = 0; i < n; i++) {
+      slot = decode(desc[i].addr, &reg);
+      clk += access_cycles;
+      slot->write(reg, desc[i].data);
+   }
+   n_wr += n;
+   n_burst++;
+}
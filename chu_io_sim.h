@@ -0,0 +1,382 @@
+/*****************************************************************//**
+ * @file chu_io_sim.h
+ *
+ * @brief Host-side simulated FPro bus for running drivers on Linux
+ *
+ * Detailed description:
+ *  - selected by compiling all driver code with -D_SIM_IO_ACCESS_USED;
+ *    io_read()/io_write() then call sim_io_read()/sim_io_write()
+ *  - accesses are routed to the current backend (SimBusBackend);
+ *    the default backend is SimBus, which contains a register-level
+ *    model of each slot of mmio_sys_sampler.sv
+ *  - another backend (e.g., a co-simulation) can be plugged in with
+ *    sim_io_set_backend()
+ *  - SimBus keeps a system clock count (SYS_CLK_FREQ); every bus access
+ *    advances the clock by access_cycles so that timer-based polling
+ *    loops (e.g., sleep_ms()) terminate
+ *
+ * build example:
+ *   g++ -D_SIM_IO_ACCESS_USED -I. chu_io_sim.cpp chu_init.cpp
+ *       timer_core.cpp uart_core.cpp ... my_test.cpp
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ *********************************************************************/
+
+#ifndef _CHU_IO_SIM_H_INCLUDED
+#define _CHU_IO_SIM_H_INCLUDED
+
+#include <inttypes.h>
+#include <deque>
+#include <string>
+#include "chu_io_map.h"
+#include "chu_io_rw.h"
+
+/**********************************************************************
+ * backend interface
+ **********************************************************************/
+/**
+ * simulated bus backend:
+ *  - receives every io_read()/io_write() issued by the drivers
+ *  - addr is the byte address generated by the driver
+ */
+class SimBusBackend {
+public:
+   virtual ~SimBusBackend() {}
+   virtual uint32_t read(uint32_t addr) = 0;
+   virtual void write(uint32_t addr, uint32_t data) = 0;
+   /** write a list in one call (io_wr_burst()); default: one write() each */
+   virtual void write_burst(const IoWrDesc *desc, int n) {
+      for (int i = 0; i < n; i++)
+         write(desc[i].addr, desc[i].data);
+   }
+};
+
+/**
+ * install a backend
+ * @param backend new backend; NULL restores the default SimBus
+ */
+void sim_io_set_backend(SimBusBackend *backend);
+
+/**
+ * return the current backend
+ */
+SimBusBackend *sim_io_get_backend();
+
+/**
+ * backend used until sim_io_set_backend() is called
+ * @note weak symbol returning &sim_bus(); a build can link its own
+ *       definition (e.g., chu_io_cosim.cpp) so that the global driver
+ *       objects are constructed against that backend
+ */
+SimBusBackend *sim_default_backend();
+
+/**********************************************************************
+ * slot models
+ **********************************************************************/
+class SimBus;
+
+/**
+ * generic slot model:
+ *  - reg is the 5-bit register address within the slot
+ *  - unused slots read 0 and ignore writes
+ */
+class SimSlot {
+public:
+   SimSlot(SimBus *bus_p) : bus(bus_p) {}
+   virtual ~SimSlot() {}
+   virtual uint32_t read(int /* reg */) { return (0); }
+   virtual void write(int /* reg */, uint32_t /* data */) {}
+   virtual void reset() {}
+protected:
+   SimBus *bus;
+};
+
+/**
+ * chu_timer model:
+ *  - 48-bit counter incremented each clock when go = 1
+ *  - reading the lower word latches the upper 16 bits for reg 1
+ *  - compare/alarm: match is set once the counter reaches the armed
+ *    compare value (checked at each access; the counter only moves
+ *    forward between accesses)
+ */
+class SimTimer : public SimSlot {
+public:
+   SimTimer(SimBus *bus_p);
+   uint32_t read(int reg);
+   void write(int reg, uint32_t data);
+   void reset();
+   uint64_t count();
+   /** alarm interrupt line (match && interrupt enable) */
+   int irq();
+private:
+   uint64_t count_reg;
+   uint32_t upper_reg;   // upper 16 bits latched by a lower read
+   uint64_t cmp_reg;     // compare value
+   uint64_t last_cycle;  // clock of last count update
+   int go;
+   int ie;
+   int armed;
+   int match;            // sticky
+   void update();
+};
+
+/**
+ * chu_uart model:
+ *  - 2^FIFO_DEPTH_BIT-entry tx/rx FIFOs
+ *  - a tx byte stays in the FIFO until its 10-bit frame is shifted out
+ *    at sys_clk/16/(dvsr+1+dvsr_frac/256) baud
+ *  - shifted-out bytes are appended to tx_log() and optionally echoed
+ *    to stdout
+ */
+class SimUart : public SimSlot {
+public:
+   enum {
+      FIFO_DEPTH_BIT = 8,
+      FIFO_DEPTH = 1 << FIFO_DEPTH_BIT
+   };
+   SimUart(SimBus *bus_p);
+   uint32_t read(int reg);
+   void write(int reg, uint32_t data);
+   void reset();
+   /** queue a byte into the rx FIFO (as if received from the line) */
+   void rx_push(uint8_t byte);
+   /** bytes shifted out of the tx line up to the current clock */
+   std::string &tx_log();
+   /** echo transmitted bytes to stdout */
+   void set_echo(int on) { echo = on; }
+   uint32_t get_dvsr() { return dvsr_reg; }
+   uint32_t get_dvsr_frac() { return frac_reg; }
+   /** # clocks to transmit one 10-bit frame (0 if baud_gen does not tick) */
+   uint64_t frame_cycles();
+   /** shift out everything left in the tx FIFO (e.g., at exit) */
+   void drain();
+private:
+   uint32_t dvsr_reg;
+   uint32_t frac_reg;
+   std::deque<uint8_t> tx_fifo;
+   std::deque<uint8_t> rx_fifo;
+   uint64_t tx_done_cycle;  // clock when the head of tx FIFO is sent
+   std::string log;
+   int echo;
+   void update();
+};
+
+/**
+ * chu_gpo model (write only; read returns 0)
+ */
+class SimGpo : public SimSlot {
+public:
+   SimGpo(SimBus *bus_p) : SimSlot(bus_p), buf_reg(0), n_wr(0) {}
+   void write(int /* reg */, uint32_t data) { buf_reg = data; n_wr++; }
+   void reset() { buf_reg = 0; n_wr = 0; }
+   uint32_t dout() { return buf_reg; }
+   /** # writes received */
+   unsigned long writes() { return n_wr; }
+private:
+   uint32_t buf_reg;
+   unsigned long n_wr;
+};
+
+/**
+ * chu_gpi model
+ */
+class SimGpi : public SimSlot {
+public:
+   SimGpi(SimBus *bus_p) : SimSlot(bus_p), din(0) {}
+   uint32_t read(int /* reg */) { return (din); }
+   void reset() { din = 0; }
+   void set(uint32_t data) { din = data; }
+private:
+   uint32_t din;
+};
+
+/**
+ * chu_watchdog model:
+ *  - counter decremented each clock while enabled (evaluated at each
+ *    access); at 0 the flag is set and the watchdog disables itself
+ *  - the cpu reset itself is not modeled; resets() counts them
+ */
+class SimWdt : public SimSlot {
+public:
+   SimWdt(SimBus *bus_p);
+   uint32_t read(int reg);
+   void write(int reg, uint32_t data);
+   void reset();
+   /** # watchdog resets since the bus reset */
+   unsigned long resets();
+   /** clock of the last watchdog reset */
+   uint64_t reset_cycle() { return (rst_cycle); }
+private:
+   uint32_t load_reg;
+   uint32_t count_reg;
+   uint32_t tag_reg;
+   uint64_t last_cycle;
+   uint64_t rst_cycle;
+   unsigned long n_rst;
+   int en;
+   int flag;
+   void update();
+};
+
+/**
+ * chu_xadc_core model: 6 16-bit conversion result registers
+ */
+class SimXadc : public SimSlot {
+public:
+   SimXadc(SimBus *bus_p);
+   uint32_t read(int reg);
+   void reset();
+   /** set raw 16-bit result of a channel (0-3: adc, 4: temp, 5: vcc) */
+   void set_raw(int ch, uint16_t raw);
+   /** set FPGA die temperature in Celsius (ug480 transfer function) */
+   void set_temp(double c);
+   /** set FPGA core vcc in volts */
+   void set_vcc(double v);
+private:
+   uint16_t data_reg[6];
+};
+
+/**
+ * chu_io_pwm_core model (W=8, R=10; read returns 0)
+ */
+class SimPwm : public SimSlot {
+public:
+   enum { W = 8, R = 10 };
+   SimPwm(SimBus *bus_p);
+   void write(int reg, uint32_t data);
+   void reset();
+   uint32_t dvsr() { return dvsr_reg; }
+   uint32_t duty(int ch) { return duty_reg[ch]; }
+   unsigned long writes() { return n_wr; }
+private:
+   uint32_t dvsr_reg;
+   uint32_t duty_reg[W];
+   unsigned long n_wr;
+};
+
+/**
+ * chu_led_mux_core model (read returns 0)
+ */
+class SimSseg : public SimSlot {
+public:
+   SimSseg(SimBus *bus_p) : SimSlot(bus_p) { reset(); }
+   void write(int reg, uint32_t data);
+   void reset();
+   /** 8-bit pattern (incl. dp in bit 7) of digit pos (0 is rightmost) */
+   uint8_t ptn(int pos);
+   unsigned long writes() { return n_wr; }
+private:
+   uint32_t d_reg[2];
+   unsigned long n_wr;
+};
+
+/**
+ * ADT7420 temperature sensor model (device on the i2c bus)
+ *  - register pointer with auto increment
+ *  - 13-bit temperature in reg 0x00/0x01, id 0xcb in reg 0x0b
+ */
+class SimAdt7420 {
+public:
+   enum { DEV_ADDR = 0x4b };
+   SimAdt7420() { reset(); }
+   void reset();
+   /** set the sensed temperature in Celsius */
+   void set_temp(double c);
+   /** first write after address sets pointer; then write data */
+   void start_write() { first_wr = 1; }
+   void write(uint8_t data);
+   uint8_t read();
+private:
+   uint8_t regs[0x30];
+   uint8_t ptr;
+   int first_wr;
+};
+
+/**
+ * chu_i2c_core model:
+ *  - follows the command sequencing and timing of i2c_master.sv
+ *    (ready low while a command is in progress)
+ *  - commands issued while not ready are ignored, as in hardware
+ *  - an ADT7420 is attached at address 0x4b; other addresses nack
+ */
+class SimI2c : public SimSlot {
+public:
+   SimI2c(SimBus *bus_p);
+   uint32_t read(int reg);
+   void write(int reg, uint32_t data);
+   void reset();
+   SimAdt7420 &adt7420() { return sensor; }
+private:
+   enum { IDLE, HOLD } state;
+   uint32_t dvsr_reg;
+   uint64_t busy_until;
+   int addr_phase;   // next written byte is device address/rw
+   int dev_sel;      // addressed device acked
+   int rd_mode;
+   uint8_t dout;
+   int ack;
+   SimAdt7420 sensor;
+   int ready();
+};
+
+/**********************************************************************
+ * simulated FPro bus
+ **********************************************************************/
+/**
+ * simulated FPro bus with the slot layout of mmio_sys_sampler.sv:
+ *  - decodes BRIDGE_BASE + 4*(slot*32 + reg) as chu_mcs_bridge and
+ *    chu_mmio_controller do
+ *  - keeps the system clock count used by all models
+ */
+class SimBus : public SimBusBackend {
+public:
+   enum {
+      N_SLOT = 64,
+      DEF_ACCESS_CYCLES = 4   /**< default clocks per bus access */
+   };
+   SimBus();
+   ~SimBus();
+   uint32_t read(uint32_t addr);
+   void write(uint32_t addr, uint32_t data);
+   void write_burst(const IoWrDesc *desc, int n);
+
+   /** reset clock and all slot models to their power-up state */
+   void reset();
+   /** current system clock count */
+   uint64_t cycle() { return clk; }
+   /** advance system clock by n clocks */
+   void advance(uint64_t n) { clk += n; }
+   /** set # clocks consumed by each bus access */
+   void set_access_cycles(uint32_t n) { access_cycles = n; }
+   /** # bus reads/writes since reset */
+   unsigned long reads() { return n_rd; }
+   unsigned long writes() { return n_wr; }
+   /** # write_burst() calls since reset */
+   unsigned long bursts() { return n_burst; }
+
+   /* slot models */
+   SimTimer timer;   // slot 0
+   SimUart uart;     // slot 1
+   SimGpo led;       // slot 2
+   SimGpi sw;        // slot 3
+   SimWdt wdt;       // slot 4
+   SimXadc adc;      // slot 5
+   SimPwm pwm;       // slot 6
+   SimSseg sseg;     // slot 8
+   SimI2c i2c;       // slot 10
+private:
+   SimSlot unused;
+   SimSlot *slots[N_SLOT];
+   uint64_t clk;
+   uint32_t access_cycles;
+   unsigned long n_rd, n_wr, n_burst;
+   SimSlot *decode(uint32_t addr, int *reg);
+};
+
+/**
+ * return the default simulated bus (created on first use)
+ */
+SimBus &sim_bus();
+
+#endif  // _CHU_IO_SIM_H_INCLUDED
@@ -0,0 +1,143 @@
+/*****************************************************************//**
+ * @file chu_io_stat.cpp
+ *
+ * @brief implementation of io access accounting
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _IO_STATS_USED
+#define _IO_STATS_USED
+#endif
+
+#include "chu_io_stat.h"
+#include "chu_report.h"
+
+/* per-site counts; site is the address of the function name string */
+typedef struct {
+   const char *site;
+   int slot;              // slot of the first access from the site
+   unsigned long rd;
+   unsigned long wr;
+} IoStatSite;
+
+static unsigned long slot_rd[IO_STAT_N_SLOT];
+static unsigned long slot_wr[IO_STAT_N_SLOT];
+static IoStatSite sites[IO_STAT_MAX_SITE + 1];   // last one is "(other)"
+static int n_site = 0;
+static int paused = 0;
+
+void io_stat_count(uint32_t addr, int wr, const char *site) {
+   int slot, i;
+   IoStatSite *s;
+
+   if (paused)
+      return;
+   slot = (int) ((addr - BRIDGE_BASE) >> 7) & (IO_STAT_N_SLOT - 1);
+   if (wr)
+      slot_wr[slot]++;
+   else
+      slot_rd[slot]++;
+   // linear search; a loop iteration touches only a few sites
+   for (i = 0; i < n_site; i++) {
+      if (sites[i].site == site)
+         break;
+   }
+   if (i == n_site) {
+      if (n_site < IO_STAT_MAX_SITE) {
+         n_site++;
+         sites[i].site = site;
+         sites[i].slot = slot;
+      } else {
+         i = IO_STAT_MAX_SITE;
+         sites[i].site = "(other)";
+         sites[i].slot = -1;
+      }
+   }
+   s = &sites[i];
+   if (wr)
+      s->wr++;
+   else
+      s->rd++;
+}
+
+void io_stat_clear() {
+   int i;
+
+   for (i = 0; i < IO_STAT_N_SLOT; i++) {
+      slot_rd[i] = 0;
+      slot_wr[i] = 0;
+   }
+   for (i = 0; i <= IO_STAT_MAX_SITE; i++) {
+      sites[i].site = 0;
+      sites[i].rd = 0;
+      sites[i].wr = 0;
+   }
+   n_site = 0;
+}
+
+unsigned long io_stat_reads(int slot) {
+   unsigned long sum = 0;
+
+   if (slot >= 0)
+      return (slot_rd[slot & (IO_STAT_N_SLOT - 1)]);
+   for (int i = 0; i < IO_STAT_N_SLOT; i++)
+      sum = sum + slot_rd[i];
+   return (sum);
+}
+
+unsigned long io_stat_writes(int slot) {
+   unsigned long sum = 0;
+
+   if (slot >= 0)
+      return (slot_wr[slot & (IO_STAT_N_SLOT - 1)]);
+   for (int i = 0; i < IO_STAT_N_SLOT; i++)
+      sum = sum + slot_wr[i];
+   return (sum);
+}
+
+int io_stat_budget(unsigned long max_rd, unsigned long max_wr) {
+   if (io_stat_reads(-1) > max_rd || io_stat_writes(-1) > max_wr)
+      return (-1);
+   return (0);
+}
+
+static void out_row(int slot, unsigned long rd, unsigned long wr) {
+   if (slot < 0)
+      report_str("     -");      // "(other)": sites of several slots
+   else
+      report_num(slot, 6);
+   report_num(rd, 8);
+   report_num(wr, 8);
+}
+
+void io_stat_report() {
+   int i, mode;
+
+   paused = 1;
+   mode = report_begin();
+   report_str("io access report\n\r");
+   report_str("  slot      rd      wr\n\r");
+   for (i = 0; i < IO_STAT_N_SLOT; i++) {
+      if (slot_rd[i] || slot_wr[i]) {
+         out_row(i, slot_rd[i], slot_wr[i]);
+         report_str("\n\r");
+      }
+   }
+   report_str("  slot      rd      wr  site\n\r");
+   for (i = 0; i <= IO_STAT_MAX_SITE; i++) {
+      if (sites[i].site && (sites[i].rd || sites[i].wr)) {
+         out_row(sites[i].slot, sites[i].rd, sites[i].wr);
+         report_str("  ");
+         report_str(sites[i].site);
+         report_str("\n\r");
+      }
+   }
+   report_str(" total");
+   report_num(io_stat_reads(-1), 8);
+   report_num(io_stat_writes(-1), 8);
+   report_str("\n\r");
+   report_end(mode);
+   paused = 0;
+}
@@ -0,0 +1,67 @@
+/*****************************************************************//**
+ * @file chu_io_stat.h
+ *
+ * @brief io access accounting: per-slot/per-site counts and budgets
+ *
+ * Detailed description:
+ *  - enabled by compiling all code with -D_IO_STATS_USED
+ *    (see io_read()/io_write() in chu_io_rw.h)
+ *  - counts reads/writes per io slot and per calling driver method
+ *    (site) since the last io_stat_clear()
+ *  - io_stat_report() prints the table over "uart" on target and
+ *    to stdout on host (_SIM_IO_ACCESS_USED)
+ *  - io_stat_budget() checks the totals against a transaction budget
+ *  - without _IO_STATS_USED all counts stay 0
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _CHU_IO_STAT_H_INCLUDED
+#define _CHU_IO_STAT_H_INCLUDED
+
+#include "chu_io_rw.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IO_STAT_MAX_SITE 48   // sites beyond this go to "(other)"
+#define IO_STAT_N_SLOT   64
+
+/**
+ * reset all counts.
+ */
+void io_stat_clear();
+
+/**
+ * # reads since last clear.
+ * @param slot io slot #; -1 for all slots
+ */
+unsigned long io_stat_reads(int slot);
+
+/**
+ * # writes since last clear.
+ * @param slot io slot #; -1 for all slots
+ */
+unsigned long io_stat_writes(int slot);
+
+/**
+ * check the totals since last clear against a budget.
+ * @param max_rd max # reads
+ * @param max_wr max # writes
+ * @return 0 if within budget; -1 otherwise
+ */
+int io_stat_budget(unsigned long max_rd, unsigned long max_wr);
+
+/**
+ * print per-slot and per-site counts since last clear.
+ * @note accesses made while printing are not counted
+ */
+void io_stat_report();
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif  // _CHU_IO_STAT_H_INCLUDED
@@ -0,0 +1,145 @@
+/*****************************************************************//**
+ * @file chu_io_trace.cpp
+ *
+ * @brief implementation of io access trace
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _IO_TRACE_USED
+#define _IO_TRACE_USED
+#endif
+
+#include "chu_io_trace.h"
+#include "chu_init.h"
+#include "wdt_core.h"
+
+#if (IO_TRACE_DEPTH & (IO_TRACE_DEPTH - 1)) != 0
+#error "IO_TRACE_DEPTH must be a power of 2"
+#endif
+#if (IO_TRACE_KICK_RECS & (IO_TRACE_KICK_RECS - 1)) != 0
+#error "IO_TRACE_KICK_RECS must be a power of 2"
+#endif
+
+extern TimerCore _sys_timer;   // chu_init.cpp
+
+static IoTraceRec ring[IO_TRACE_DEPTH];
+static uint32_t n_rec = 0;       // # records since clear (wraps)
+static unsigned long n_lost = 0;
+static uint32_t mask = 0;        // slots being recorded; 0 when stopped
+static int busy = 0;             // inside the trace code
+static WdtCore *wdt = 0;         // kicked during a dump
+
+static void record(uint32_t addr, uint32_t data, uint32_t wr) {
+   IoTraceRec *r;
+   uint32_t offset;
+
+   offset = (addr - BRIDGE_BASE) >> 2;
+   if (busy || !bit_read(mask, (offset >> 5) & 0x1f) || (offset >> 11) != 0)
+      return;
+   busy = 1;    // timer reads below are not recorded
+   r = &ring[n_rec & (IO_TRACE_DEPTH - 1)];
+   r->tick = _sys_timer.read_tick32();
+   r->addr = (wr << IO_TRACE_WR_BIT) | offset;
+   r->data = data;
+   if (n_rec >= IO_TRACE_DEPTH)
+      n_lost++;
+   n_rec++;
+   busy = 0;
+}
+
+uint32_t io_trace_rd(uint32_t addr, uint32_t data) {
+   record(addr, data, 0);
+   return (data);
+}
+
+uint32_t io_trace_wr(uint32_t addr, uint32_t data) {
+   record(addr, data, 1);
+   return (data);
+}
+
+void io_trace_start(uint32_t slot_mask) {
+   mask = slot_mask;
+}
+
+void io_trace_stop() {
+   mask = 0;
+}
+
+void io_trace_clear() {
+   n_rec = 0;
+   n_lost = 0;
+}
+
+int io_trace_count() {
+   return ((n_rec < IO_TRACE_DEPTH) ? (int) n_rec : IO_TRACE_DEPTH);
+}
+
+unsigned long io_trace_lost() {
+   return (n_lost);
+}
+
+int io_trace_get(int i, IoTraceRec *rec) {
+   uint32_t first;
+
+   if (i < 0 || i >= io_trace_count())
+      return (-1);
+   first = n_rec - (uint32_t) io_trace_count();
+   *rec = ring[(first + i) & (IO_TRACE_DEPTH - 1)];
+   return (0);
+}
+
+/* send a 32-bit word (little-endian) and add it to the checksum */
+static void tx_word(uint32_t w, uint32_t *sum) {
+   int i;
+
+   for (i = 0; i < 4; i++) {
+      uart.tx_byte((uint8_t) (w >> (8 * i)));
+   }
+   *sum = *sum + w;
+}
+
+void io_trace_dump() {
+   uint32_t sum = 0, first;
+   int i, n, tag = 0;
+   IoTraceRec *r;
+
+   busy = 1;   // uart and watchdog accesses below are not recorded
+   if (wdt)
+      tag = wdt->tag();
+   n = io_trace_count();
+   first = n_rec - (uint32_t) n;
+   tx_word('I' | 'O' << 8 | 'T' << 16 | (uint32_t) 'R' << 24, &sum);
+   tx_word(IO_TRACE_VERSION | IO_TRACE_REC_SIZE << 8 | SYS_CLK_FREQ << 16, &sum);
+   tx_word((uint32_t) n, &sum);
+   tx_word((uint32_t) n_lost, &sum);
+   for (i = 0; i < n; i++) {
+      if (wdt && (i & (IO_TRACE_KICK_RECS - 1)) == 0)
+         wdt->kick(tag);
+      r = &ring[(first + i) & (IO_TRACE_DEPTH - 1)];
+      tx_word(r->tick, &sum);
+      tx_word(r->addr, &sum);
+      tx_word(r->data, &sum);
+   }
+   tx_word(sum, &sum);
+   busy = 0;
+}
+
+void io_trace_set_watchdog(WdtCore *wdt_p) {
+   wdt = wdt_p;
+}
+
+int io_trace_poll() {
+   int ch, cmd = 0;
+
+   busy = 1;
+   while ((ch = uart.rx_byte()) != -1) {
+      if (ch == IO_TRACE_CMD)
+         cmd = 1;
+   }
+   busy = 0;
+   if (cmd)
+      io_trace_dump();
+   return (cmd);
+}
@@ -0,0 +1,134 @@
+/*****************************************************************//**
+ * @file chu_io_trace.h
+ *
+ * @brief io access trace: RAM ring buffer and binary stream-out
+ *
+ * Detailed description:
+ *  - enabled by compiling all code with -D_IO_TRACE_USED
+ *    (see io_read()/io_write() in chu_io_rw.h)
+ *  - while recording, every access of a selected slot is appended to
+ *    a ring buffer of IO_TRACE_DEPTH records; the oldest records are
+ *    overwritten when the buffer is full
+ *  - timestamp is TimerCore::read_tick32() of the system timer (lower
+ *    32 bits of the count); the timer read made for the timestamp is
+ *    not recorded (but costs 1 bus read per recorded access)
+ *  - io_trace_dump() streams the buffer over "uart" in the binary
+ *    format below; io_trace_poll() does so when IO_TRACE_CMD is
+ *    received, so a trace can be pulled from a running loop
+ *  - io_trace_replay.cpp decodes a captured stream and feeds it back
+ *    through the simulated bus (chu_io_sim.h)
+ *  - a full dump is about 6 KB (6 s at 9600 baud); with
+ *    io_trace_set_watchdog() the dump kicks the watchdog every
+ *    IO_TRACE_KICK_RECS records
+ *
+ * stream format (all fields little-endian):
+ *   header (16 bytes)
+ *     "IOTR", version (u8), record size (u8), SYS_CLK_FREQ (u16),
+ *     # records (u32), # records overwritten (u32)
+ *   records, oldest first (12 bytes each)
+ *     tick (u32), wr << 31 | word offset from BRIDGE_BASE (u32), data (u32)
+ *   trailer (4 bytes)
+ *     sum of all preceding 32-bit words (u32)
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _CHU_IO_TRACE_H_INCLUDED
+#define _CHU_IO_TRACE_H_INCLUDED
+
+#include "chu_io_rw.h"
+
+#ifdef __cplusplus
+class WdtCore;
+extern "C" {
+#endif
+
+#ifndef IO_TRACE_DEPTH
+#define IO_TRACE_DEPTH 512       // # records; must be a power of 2
+#endif
+#define IO_TRACE_VERSION  1
+#define IO_TRACE_REC_SIZE 12     // bytes per streamed record
+#define IO_TRACE_WR_BIT   31     // r/w flag in IoTraceRec.addr
+#define IO_TRACE_CMD      't'    // uart command for io_trace_poll()
+#ifndef IO_TRACE_KICK_RECS
+#define IO_TRACE_KICK_RECS 32    // records per watchdog kick (384 bytes)
+#endif
+
+/**
+ * trace record (same layout as the streamed record)
+ */
+typedef struct {
+   uint32_t tick;   // lower 32 bits of the system timer count
+   uint32_t addr;   // wr << 31 | word offset from BRIDGE_BASE
+   uint32_t data;   // data read or written
+} IoTraceRec;
+
+/**
+ * record an io read/write (called by io_read()/io_write(); see chu_io_rw.h).
+ * @return data
+ */
+uint32_t io_trace_rd(uint32_t addr, uint32_t data);
+uint32_t io_trace_wr(uint32_t addr, uint32_t data);
+
+/**
+ * start recording.
+ * @param slot_mask bit n selects slot n (slots 0-31); 0xffffffff for all
+ * @note the buffer is not cleared; see io_trace_clear()
+ */
+void io_trace_start(uint32_t slot_mask);
+
+/**
+ * stop recording.
+ */
+void io_trace_stop();
+
+/**
+ * discard all records.
+ */
+void io_trace_clear();
+
+/**
+ * # records in the buffer (at most IO_TRACE_DEPTH).
+ */
+int io_trace_count();
+
+/**
+ * # records overwritten since last clear.
+ */
+unsigned long io_trace_lost();
+
+/**
+ * get a record.
+ * @param i record #; 0 is the oldest
+ * @param rec pointer to the returned record
+ * @return 0 if i is valid; -1 otherwise
+ */
+int io_trace_get(int i, IoTraceRec *rec);
+
+/**
+ * stream the buffer over "uart" in binary format.
+ * @note recording is paused during the dump; the buffer is kept
+ */
+void io_trace_dump();
+
+/**
+ * kick a watchdog while a dump is streamed.
+ * @param wdt_p started watchdog; 0 for none
+ * @note the kicks keep the tag of the last kick before the dump (e.g.,
+ *       the scheduler task that called it); 1 bus read per dump
+ */
+void io_trace_set_watchdog(WdtCore *wdt_p);
+
+/**
+ * dump the buffer if IO_TRACE_CMD has been received over "uart".
+ * @return 1 if dumped; 0 otherwise
+ * @note other received bytes are discarded
+ */
+int io_trace_poll();
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif  // _CHU_IO_TRACE_H_INCLUDED
@@ -1,3 +1,6 @@
+// offsets from chu_io_map.svh (generated from chu_io_map.def)
+`include "chu_io_map.svh"
+
 module chu_led_mux_core
    (
     input  logic clk,
@@ -40,8 +43,8 @@ module chu_led_mux_core
             d1_reg <= wr_data;
      end
    // decoding
-   assign wr_d0 = write & cs & ~addr[0];
-   assign wr_d1 = write & cs & addr[0];
+   assign wr_d0 = write & cs & (addr[0]==`SSEG_DATA_LOW_REG);
+   assign wr_d1 = write & cs & (addr[0]==`SSEG_DATA_HIGH_REG);
    // read data (unused)
    assign rd_data = 0;
 endmodule  
@@ -0,0 +1,63 @@
+/*****************************************************************//**
+ * @file chu_log.cpp
+ *
+ * @brief implementation of the deferred log ring and its uart drain
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#include "chu_log.h"
+#include "chu_init.h"
+
+extern TimerCore _sys_timer;   // chu_init.cpp
+
+uint32_t log_ring[LOG_DEPTH];
+uint32_t log_head = 0;
+uint32_t log_tail = 0;
+unsigned long log_lost = 0;
+static unsigned long n_drop = 0;
+
+uint32_t log_tick() {
+   return (_sys_timer.read_tick32());
+}
+
+int log_poll() {
+   uint8_t pl[1 + 4 * LOG_REC_MAX + 2], frame[LOG_FRAME_MAX];
+   uint32_t w;
+   uint16_t crc;
+   int n, i, k, len, sent = 0;
+
+   while (log_tail != log_head) {
+      n = (int) (log_ring[(log_tail + 2) & (LOG_DEPTH - 1)] & 0x0f);
+      pl[0] = (uint8_t) ((log_lost > 255) ? 255 : log_lost);
+      for (i = 0; i < n; i++) {
+         w = log_ring[(log_tail + i) & (LOG_DEPTH - 1)];
+         for (k = 0; k < 4; k++)
+            pl[1 + 4 * i + k] = (uint8_t) (w >> (8 * k));
+      }
+      len = 1 + 4 * n;
+      crc = telem_crc16(pl, len, 0xffff);
+      pl[len] = (uint8_t) crc;
+      pl[len + 1] = (uint8_t) (crc >> 8);
+      len = telem_cobs_encode(pl, len + 2, frame);
+      frame[len++] = 0;
+      // whole records only; the rest waits for the next call
+      if (uart.tx_room() < len)
+         break;
+      uart.disp_buf((const char *) frame, len);
+      n_drop = n_drop + log_lost;
+      log_lost = 0;
+      log_tail = log_tail + n;
+      sent++;
+   }
+   return (sent);
+}
+
+unsigned long log_dropped() {
+   return (n_drop + log_lost);
+}
+
+void log_clear_stats() {
+   n_drop = 0;
+}
@@ -0,0 +1,309 @@
+/*****************************************************************//**
+ * @file chu_log.h
+ *
+ * @brief Leveled deferred logging: binary records on target, text on host
+ *
+ * Detailed description:
+ *  - enabled by compiling with -D_LOG_USED; otherwise LOG_ERROR(),
+ *    LOG_WARN(), LOG_INFO() and LOG_TRACE() expand to nothing
+ *  - levels: a statement logs if its level is at most LOG_MODULE_LEVEL
+ *    of the file; LOG_MODULE_LEVEL defaults to LOG_LEVEL (default
+ *    LOG_LEVEL_INFO; e.g., -DLOG_LEVEL=LOG_LEVEL_WARN for all files);
+ *    a module sets its own threshold by defining LOG_MODULE_LEVEL
+ *    before its first #include
+ *  - a disabled statement is a constant-false branch: no code and no
+ *    argument evaluation (even at -O0), but its format is still checked
+ *  - LOG_TRACE("i2c wr {:x} ack {}", data, ack) stores a record in a
+ *    RAM ring of LOG_DEPTH words: no formatting, no uart access, never
+ *    waits; the cost is 1 timer read plus 3 + (# argument words) word
+ *    stores, so it can be used in hot paths such as
+ *    I2cCore::write_byte()
+ *  - the format string is not stored on target: its id is a 32-bit
+ *    FNV-1a hash computed at compile time; the host tool log_decode.cpp
+ *    hashes the LOG_xxx("...") strings of the sources with the same
+ *    function to rebuild the string table
+ *  - format syntax is that of chu_print.h; the # of {} and the spec of
+ *    each argument are checked at compile time; arguments: integers up
+ *    to 64 bits, char, float/double and fmt_fix(); no strings (the host
+ *    has no copy of target memory)
+ *  - a record that does not fit the ring is dropped and counted
+ *  - log_poll() (call it from a background task) moves whole records
+ *    to "uart" while UartCore::tx_room() has space for them
+ *
+ * record (32-bit words):
+ *   id (FNV-1a hash of the format string)
+ *   tick (lower 32 bits of the system timer count)
+ *   types << 8 | level << 4 | # words of the record (types: 4 bits
+ *     per argument, argument 0 in bits 3-0; LOG_T_*)
+ *   arguments (64-bit, double and fmt_fix(): 2 words, low/v first)
+ *
+ * stream format: per record, COBS (chu_telem.h) of
+ *   # records dropped since the previous record sent (u8, saturated),
+ *   the record words (little-endian), CRC-16/CCITT-FALSE (u16)
+ * followed by a 0x00 delimiter
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _CHU_LOG_H_INCLUDED
+#define _CHU_LOG_H_INCLUDED
+
+#include <string.h>
+#include "chu_print.h"
+#include "chu_telem.h"
+
+#ifndef LOG_DEPTH
+#define LOG_DEPTH 1024           // ring size in words; must be a power of 2
+#endif
+#define LOG_MAX_ARGS  6
+#define LOG_HDR_WORDS 3
+#define LOG_REC_MAX   (LOG_HDR_WORDS + 2 * LOG_MAX_ARGS)
+#define LOG_FRAME_MAX (1 + 4 * LOG_REC_MAX + 2 + 2)   // + COBS + delimiter
+
+// levels
+#define LOG_LEVEL_OFF   0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_TRACE 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+#ifndef LOG_MODULE_LEVEL
+#define LOG_MODULE_LEVEL LOG_LEVEL
+#endif
+
+// argument types
+#define LOG_T_I32 1
+#define LOG_T_U32 2
+#define LOG_T_I64 3
+#define LOG_T_U64 4
+#define LOG_T_DBL 5
+#define LOG_T_FIX 6
+#define LOG_T_CHR 7
+
+/**
+ * string id: 32-bit FNV-1a hash
+ */
+constexpr uint32_t log_hash(const char *s) {
+   uint32_t h = 2166136261u;
+
+   while (*s != '\0') {
+      h = (h ^ (uint8_t) *s) * 16777619u;
+      s++;
+   }
+   return (h);
+}
+
+/* type code of an argument; 0 if it cannot be logged */
+template <class T>
+constexpr int log_type() {
+   typedef typename std::decay<T>::type D;
+
+   return (std::is_same<D, FmtFix>::value ? LOG_T_FIX :
+           std::is_floating_point<D>::value ? LOG_T_DBL :
+           std::is_same<D, char>::value ? LOG_T_CHR :
+           !std::is_integral<D>::value ? 0 :
+           (sizeof(D) > 4) ? (std::is_signed<D>::value ? LOG_T_I64 : LOG_T_U64) :
+           (std::is_signed<D>::value ? LOG_T_I32 : LOG_T_U32));
+}
+
+constexpr int log_type_words(int t) {
+   return ((t == LOG_T_I64 || t == LOG_T_U64 || t == LOG_T_DBL || t == LOG_T_FIX) ? 2 : 1);
+}
+
+/* type field and # argument words of an argument list */
+template <class... A>
+struct LogSig;
+
+template <>
+struct LogSig<> {
+   static constexpr uint32_t types = 0;
+   static constexpr int words = 0;
+   static constexpr int ok = 1;
+};
+
+template <class T, class... R>
+struct LogSig<T, R...> {
+   static constexpr uint32_t types = (uint32_t) log_type<T>() | LogSig<R...>::types << 4;
+   static constexpr int words = log_type_words(log_type<T>()) + LogSig<R...>::words;
+   static constexpr int ok = (log_type<T>() != 0) && LogSig<R...>::ok;
+};
+
+/**********************************************************************
+ * target side
+ **********************************************************************/
+extern uint32_t log_ring[LOG_DEPTH];
+extern uint32_t log_head;        // next write (free running)
+extern uint32_t log_tail;        // next read (free running)
+extern unsigned long log_lost;   // records dropped, not yet reported
+
+/**
+ * lower 32 bits of the system timer count (clocks).
+ */
+uint32_t log_tick();
+
+/**
+ * send whole records over "uart" while it has room
+ * @return # records sent
+ *
+ */
+int log_poll();
+
+/**
+ * # records dropped (ring full) since the last log_clear_stats()
+ */
+unsigned long log_dropped();
+
+/**
+ * clear the drop count
+ */
+void log_clear_stats();
+
+inline uint32_t log_w32(uint32_t i, uint32_t w) {
+   log_ring[i & (LOG_DEPTH - 1)] = w;
+   return (i + 1);
+}
+
+inline uint32_t log_w64(uint32_t i, uint64_t w) {
+   i = log_w32(i, (uint32_t) w);
+   return (log_w32(i, (uint32_t) (w >> 32)));
+}
+
+template <class T>
+inline uint32_t log_arg(uint32_t i, T a) {
+   if (sizeof(T) > 4)
+      return (log_w64(i, (uint64_t) a));
+   return (log_w32(i, (uint32_t) a));
+}
+
+inline uint32_t log_arg(uint32_t i, float f) {
+   return (log_arg(i, (double) f));
+}
+
+inline uint32_t log_arg(uint32_t i, double f) {
+   uint64_t bits;
+
+   memcpy(&bits, &f, sizeof(bits));
+   return (log_w64(i, bits));
+}
+
+inline uint32_t log_arg(uint32_t i, FmtFix x) {
+   i = log_w32(i, (uint32_t) x.v);
+   return (log_w32(i, (uint32_t) x.frac_bits));
+}
+
+inline uint32_t log_args(uint32_t i) {
+   return (i);
+}
+
+template <class T, class... R>
+inline uint32_t log_args(uint32_t i, const T &a, const R &... rest) {
+   return (log_args(log_arg(i, a), rest...));
+}
+
+/**
+ * store a record (use LOG_ERROR() ... LOG_TRACE())
+ */
+template <int L, class F, class... A>
+inline void log_write(F fmt, const A &... args) {
+   constexpr uint32_t id = log_hash(F::str());
+   constexpr int n = LOG_HDR_WORDS + LogSig<A...>::words;
+   uint32_t i;
+
+   static_assert(fmt_count(F::str()) == (int) sizeof...(A),
+                 "# of {} differs from # of arguments");
+   static_assert(sizeof...(A) <= LOG_MAX_ARGS, "too many log arguments");
+   static_assert(LogSig<A...>::ok, "log argument is not a number");
+   (void) fmt;
+   if (LOG_DEPTH - (log_head - log_tail) < (uint32_t) n) {
+      log_lost++;
+      return;
+   }
+   i = log_w32(log_head, id);
+   i = log_w32(i, log_tick());
+   i = log_w32(i, LogSig<A...>::types << 8 | (uint32_t) L << 4 | (uint32_t) n);
+   log_head = log_args(i, args...);
+}
+
+#ifdef _LOG_USED
+#define LOG_AT(level, fmt, ...) \
+   do { \
+      if ((level) <= LOG_MODULE_LEVEL) \
+         log_write<(level)>(FMT_STR(fmt), ##__VA_ARGS__); \
+   } while (0)
+#else
+#define LOG_AT(level, fmt, ...) ((void) 0)
+#endif  // _LOG_USED
+
+#define LOG_ERROR(fmt, ...) LOG_AT(LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define LOG_WARN(fmt, ...)  LOG_AT(LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#define LOG_INFO(fmt, ...)  LOG_AT(LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#define LOG_TRACE(fmt, ...) LOG_AT(LOG_LEVEL_TRACE, fmt, ##__VA_ARGS__)
+
+/**********************************************************************
+ * host side (log_decode.cpp)
+ **********************************************************************/
+/**
+ * render a record with its format string
+ * @param rec record words
+ * @param n # words
+ * @return # chars written; -1 if the record does not match the format
+ *
+ */
+inline int log_render(char *buf, int size, const char *fmt, const uint32_t *rec, int n) {
+   char *p = buf, *end = buf + size;
+   uint32_t types = rec[2] >> 8;
+   int i, k = LOG_HDR_WORDS, t;
+   uint64_t w;
+   double f;
+   FmtSpec sp = {0, 0, 0, 0, -1, 0, 0, 0};
+
+   i = fmt_find(fmt, 0);
+   while (fmt[i] != '\0') {
+      sp = fmt_parse(fmt, sp.lit, i);
+      t = (int) (types & 0x0f);
+      types = types >> 4;
+      if (sp.error || t == 0 || k + log_type_words(t) > n)
+         return (-1);
+      p = fmt_copy(p, end, fmt + sp.lit, sp.open - sp.lit);
+      w = rec[k];
+      if (log_type_words(t) == 2)
+         w = w | (uint64_t) rec[k + 1] << 32;
+      k = k + log_type_words(t);
+      switch (t) {
+      case LOG_T_I32:
+         p = fmt_put(p, end, sp, (int) (int32_t) w);
+         break;
+      case LOG_T_U32:
+         p = fmt_put(p, end, sp, (unsigned int) w);
+         break;
+      case LOG_T_I64:
+         p = fmt_put(p, end, sp, (long long) w);
+         break;
+      case LOG_T_U64:
+         p = fmt_put(p, end, sp, (unsigned long long) w);
+         break;
+      case LOG_T_DBL:
+         memcpy(&f, &w, sizeof(f));
+         p = fmt_put(p, end, sp, f);
+         break;
+      case LOG_T_FIX:
+         p = fmt_put(p, end, sp, fmt_fix((int32_t) w, (int) (w >> 32)));
+         break;
+      default:
+         p = fmt_put(p, end, sp, (char) w);
+         break;
+      }
+      sp.lit = sp.close + 1;
+      i = fmt_find(fmt, sp.lit);
+   }
+   if (types != 0 || k != n)
+      return (-1);
+   p = fmt_copy(p, end, fmt + sp.lit, i - sp.lit);
+   return ((int) (p - buf));
+}
+
+#endif  // _CHU_LOG_H_INCLUDED
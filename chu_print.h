@@ -0,0 +1,372 @@
+/*****************************************************************//**
+ * @file chu_print.h
+ *
+ * @brief Type-safe formatted output checked at compile time
+ *
+ * Detailed description:
+ *  - a message is rendered into a stack buffer and sent to the uart
+ *    with one UartCore::disp_buf() call (one tx fifo level read per
+ *    burst) instead of one disp() call per piece
+ *  - the format string is parsed at compile time: the # of arguments
+ *    and each spec are checked with static_assert and the literal
+ *    pieces become constant-length copies; no heap, no printf
+ *  - placeholders: {} or {:spec}, spec = [0][width][.prec][type]
+ *      0      pad with '0' instead of blanks (numbers)
+ *      width  minimum # chars, right aligned
+ *      .prec  # of fraction digits of double/fmt_fix() (default 3,
+ *             as UartCore::disp(double)); truncated
+ *      type   d (default), x, o, b for integers
+ *    '{' always starts a placeholder (no escape)
+ *  - argument types: integers (up to 64 bits; x/o/b print the two's
+ *    complement of negative values), char, const char *, float/double
+ *    (integer-only conversion, see chu_fmt.h) and fmt_fix(v, frac_bits)
+ *    for Q-format values
+ *  - output longer than the buffer is truncated
+ *  - needs C++14 (constexpr loops)
+ *  - usage:
+ *      fmt_print(uart, FMT_STR("T={:.2} C, {} samples\n\r"), t, n);
+ *      n = fmt_format(buf, sizeof(buf), FMT_STR("{:08x}"), addr);
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _CHU_PRINT_H_INCLUDED
+#define _CHU_PRINT_H_INCLUDED
+
+#include <type_traits>
+#include "chu_fmt.h"
+#include "uart_core.h"
+
+#ifndef FMT_BUF_SIZE
+#define FMT_BUF_SIZE 128      // stack buffer of fmt_print()
+#endif
+
+/**
+ * format string as a type: FMT_STR("...") makes an empty object whose
+ * type holds the literal, so it can be parsed in constant expressions
+ */
+#define FMT_STR(s) \
+   ([] { \
+      struct FmtStr_ { \
+         static constexpr const char *str() { \
+            return (s); \
+         } \
+      }; \
+      return (FmtStr_()); \
+   }())
+
+/**
+ * fixed-point argument: v / 2^frac_bits (frac_bits 0 to 31)
+ */
+struct FmtFix {
+   int32_t v;
+   int frac_bits;
+};
+
+inline FmtFix fmt_fix(int32_t v, int frac_bits) {
+   FmtFix f = {v, frac_bits};
+   return (f);
+}
+
+/**********************************************************************
+ * compile-time parsing
+ **********************************************************************/
+/**
+ * placeholder descriptor; literal text before it is [lit, open)
+ */
+struct FmtSpec {
+   int lit;       // start of the literal piece
+   int open;      // '{'
+   int close;     // '}'
+   int width;
+   int prec;      // -1: default
+   int shift;     // 0: decimal; 1/3/4: b/o/x
+   int zero;      // '0' padding
+   int error;     // malformed spec
+};
+
+/* index of the next '{' at or after i (end of string if none) */
+constexpr int fmt_find(const char *s, int i) {
+   while (s[i] != '\0' && s[i] != '{')
+      i++;
+   return (i);
+}
+
+/* parse the spec of the placeholder opening at s[open] */
+constexpr FmtSpec fmt_parse(const char *s, int lit, int open) {
+   FmtSpec sp = {lit, open, open, 0, -1, 0, 0, 0};
+   int i = open + 1;
+
+   if (s[i] == ':') {
+      i++;
+      if (s[i] == '0') {
+         sp.zero = 1;
+         i++;
+      }
+      while (s[i] >= '0' && s[i] <= '9') {
+         sp.width = sp.width * 10 + (s[i] - '0');
+         i++;
+      }
+      if (s[i] == '.') {
+         i++;
+         sp.prec = 0;
+         while (s[i] >= '0' && s[i] <= '9') {
+            sp.prec = sp.prec * 10 + (s[i] - '0');
+            i++;
+         }
+      }
+      if (s[i] == 'x')
+         sp.shift = 4;
+      else if (s[i] == 'o')
+         sp.shift = 3;
+      else if (s[i] == 'b')
+         sp.shift = 1;
+      if (s[i] == 'x' || s[i] == 'o' || s[i] == 'b' || s[i] == 'd')
+         i++;
+   }
+   if (s[i] != '}' || sp.width > FMT_BUF_SIZE || sp.prec > 32)
+      sp.error = 1;
+   sp.close = i;
+   return (sp);
+}
+
+/* k-th placeholder (0-based) */
+constexpr FmtSpec fmt_spec(const char *s, int k) {
+   FmtSpec sp = fmt_parse(s, 0, fmt_find(s, 0));
+   int i = 0;
+
+   for (; i < k && !sp.error; i++)
+      sp = fmt_parse(s, sp.close + 1, fmt_find(s, sp.close + 1));
+   return (sp);
+}
+
+/* # placeholders; -1 if any is malformed */
+constexpr int fmt_count(const char *s) {
+   int n = 0, i = fmt_find(s, 0);
+   FmtSpec sp = {0, 0, 0, 0, -1, 0, 0, 0};
+
+   while (s[i] != '\0') {
+      sp = fmt_parse(s, 0, i);
+      if (sp.error)
+         return (-1);
+      n++;
+      i = fmt_find(s, sp.close + 1);
+   }
+   return (n);
+}
+
+/* start of the literal after the last placeholder */
+constexpr int fmt_tail(const char *s) {
+   int i = fmt_find(s, 0), tail = 0;
+
+   while (s[i] != '\0') {
+      tail = fmt_parse(s, 0, i).close + 1;
+      i = fmt_find(s, tail);
+   }
+   return (tail);
+}
+
+constexpr int fmt_length(const char *s) {
+   int i = 0;
+
+   while (s[i] != '\0')
+      i++;
+   return (i);
+}
+
+/**********************************************************************
+ * rendering
+ **********************************************************************/
+/* copy n chars; stops at end */
+inline char *fmt_copy(char *p, char *end, const char *s, int n) {
+   while (n-- > 0 && p < end)
+      *p++ = *s++;
+   return (p);
+}
+
+/* copy [first, last) right aligned in width */
+inline char *fmt_field(char *p, char *end, const FmtSpec &sp, const char *first,
+                       const char *last) {
+   int n = (int) (last - first);
+   char pad = sp.zero ? '0' : ' ';
+
+   // zero padding goes after the sign
+   if (sp.zero && n > 0 && n < sp.width && *first == '-' && p < end)
+      *p++ = *first++;
+   while (n < sp.width && p < end) {
+      *p++ = pad;
+      n++;
+   }
+   return (fmt_copy(p, end, first, (int) (last - first)));
+}
+
+inline char *fmt_put_u64(char *p, char *end, const FmtSpec &sp, uint64_t v, int neg) {
+   char buf[66], *s;
+
+   if (sp.shift)
+      s = fmt_pow2_64(&buf[65], v, sp.shift);
+   else if (v >> 32)
+      s = fmt_dec64(&buf[65], v);
+   else
+      s = fmt_dec32(&buf[65], (uint32_t) v);
+   if (neg)
+      *--s = '-';
+   return (fmt_field(p, end, sp, s, &buf[65]));
+}
+
+inline char *fmt_put_u32(char *p, char *end, const FmtSpec &sp, uint32_t v, int neg) {
+   char buf[34], *s;
+
+   if (sp.shift)
+      s = fmt_pow2_32(&buf[33], v, sp.shift);
+   else
+      s = fmt_dec32(&buf[33], v);
+   if (neg)
+      *--s = '-';
+   return (fmt_field(p, end, sp, s, &buf[33]));
+}
+
+inline char *fmt_put_q32(char *p, char *end, const FmtSpec &sp, int neg, uint32_t ip,
+                         uint32_t fq) {
+   char buf[48], *s, *e;
+
+   s = fmt_dec32(&buf[12], ip);
+   if (neg)
+      *--s = '-';
+   buf[12] = '.';
+   e = fmt_frac_q32(&buf[13], fq, (sp.prec < 0) ? 3 : sp.prec);
+   if (sp.prec == 0)
+      e--;                      // no point without digits
+   return (fmt_field(p, end, sp, s, e));
+}
+
+/* one overload per argument class */
+inline char *fmt_put(char *p, char *end, const FmtSpec &sp, long long v) {
+   if (sp.shift)
+      return (fmt_put_u64(p, end, sp, (uint64_t) v, 0));
+   if (v < 0)
+      return (fmt_put_u64(p, end, sp, 0 - (uint64_t) v, 1));
+   return (fmt_put_u64(p, end, sp, (uint64_t) v, 0));
+}
+
+inline char *fmt_put(char *p, char *end, const FmtSpec &sp, unsigned long long v) {
+   return (fmt_put_u64(p, end, sp, v, 0));
+}
+
+inline char *fmt_put(char *p, char *end, const FmtSpec &sp, int v) {
+   if (sp.shift)
+      return (fmt_put_u32(p, end, sp, (uint32_t) v, 0));
+   if (v < 0)
+      return (fmt_put_u32(p, end, sp, 0u - (uint32_t) v, 1));
+   return (fmt_put_u32(p, end, sp, (uint32_t) v, 0));
+}
+
+inline char *fmt_put(char *p, char *end, const FmtSpec &sp, long v) {
+   if (sizeof(long) > 4)
+      return (fmt_put(p, end, sp, (long long) v));
+   return (fmt_put(p, end, sp, (int) v));
+}
+
+inline char *fmt_put(char *p, char *end, const FmtSpec &sp, unsigned long v) {
+   if (sizeof(long) > 4)
+      return (fmt_put_u64(p, end, sp, v, 0));
+   return (fmt_put_u32(p, end, sp, (uint32_t) v, 0));
+}
+
+inline char *fmt_put(char *p, char *end, const FmtSpec &sp, unsigned int v) {
+   return (fmt_put_u32(p, end, sp, v, 0));
+}
+
+inline char *fmt_put(char *p, char *end, const FmtSpec &sp, char c) {
+   return (fmt_field(p, end, sp, &c, &c + 1));
+}
+
+inline char *fmt_put(char *p, char *end, const FmtSpec &sp, const char *str) {
+   return (fmt_field(p, end, sp, str, str + fmt_length(str)));
+}
+
+inline char *fmt_put(char *p, char *end, const FmtSpec &sp, double f) {
+   uint32_t ip, fq;
+   int neg;
+
+   neg = fmt_dbl_split(f, &ip, &fq);
+   return (fmt_put_q32(p, end, sp, neg, ip, fq));
+}
+
+inline char *fmt_put(char *p, char *end, const FmtSpec &sp, FmtFix x) {
+   uint32_t uv;
+
+   uv = (x.v < 0) ? 0u - (uint32_t) x.v : (uint32_t) x.v;
+   if (x.frac_bits <= 0)
+      return (fmt_put_q32(p, end, sp, x.v < 0, uv, 0));
+   return (fmt_put_q32(p, end, sp, x.v < 0, uv >> x.frac_bits, uv << (32 - x.frac_bits)));
+}
+
+/* argument classes for the spec checks */
+template <class T>
+struct FmtArgKind {
+   typedef typename std::decay<T>::type D;
+   static constexpr int is_real = std::is_floating_point<D>::value ||
+                                  std::is_same<D, FmtFix>::value;
+   static constexpr int is_text = std::is_same<D, char>::value ||
+                                  std::is_same<D, const char *>::value ||
+                                  std::is_same<D, char *>::value;
+};
+
+/* no arguments left: literal after the last placeholder */
+template <class F, int K>
+inline char *fmt_args(char *p, char *end) {
+   constexpr int tail = fmt_tail(F::str());
+   constexpr int len = fmt_length(F::str());
+
+   return (fmt_copy(p, end, F::str() + tail, len - tail));
+}
+
+/* literal before placeholder K, then argument K */
+template <class F, int K, class T, class... R>
+inline char *fmt_args(char *p, char *end, const T &a, const R &... rest) {
+   constexpr FmtSpec sp = fmt_spec(F::str(), K);
+
+   static_assert(!(FmtArgKind<T>::is_real && sp.shift), "x/o/b spec on a real argument");
+   static_assert(!(FmtArgKind<T>::is_text && (sp.shift || sp.prec >= 0)),
+                 "numeric spec on a char/string argument");
+   static_assert(!(!FmtArgKind<T>::is_real && !FmtArgKind<T>::is_text && sp.prec >= 0),
+                 "precision on an integer argument");
+   p = fmt_copy(p, end, F::str() + sp.lit, sp.open - sp.lit);
+   p = fmt_put(p, end, sp, a);
+   return (fmt_args<F, K + 1>(p, end, rest...));
+}
+
+/**
+ * render a message into a buffer
+ * @param buf output (not terminated)
+ * @param size buffer size; longer output is truncated
+ * @param fmt FMT_STR("...")
+ * @return # chars written
+ *
+ */
+template <class F, class... A>
+inline int fmt_format(char *buf, int size, F fmt, const A &... args) {
+   static_assert(fmt_count(F::str()) >= 0, "malformed {} in format string");
+   static_assert(fmt_count(F::str()) == (int) sizeof...(A),
+                 "# of {} differs from # of arguments");
+   (void) fmt;
+   return ((int) (fmt_args<F, 0>(buf, buf + size, args...) - buf));
+}
+
+/**
+ * render a message on the stack and send it with one bulk uart call
+ * @param u uart core (e.g., "uart" of chu_init.h)
+ * @param fmt FMT_STR("...")
+ * @note output beyond FMT_BUF_SIZE chars is truncated
+ *
+ */
+template <class F, class... A>
+inline void fmt_print(UartCore &u, F fmt, const A &... args) {
+   char buf[FMT_BUF_SIZE];
+
+   u.disp_buf(buf, fmt_format(buf, FMT_BUF_SIZE, fmt, args...));
+}
+
+#endif  // _CHU_PRINT_H_INCLUDED
@@ -0,0 +1,103 @@
+/*****************************************************************//**
+ * @file chu_prof.cpp
+ *
+ * @brief implementation of scoped execution-time probes
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#include "chu_prof.h"
+#include "chu_report.h"
+
+extern TimerCore _sys_timer;   // chu_init.cpp
+
+static ProfProbe *list = 0;     // probes measured at least once
+
+uint32_t prof_tick() {
+   return (_sys_timer.read_tick32());
+}
+
+void prof_record(ProfProbe *probe, uint64_t clocks) {
+   int bin;
+   uint64_t c;
+
+   if (!probe->listed) {
+      probe->listed = 1;
+      probe->next = list;
+      list = probe;
+   }
+   if (probe->count == 0 || clocks < probe->min)
+      probe->min = clocks;
+   if (clocks > probe->max)
+      probe->max = clocks;
+   probe->total = probe->total + clocks;
+   probe->count++;
+   // bin = floor(log2(clocks)); 0 and 1 clock go to bin 0
+   bin = 0;
+   for (c = clocks >> 1; c != 0 && bin < PROF_N_BIN - 1; c = c >> 1)
+      bin++;
+   probe->hist[bin]++;
+}
+
+void prof_clear() {
+   ProfProbe *p;
+   int i;
+
+   for (p = list; p != 0; p = p->next) {
+      p->count = 0;
+      p->min = 0;
+      p->max = 0;
+      p->total = 0;
+      for (i = 0; i < PROF_N_BIN; i++)
+         p->hist[i] = 0;
+   }
+}
+
+void prof_report() {
+   ProfProbe *p;
+   uint32_t t0, ovh = 0;
+   int i, mode;
+
+   // overhead: min of empty regions
+   for (i = 0; i < 8; i++) {
+      t0 = prof_tick();
+      t0 = prof_tick() - t0;
+      if (i == 0 || t0 < ovh)
+         ovh = t0;
+   }
+   mode = report_begin();
+   report_str("profile (clocks; total in us)\n\r");
+   report_str("   count       min       avg       max     total  probe\n\r");
+   for (p = list; p != 0; p = p->next) {
+      if (p->count == 0)
+         continue;
+      report_num(p->count, 8);
+      report_num(p->min, 10);
+      report_num(p->total / p->count, 10);
+      report_num(p->max, 10);
+      report_num(p->total / SYS_CLK_FREQ, 10);
+      report_str("  ");
+      report_str(p->name);
+      report_str("\n\r");
+   }
+   report_str("histogram (log2 clocks: count)\n\r");
+   for (p = list; p != 0; p = p->next) {
+      if (p->count == 0)
+         continue;
+      report_str(p->name);
+      report_str(":");
+      for (i = 0; i < PROF_N_BIN; i++) {
+         if (p->hist[i]) {
+            report_num(i, 3);
+            report_str(":");
+            report_num(p->hist[i], 0);
+         }
+      }
+      report_str("\n\r");
+   }
+   report_str("probe overhead");
+   report_num(ovh, 6);
+   report_str("\n\r");
+   report_end(mode);
+}
@@ -0,0 +1,113 @@
+/*****************************************************************//**
+ * @file chu_prof.h
+ *
+ * @brief Scoped execution-time probes based on the system timer
+ *
+ * Detailed description:
+ *  - enabled by compiling with -D_PROF_USED; otherwise PROF_SCOPE(),
+ *    PROF_BEGIN() and PROF_END() expand to nothing
+ *  - a probe measures a code region in clocks with
+ *    TimerCore::read_tick32() of the system timer (slot 0); regions
+ *    must be shorter than 2^32 clocks (about 43 s)
+ *  - each probe keeps count/min/max/total and a log2 histogram
+ *    (bin k: 2^k to 2^(k+1)-1 clocks) in static storage; a probe is
+ *    added to the report list on its first measurement
+ *  - prof_report() prints the table over "uart" on target and to
+ *    stdout on host (_SIM_IO_ACCESS_USED)
+ *  - a measurement includes the probe overhead (1 timer read per
+ *    edge); the report shows the overhead of an empty region
+ *  - usage:
+ *      float getIntTempC(XadcCore *adc) {
+ *         PROF_SCOPE("getIntTempC");   // until end of the function
+ *         ...
+ *      }
+ *      PROF_BEGIN(loop_probe, "loop");
+ *      ...
+ *      PROF_END(loop_probe);
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _CHU_PROF_H_INCLUDED
+#define _CHU_PROF_H_INCLUDED
+
+#include "chu_io_rw.h"
+
+#define PROF_N_BIN 32         // log2 histogram bins (up to 2^32 clocks)
+#define PROF_CMD   'p'        // uart command to print the report
+
+/**
+ * probe statistics (static object, initialized with {name})
+ */
+typedef struct ProfProbe {
+   const char *name;
+   unsigned long count = 0;
+   uint64_t min = 0;              // valid when count > 0
+   uint64_t max = 0;
+   uint64_t total = 0;
+   unsigned long hist[PROF_N_BIN] = {};
+   struct ProfProbe *next = 0;    // report list
+   int listed = 0;
+} ProfProbe;
+
+/**
+ * lower 32 bits of the system timer count (clocks).
+ */
+uint32_t prof_tick();
+
+/**
+ * add a measurement to a probe.
+ * @param probe probe
+ * @param clocks measured # clocks
+ */
+void prof_record(ProfProbe *probe, uint64_t clocks);
+
+/**
+ * clear the statistics of all listed probes.
+ */
+void prof_clear();
+
+/**
+ * print count/min/avg/max/total and histogram of all listed probes.
+ */
+void prof_report();
+
+/**
+ * scope probe: measures from construction to destruction
+ */
+class ProfScope {
+public:
+   ProfScope(ProfProbe *p) {
+      probe = p;
+      start = prof_tick();
+   }
+   ~ProfScope() {
+      prof_record(probe, (uint32_t) (prof_tick() - start));
+   }
+private:
+   ProfProbe *probe;
+   uint32_t start;
+};
+
+#define PROF_CAT2(a, b) a##b
+#define PROF_CAT(a, b) PROF_CAT2(a, b)
+
+#ifdef _PROF_USED
+#define PROF_SCOPE(name) \
+   static ProfProbe PROF_CAT(prof_probe_, __LINE__) = {name}; \
+   ProfScope PROF_CAT(prof_scope_, __LINE__)(&PROF_CAT(prof_probe_, __LINE__))
+
+#define PROF_BEGIN(id, name) \
+   static ProfProbe id = {name}; \
+   uint32_t id##_start = prof_tick()
+
+#define PROF_END(id) \
+   prof_record(&id, (uint32_t) (prof_tick() - id##_start))
+#else
+#define PROF_SCOPE(name)
+#define PROF_BEGIN(id, name)
+#define PROF_END(id)
+#endif  // _PROF_USED
+
+#endif  // _CHU_PROF_H_INCLUDED
@@ -0,0 +1,90 @@
+/*****************************************************************//**
+ * @file chu_report.h
+ *
+ * @brief Text output shared by the diagnostic reports
+ *
+ * Detailed description:
+ *  - used by Scheduler::report(), prof_report() and io_stat_report()
+ *  - output goes to stdout on the host (_SIM_IO_ACCESS_USED) and to
+ *    the "uart" console of chu_init.h on the target
+ *  - numbers are unsigned 64-bit and converted with fmt_dec64()
+ *    (chu_fmt.h), so clock and tick totals above 2^31 print in full
+ *  - a report is longer than the uart tx buffer (UART_TX_BUF_SIZE), so
+ *    in TX_DROP mode its tail would be dropped; report_begin() switches
+ *    the console to TX_BLOCK (drain when full) until report_end()
+ *  - usage:
+ *      int mode = report_begin();
+ *      report_str("count");
+ *      report_num(n, 8);
+ *      report_end(mode);
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _CHU_REPORT_H_INCLUDED
+#define _CHU_REPORT_H_INCLUDED
+
+#include "chu_init.h"
+#include "chu_fmt.h"
+#ifdef _SIM_IO_ACCESS_USED
+#include <stdio.h>
+#endif
+
+/**
+ * start a multi-line report
+ * @return tx mode to restore with report_end()
+ * @note TX_DIRECT already busy-waits and is kept
+ *
+ */
+inline int report_begin() {
+   int mode = uart.get_tx_mode();
+
+   if (mode == UartCore::TX_DROP)
+      uart.set_tx_mode(UartCore::TX_BLOCK);
+   return (mode);
+}
+
+/**
+ * end a multi-line report
+ * @param mode return value of report_begin()
+ *
+ */
+inline void report_end(int mode) {
+   uart.set_tx_mode(mode);
+}
+
+/**
+ * print a string
+ * @param str string
+ *
+ */
+inline void report_str(const char *str) {
+#ifdef _SIM_IO_ACCESS_USED
+   fputs(str, stdout);
+#else
+   uart.disp(str);
+#endif
+}
+
+/**
+ * print an unsigned number in base 10
+ * @param n number
+ * @param len minimum width, padded with leading blanks (0: no padding)
+ *
+ */
+inline void report_num(uint64_t n, int len) {
+   char buf[65];         // 20 digits; blanks up to len 64; '\0'
+   char *end, *str;
+
+   if (len > 64)
+      len = 64;
+   end = &buf[64];
+   *end = '\0';
+   str = fmt_dec64(end, n);
+   while (end - str < len)
+      *--str = ' ';
+   report_str(str);
+}
+
+#endif  // _CHU_REPORT_H_INCLUDED
@@ -0,0 +1,196 @@
+/*****************************************************************//**
+ * @file chu_sched.cpp
+ *
+ * @brief implementation of the cooperative task scheduler
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#include "chu_sched.h"
+#include "chu_report.h"
+
+Scheduler::Scheduler() {
+   list = 0;
+   n_task = 0;
+   wdt = 0;
+   idle = 1;
+   busy_start = 0;
+   busy_max_clk = 0;
+   worst = 0;
+   worst_late_clk = 0;
+}
+
+void Scheduler::add(SchedTask *task) {
+   SchedTask *p;
+
+   if (task->deadline == 0)
+      task->deadline = task->period;
+   task->st.release = now_tick() + task->offset;
+   task->st.id = ++n_task;
+   task->st.next = 0;
+   // append: equal deadlines run in the order added
+   if (list == 0) {
+      list = task;
+   } else {
+      for (p = list; p->st.next != 0; p = p->st.next) {
+      }
+      p->st.next = task;
+   }
+}
+
+void Scheduler::finish(SchedTask *task, uint64_t start, uint64_t end) {
+   uint64_t jitter, exec;
+
+   jitter = start - task->st.release;
+   exec = end - start;
+   task->st.runs++;
+   task->st.jitter_total = task->st.jitter_total + jitter;
+   if (jitter > task->st.jitter_max)
+      task->st.jitter_max = (uint32_t) jitter;
+   task->st.exec_total = task->st.exec_total + exec;
+   if (exec > task->st.exec_max)
+      task->st.exec_max = (uint32_t) exec;
+   if (end - task->st.release > task->deadline) {
+      task->st.overruns++;
+      // deadline monitor: report each new worst overrun
+      if (end - task->st.release - task->deadline > worst_late_clk) {
+         worst = task;
+         worst_late_clk = (uint32_t) (end - task->st.release - task->deadline);
+         report_str("deadline miss: ");
+         report_str(task->name);
+         report_str(" late");
+         report_num(TimerCore::tick2us(worst_late_clk), 8);
+         report_str(" us\n\r");
+      }
+   }
+   // next release on the grid; drop releases whose deadline has passed
+   task->st.release = task->st.release + task->period;
+   while (task->st.release + task->deadline <= end) {
+      task->st.release = task->st.release + task->period;
+      task->st.skipped++;
+   }
+}
+
+int Scheduler::run_once() {
+   SchedTask *p, *best = 0;
+   uint64_t now, end;
+
+   now = now_tick();
+   for (p = list; p != 0; p = p->st.next) {
+      if (p->st.release > now)
+         continue;
+      if (best == 0 || p->st.release + p->deadline < best->st.release + best->deadline)
+         best = p;
+   }
+   if (best == 0)
+      return (0);
+   if (idle) {
+      busy_start = now;
+      idle = 0;
+   }
+   if (wdt)
+      wdt->kick(best->st.id);
+   best->func(best->arg);
+   end = now_tick();
+   finish(best, now, end);
+   if (end - busy_start > busy_max_clk)
+      busy_max_clk = (uint32_t) (end - busy_start);
+   return (1);
+}
+
+uint64_t Scheduler::next_release() {
+   SchedTask *p;
+   uint64_t next = ~0ULL;
+
+   for (p = list; p != 0; p = p->st.next) {
+      if (p->st.release < next)
+         next = p->st.release;
+   }
+   return (next);
+}
+
+void Scheduler::run_until(uint64_t end) {
+   uint64_t next;
+
+   while (now_tick() < end) {
+      if (run_once())
+         continue;
+      next = next_release();
+      idle = 1;
+      if (wdt)
+         wdt->kick(0);
+      sleep_until_tick((next < end) ? next : end);
+   }
+}
+
+void Scheduler::run() {
+   while (1) {
+      run_until(~0ULL);
+   }
+}
+
+void Scheduler::clear_stats() {
+   SchedTask *p;
+
+   for (p = list; p != 0; p = p->st.next) {
+      p->st.runs = 0;
+      p->st.overruns = 0;
+      p->st.skipped = 0;
+      p->st.jitter_max = 0;
+      p->st.jitter_total = 0;
+      p->st.exec_max = 0;
+      p->st.exec_total = 0;
+   }
+   busy_max_clk = 0;
+   worst = 0;
+   worst_late_clk = 0;
+}
+
+void Scheduler::set_watchdog(WdtCore *wdt_p) {
+   wdt = wdt_p;
+}
+
+const char *Scheduler::task_name(int id) {
+   SchedTask *p;
+
+   if (id == 0)
+      return ("idle");
+   for (p = list; p != 0; p = p->st.next) {
+      if (p->st.id == id)
+         return (p->name);
+   }
+   return ("?");
+}
+
+void Scheduler::report() {
+   SchedTask *p;
+   int mode;
+
+   mode = report_begin();
+   report_str("tasks (jitter/exec in us)\n\r");
+   report_str("    runs overrun skipped jit_avg jit_max exe_avg exe_max  task\n\r");
+   for (p = list; p != 0; p = p->st.next) {
+      report_num(p->st.runs, 8);
+      report_num(p->st.overruns, 8);
+      report_num(p->st.skipped, 8);
+      report_num(p->st.runs ? TimerCore::tick2us(p->st.jitter_total / p->st.runs) : 0, 8);
+      report_num(TimerCore::tick2us(p->st.jitter_max), 8);
+      report_num(p->st.runs ? TimerCore::tick2us(p->st.exec_total / p->st.runs) : 0, 8);
+      report_num(TimerCore::tick2us(p->st.exec_max), 8);
+      report_str("  ");
+      report_str(p->name);
+      report_str("\n\r");
+   }
+   report_str("longest busy stretch (us)");
+   report_num(TimerCore::tick2us(busy_max_clk), 8);
+   report_str("\n\r");
+   if (worst) {
+      report_str("worst overrun (us)");
+      report_num(TimerCore::tick2us(worst_late_clk), 8);
+      report_str("  ");
+      report_str(worst->name);
+      report_str("\n\r");
+   }
+   report_end(mode);
+}
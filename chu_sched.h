@@ -0,0 +1,184 @@
+/*****************************************************************//**
+ * @file chu_sched.h
+ *
+ * @brief Cooperative periodic task scheduler based on the system timer
+ *
+ * Detailed description:
+ *  - run-to-completion tasks: a task function returns before the next
+ *    task starts; no preemption, no stack per task
+ *  - each task has a period, a relative deadline (0: the period) and
+ *    an offset of its first release; all in clocks (use
+ *    TimerCore::ms2tick()/us2tick())
+ *  - releases are kept on the absolute grid start + offset + k*period,
+ *    so the period does not drift with the execution time of the tasks
+ *  - among the released tasks the one with the earliest absolute
+ *    deadline runs first (EDF); with no released task the scheduler
+ *    idles on the timer alarm until the next release
+ *  - a release whose deadline passed before the task could run again
+ *    is skipped (counted) instead of being run late in a burst
+ *  - per-task statistics: runs, overruns (finished after the deadline),
+ *    skipped releases, release jitter (start - release) and execution
+ *    time; report() prints them over "uart" on target and to stdout on
+ *    host (_SIM_IO_ACCESS_USED)
+ *  - deadline monitor: the longest busy stretch (tasks run back to back
+ *    without idling) and the worst overrun with its task; a new worst
+ *    overrun is printed when it happens
+ *  - with a watchdog (set_watchdog()) the scheduler kicks it before each
+ *    task with the task id as tag (0 before idling); after a watchdog
+ *    reset, task_name(wdt.tag()) names the task that hung; the cost is
+ *    one bus write per task run and per idle
+ *  - usage:
+ *      void blink(void *arg) { ... }
+ *      SchedTask blink_task = {"blink", blink, 0, TimerCore::ms2tick(500)};
+ *      Scheduler sched;
+ *      sched.add(&blink_task);
+ *      sched.run();       // never returns
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _CHU_SCHED_H_INCLUDED
+#define _CHU_SCHED_H_INCLUDED
+
+#include "chu_init.h"
+#include "wdt_core.h"
+
+#define SCHED_CMD 's'         // uart command to print the report
+
+typedef void (*SchedFunc)(void *arg);
+
+struct SchedTask;
+
+/**
+ * per-task state and statistics, maintained by the scheduler
+ */
+typedef struct SchedState {
+   uint64_t release = 0;          // next release (absolute tick)
+   int id = 0;                    // 1, 2, ... in order added
+   struct SchedTask *next = 0;
+   // statistics
+   unsigned long runs = 0;
+   unsigned long overruns = 0;    // finished after release + deadline
+   unsigned long skipped = 0;     // releases dropped after a long overrun
+   uint32_t jitter_max = 0;       // start - release, clocks
+   uint64_t jitter_total = 0;
+   uint32_t exec_max = 0;         // clocks
+   uint64_t exec_total = 0;
+} SchedState;
+
+/**
+ * task descriptor (static object): {name, func, arg, period} or
+ * {name, func, arg, period, deadline, offset}
+ */
+typedef struct SchedTask {
+   const char *name;
+   SchedFunc func;
+   void *arg;                     // passed to func
+   uint64_t period;               // clocks
+   uint64_t deadline = 0;         // clocks after release; 0: period
+   uint64_t offset = 0;           // first release, clocks after add()
+   SchedState st = {};            // scheduler only
+} SchedTask;
+
+/**
+ * cooperative scheduler
+ */
+class Scheduler {
+public:
+   /**
+    * constructor.
+    *
+    */
+   Scheduler();
+
+   /**
+    * add a task; its first release is now + task->offset
+    * @param task task descriptor (must stay valid)
+    *
+    */
+   void add(SchedTask *task);
+
+   /**
+    * run the released task with the earliest deadline, if any
+    * @return 1 if a task ran; 0 if no task was released
+    *
+    */
+   int run_once();
+
+   /**
+    * run tasks and idle between releases until the time reaches end
+    * @param end absolute tick (now_tick())
+    *
+    */
+   void run_until(uint64_t end);
+
+   /**
+    * run tasks forever
+    *
+    */
+   void run();
+
+   /**
+    * earliest next release of all tasks (absolute tick)
+    *
+    */
+   uint64_t next_release();
+
+   /**
+    * clear the statistics of all tasks
+    *
+    */
+   void clear_stats();
+
+   /**
+    * print runs/overruns/skipped, jitter and execution time (us) of
+    * all tasks, the longest busy stretch and the worst overrun
+    *
+    */
+   void report();
+
+   /**
+    * kick a watchdog before each task (tag: task id; 0 when idle)
+    * @param wdt started watchdog; its timeout must exceed the longest
+    *        task plus the longest idle gap (the shortest period)
+    *
+    */
+   void set_watchdog(WdtCore *wdt_p);
+
+   /**
+    * name of a task
+    * @param id task id (e.g., WdtCore::tag() after a watchdog reset)
+    * @return task name; "idle" for 0; "?" if unknown
+    *
+    */
+   const char *task_name(int id);
+
+   /** longest busy stretch (clocks) */
+   uint32_t busy_max() {
+      return (busy_max_clk);
+   }
+
+   /** task of the worst overrun (0 if none) */
+   SchedTask *worst_task() {
+      return (worst);
+   }
+
+   /** worst overrun: clocks finished after the deadline */
+   uint32_t worst_late() {
+      return (worst_late_clk);
+   }
+
+private:
+   SchedTask *list;
+   int n_task;
+   WdtCore *wdt;
+   int idle;                  // last pass found no released task
+   uint64_t busy_start;
+   uint32_t busy_max_clk;
+   SchedTask *worst;
+   uint32_t worst_late_clk;
+   void finish(SchedTask *task, uint64_t start, uint64_t end);
+};
+
+#endif  // _CHU_SCHED_H_INCLUDED
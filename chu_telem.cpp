@@ -0,0 +1,22 @@
+/*****************************************************************//**
+ * @file chu_telem.cpp
+ *
+ * @brief implementation of the telemetry send
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#include "chu_telem.h"
+#include "chu_init.h"
+
+static uint8_t telem_seq = 0;
+
+void telem_send(const TelemSample *s, int n) {
+   uint8_t buf[TELEM_FRAME_MAX];
+   int len;
+
+   len = telem_encode(buf, telem_seq, (uint32_t) now_us(), s, n);
+   telem_seq++;
+   uart.disp_buf((const char *) buf, len);
+}
@@ -0,0 +1,218 @@
+/*****************************************************************//**
+ * @file chu_telem.h
+ *
+ * @brief Framed binary telemetry: frame codec and uart send
+ *
+ * Detailed description:
+ *  - a frame carries one or more fixed-point samples taken together:
+ *    about 8 bytes per sample on the wire (2 samples: 15 bytes) vs
+ *    about 22 for a text line such as "FPGA temp: 45.123\n\r"
+ *  - payload (little-endian):
+ *      seq (u8)          +1 per frame sent; a gap means lost frames
+ *      time (u32)        now_us() when sent, lower 32 bits
+ *      n x sample        ch (u8): id << 4 | frac_bits
+ *                        value (i16): v / 2^frac_bits
+ *      crc (u16)         CRC-16/CCITT-FALSE of all preceding bytes
+ *  - framing: COBS (consistent overhead byte stuffing) of the payload,
+ *    then a 0x00 delimiter; the frame contains no other 0x00, so a
+ *    receiver resynchronizes at the next delimiter
+ *  - the codec (inline, no uart access) is shared by the target and
+ *    the host decoder telem_decode.cpp
+ *  - telem_send() (chu_telem.cpp) encodes a frame on the stack and
+ *    sends it with one UartCore::disp_buf() call
+ *  - usage:
+ *      TelemSample s[2] = {{TELEM_CH_FPGA_TEMP, 6, t_q6},
+ *                          {TELEM_CH_EXT_TEMP, 4, code}};
+ *      telem_send(s, 2);
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _CHU_TELEM_H_INCLUDED
+#define _CHU_TELEM_H_INCLUDED
+
+#include <stdint.h>
+
+#define TELEM_CMD           'b'   // uart command: text/binary toggle
+#define TELEM_MAX_SAMPLES   8     // samples per frame
+#define TELEM_PAYLOAD_MAX   (5 + 3 * TELEM_MAX_SAMPLES + 2)
+// COBS adds 1 byte per 254 (payload < 254: 1), plus the delimiter
+#define TELEM_FRAME_MAX     (TELEM_PAYLOAD_MAX + 2)
+
+// channel ids (4 bits)
+#define TELEM_CH_FPGA_TEMP  1     // XADC die temperature, Celsius
+#define TELEM_CH_EXT_TEMP   2     // ADT7420 temperature, Celsius
+
+/**
+ * sample: value v / 2^frac_bits of channel ch; v is saturated to
+ * 16 bits when encoded
+ */
+typedef struct {
+   int ch;           // 0 to 15
+   int frac_bits;    // 0 to 15
+   int32_t v;
+} TelemSample;
+
+/**
+ * decoded frame
+ */
+typedef struct {
+   uint8_t seq;
+   uint32_t time_us;
+   int n;
+   TelemSample s[TELEM_MAX_SAMPLES];
+} TelemFrame;
+
+/**
+ * CRC-16/CCITT-FALSE (poly 0x1021, init 0xffff); 4-bit table
+ * @param crc 0xffff for a new message
+ *
+ */
+inline uint16_t telem_crc16(const uint8_t *p, int n, uint16_t crc) {
+   static const uint16_t tab[16] = {
+         0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+         0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef};
+   int i;
+
+   for (i = 0; i < n; i++) {
+      crc = (uint16_t) (crc << 4) ^ tab[(crc >> 12) ^ (p[i] >> 4)];
+      crc = (uint16_t) (crc << 4) ^ tab[(crc >> 12) ^ (p[i] & 0x0f)];
+   }
+   return (crc);
+}
+
+/**
+ * COBS encode (no delimiter)
+ * @param dst n + n/254 + 1 bytes
+ * @return # bytes written
+ *
+ */
+inline int telem_cobs_encode(const uint8_t *src, int n, uint8_t *dst) {
+   int i, code_pos = 0, len = 1;
+   uint8_t code = 1;
+
+   for (i = 0; i < n; i++) {
+      if (src[i] == 0) {
+         dst[code_pos] = code;
+         code_pos = len++;
+         code = 1;
+      } else {
+         dst[len++] = src[i];
+         code++;
+         if (code == 0xff) {
+            dst[code_pos] = code;
+            code_pos = len++;
+            code = 1;
+         }
+      }
+   }
+   dst[code_pos] = code;
+   return (len);
+}
+
+/**
+ * COBS decode one frame (delimiter removed)
+ * @param dst n bytes
+ * @return # bytes written; -1 if malformed
+ *
+ */
+inline int telem_cobs_decode(const uint8_t *src, int n, uint8_t *dst) {
+   int i = 0, len = 0, k;
+   uint8_t code;
+
+   while (i < n) {
+      code = src[i++];
+      if (code == 0)
+         return (-1);
+      for (k = 1; k < code; k++) {
+         if (i >= n || src[i] == 0)
+            return (-1);
+         dst[len++] = src[i++];
+      }
+      if (code != 0xff && i < n)
+         dst[len++] = 0;
+   }
+   return (len);
+}
+
+/**
+ * build a frame
+ * @param out TELEM_FRAME_MAX bytes
+ * @param n # samples (1 to TELEM_MAX_SAMPLES)
+ * @return # bytes including the delimiter
+ *
+ */
+inline int telem_encode(uint8_t *out, uint8_t seq, uint32_t time_us, const TelemSample *s,
+                        int n) {
+   uint8_t pl[TELEM_PAYLOAD_MAX];
+   int i, len;
+   int32_t v;
+   uint16_t crc;
+
+   if (n > TELEM_MAX_SAMPLES)
+      n = TELEM_MAX_SAMPLES;
+   pl[0] = seq;
+   for (i = 0; i < 4; i++)
+      pl[1 + i] = (uint8_t) (time_us >> (8 * i));
+   len = 5;
+   for (i = 0; i < n; i++) {
+      v = s[i].v;
+      if (v > 32767)
+         v = 32767;
+      if (v < -32768)
+         v = -32768;
+      pl[len] = (uint8_t) ((s[i].ch & 0x0f) << 4 | (s[i].frac_bits & 0x0f));
+      pl[len + 1] = (uint8_t) v;
+      pl[len + 2] = (uint8_t) (v >> 8);
+      len = len + 3;
+   }
+   crc = telem_crc16(pl, len, 0xffff);
+   pl[len] = (uint8_t) crc;
+   pl[len + 1] = (uint8_t) (crc >> 8);
+   len = telem_cobs_encode(pl, len + 2, out);
+   out[len] = 0;
+   return (len + 1);
+}
+
+/**
+ * decode and check a frame
+ * @param in frame bytes without the delimiter
+ * @return 0 if ok; -1 if malformed (COBS, length or crc)
+ *
+ */
+inline int telem_decode(const uint8_t *in, int n, TelemFrame *f) {
+   uint8_t pl[TELEM_FRAME_MAX];
+   int i, len;
+
+   if (n > TELEM_FRAME_MAX)
+      return (-1);
+   len = telem_cobs_decode(in, n, pl);
+   if (len < 5 + 3 + 2 || (len - 7) % 3 != 0)
+      return (-1);
+   if (telem_crc16(pl, len - 2, 0xffff) != (uint16_t) (pl[len - 2] | pl[len - 1] << 8))
+      return (-1);
+   f->seq = pl[0];
+   f->time_us = 0;
+   for (i = 0; i < 4; i++)
+      f->time_us = f->time_us | (uint32_t) pl[1 + i] << (8 * i);
+   f->n = (len - 7) / 3;
+   for (i = 0; i < f->n; i++) {
+      f->s[i].ch = pl[5 + 3 * i] >> 4;
+      f->s[i].frac_bits = pl[5 + 3 * i] & 0x0f;
+      f->s[i].v = (int16_t) (pl[6 + 3 * i] | pl[7 + 3 * i] << 8);
+   }
+   return (0);
+}
+
+/**
+ * send a frame of samples over "uart" (the next sequence number and
+ * the current time)
+ * @param n # samples (1 to TELEM_MAX_SAMPLES)
+ * @note in UartCore::TX_DROP mode a frame that does not fit is dropped
+ *       whole (the decoder sees a sequence gap)
+ *
+ */
+void telem_send(const TelemSample *s, int n);
+
+#endif  // _CHU_TELEM_H_INCLUDED
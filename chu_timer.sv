@@ -1,10 +1,25 @@
 //  * Reg map;
-//    * 00: read (32 LSB of counter)
-//    * 01: read (16 MSB of counter)
-//    * 10: control register: 
+//    * 00: read (32 LSB of counter); latches the 16 MSB
+//    * 01: read (16 MSB of counter as latched by the last 00 read)
+//    * 10: write: control register: 
 //        bit 0: go/pause
 //        bit 1: clear (no memory, just used to generate a 1-clock pulse)
+//        bit 2: alarm interrupt enable
+//    * 10: read: status register:
+//        bit 0: match (sticky; counter reached compare value while armed)
+//        bit 1: armed
+//    * 11: write: lower 32 bits of compare value; disarms, clears match
+//    * 100: write: bit 15-0: upper 16 bits of compare value;
+//        bit 16: arm (0: disarm); clears match
 //  * 48-bit counter (up to 65 days)
+//  * reading 00 then 01 returns one 48-bit snapshot even if the lower
+//    word carries between the two reads
+//  * alarm: write 11 then 100 (arm=1); match is set when the counter
+//    reaches the compare value (>= comparison, so a deadline already
+//    passed matches at once); irq = match & interrupt enable
+//  * offsets/bits from chu_io_map.svh (generated from chu_io_map.def)
+
+`include "chu_io_map.svh"
 
 module chu_timer
    (
@@ -16,13 +31,18 @@ module chu_timer
     input  logic write,
     input  logic [4:0] addr,
     input  logic [31:0] wr_data,
-    output logic [31:0] rd_data
+    output logic [31:0] rd_data,
+    // alarm interrupt (level)
+    output logic irq
    );
    
    // signal declaration
    logic [47:0] count_reg;
-   logic ctrl_reg;
-   logic wr_en, clear, go;
+   logic [15:0] upper_reg;
+   logic [47:0] cmp_reg;
+   logic [1:0] ctrl_reg;
+   logic armed_reg, match_reg;
+   logic wr_en, wr_cmp_lower, wr_cmp_upper, rd_lower, clear, go, ie;
    
    //***************************************************************
    // counter
@@ -45,13 +65,49 @@ module chu_timer
          ctrl_reg <= 0;
       else   
          if (wr_en)
-            ctrl_reg <= wr_data[0];
+            ctrl_reg <= {wr_data[`TIMER_IE_LSB], wr_data[`TIMER_GO_LSB]};
+   // upper 16 bits latched in the clock the lower 32 bits are read
+   always_ff @(posedge clk, posedge reset)
+      if (reset)
+         upper_reg <= 0;
+      else   
+         if (rd_lower)
+            upper_reg <= count_reg[47:32];
+   // compare value, arm and sticky match flag
+   always_ff @(posedge clk, posedge reset)
+      if (reset) begin
+         cmp_reg <= 0;
+         armed_reg <= 1'b0;
+         match_reg <= 1'b0;
+      end
+      else begin
+         if (wr_cmp_lower) begin
+            cmp_reg[31:0] <= wr_data;
+            armed_reg <= 1'b0;
+         end
+         if (wr_cmp_upper) begin
+            cmp_reg[47:32] <= wr_data[`TIMER_CMP_UPPER_MSB:`TIMER_CMP_UPPER_LSB];
+            armed_reg <= wr_data[`TIMER_ARM_LSB];
+         end
+         if (wr_cmp_lower || wr_cmp_upper)
+            match_reg <= 1'b0;
+         else if (armed_reg && (count_reg >= cmp_reg))
+            match_reg <= 1'b1;
+      end
    // decoding logic
-   assign wr_en = write && cs && (addr[1:0]==2'b10);
-   assign clear = wr_en && wr_data[1];
-   assign go    = ctrl_reg;
+   assign wr_en = write && cs && (addr[2:0]==`TIMER_CTRL_REG);
+   assign wr_cmp_lower = write && cs && (addr[2:0]==`TIMER_CMP_LOWER_REG);
+   assign wr_cmp_upper = write && cs && (addr[2:0]==`TIMER_CMP_UPPER_REG);
+   assign rd_lower = read && cs && (addr[1:0]==`TIMER_COUNTER_LOWER_REG);
+   assign clear = wr_en && wr_data[`TIMER_CLR_LSB];
+   assign go    = ctrl_reg[0];
+   assign ie    = ctrl_reg[1];
+   assign irq   = match_reg && ie;
    // slot read interface
-   assign rd_data = (addr[0]==0)?
-                    count_reg[31:0]:
-                    {16'h0000, count_reg[47:32]};
+   always_comb
+      case (addr[1:0])
+         `TIMER_COUNTER_UPPER_REG: rd_data = {16'h0000, upper_reg};
+         `TIMER_STATUS_REG: rd_data = {30'h0, armed_reg, match_reg};
+         default: rd_data = count_reg[31:0];
+      endcase
 endmodule
@@ -0,0 +1,216 @@
+/*****************************************************************//**
+ * @file chu_twheel.cpp
+ *
+ * @brief implementation of the timer wheel
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#include <stddef.h>
+#include "chu_twheel.h"
+
+extern TimerCore _sys_timer;   // chu_init.cpp
+
+#define TW_MASK (TW_N_SLOT - 1)
+
+/* timer containing a list link */
+static TwTimer *entry(TwLink *l) {
+   return ((TwTimer *) ((char *) l - offsetof(TwTimer, link)));
+}
+
+static void link_init(TwLink *head) {
+   head->next = head;
+   head->prev = head;
+}
+
+static void link_add(TwLink *head, TwLink *l) {
+   l->next = head;
+   l->prev = head->prev;
+   head->prev->next = l;
+   head->prev = l;
+}
+
+static void link_del(TwLink *l) {
+   l->prev->next = l->next;
+   l->next->prev = l->prev;
+   l->next = l;
+   l->prev = l;
+}
+
+/* move all entries of src to the (empty) list dst */
+static void link_move(TwLink *src, TwLink *dst) {
+   if (src->next == src) {
+      link_init(dst);
+      return;
+   }
+   dst->next = src->next;
+   dst->prev = src->prev;
+   dst->next->prev = dst;
+   dst->prev->next = dst;
+   link_init(src);
+}
+
+TimerWheel::TimerWheel() {
+   int l, i;
+
+   for (l = 0; l < TW_LEVELS; l++)
+      for (i = 0; i < TW_N_SLOT; i++)
+         link_init(&slot[l][i]);
+   cur = 0;
+   now_est = 0;
+   n_pending = 0;
+   init = 0;
+}
+
+// one bus read: lower 32 bits of the timer extended with the last value
+uint64_t TimerWheel::read_now() {
+   uint32_t now32;
+
+   if (!init) {
+      now_est = now_tick();
+      cur = now_est >> TW_GRAN_BIT;
+      init = 1;
+   } else {
+      now32 = _sys_timer.read_tick32();
+      now_est = now_est + (uint32_t) (now32 - (uint32_t) now_est);
+   }
+   return (now_est);
+}
+
+// level by distance from the current granule; expiry rounded up to a
+// granule so a timer never fires early; min_gran: cur during a cascade
+// (slot cur is fired next), cur + 1 otherwise
+void TimerWheel::insert(TwTimer *t, uint64_t min_gran) {
+   uint64_t gran, delta;
+   int level, idx;
+
+   gran = (t->expire + (1ULL << TW_GRAN_BIT) - 1) >> TW_GRAN_BIT;
+   if (gran < min_gran)
+      gran = min_gran;
+   delta = gran - cur;
+   for (level = 0; level < TW_LEVELS - 1; level++) {
+      if (delta < (1ULL << (TW_SLOT_BIT * (level + 1))))
+         break;
+   }
+   if (delta >= (1ULL << (TW_SLOT_BIT * TW_LEVELS)))
+      gran = cur + (1ULL << (TW_SLOT_BIT * TW_LEVELS)) - 1;   // re-placed on cascade
+   idx = (int) (gran >> (TW_SLOT_BIT * level)) & TW_MASK;
+   link_add(&slot[level][idx], &t->link);
+}
+
+void TimerWheel::start(TwTimer *t, uint64_t delay, uint64_t period) {
+   start_at(t, read_now() + delay, period);
+}
+
+void TimerWheel::start_at(TwTimer *t, uint64_t tick, uint64_t period) {
+   if (!init)
+      read_now();
+   cancel(t);
+   t->expire = tick;
+   t->period = period;
+   t->pending = 1;
+   n_pending++;
+   insert(t, cur + 1);
+}
+
+void TimerWheel::cancel(TwTimer *t) {
+   if (!t->pending)
+      return;
+   link_del(&t->link);
+   t->pending = 0;
+   n_pending--;
+}
+
+// re-insert the timers of a higher-level slot one level down (or lower)
+void TimerWheel::cascade(int level, int idx) {
+   TwLink list, *l;
+
+   link_move(&slot[level][idx], &list);
+   while (list.next != &list) {
+      l = list.next;
+      link_del(l);
+      insert(entry(l), cur);
+   }
+}
+
+// run the timers of level 0 slot idx (all expire in granule cur)
+int TimerWheel::fire(int idx) {
+   TwLink list, *l;
+   TwTimer *t;
+   int n = 0;
+
+   // detached first: callbacks may start/cancel timers
+   link_move(&slot[0][idx], &list);
+   while (list.next != &list) {
+      l = list.next;
+      link_del(l);
+      t = entry(l);
+      if (t->period) {
+         t->expire = t->expire + t->period;
+         insert(t, cur + 1);
+      } else {
+         t->pending = 0;
+         n_pending--;
+      }
+      t->func(t->arg);
+      n++;
+   }
+   return (n);
+}
+
+int TimerWheel::service(uint64_t now) {
+   uint64_t target;
+   int level, idx, n = 0;
+
+   if (!init) {
+      cur = now >> TW_GRAN_BIT;
+      init = 1;
+   }
+   now_est = now;
+   target = now >> TW_GRAN_BIT;
+   while (cur < target) {
+      if (n_pending == 0) {
+         cur = target;
+         break;
+      }
+      cur++;
+      idx = (int) cur & TW_MASK;
+      if (idx == 0) {
+         for (level = 1; level < TW_LEVELS; level++) {
+            idx = (int) (cur >> (TW_SLOT_BIT * level)) & TW_MASK;
+            cascade(level, idx);
+            if (idx != 0)
+               break;
+         }
+         idx = 0;
+      }
+      n = n + fire(idx);
+   }
+   return (n);
+}
+
+int TimerWheel::poll() {
+   return (service(read_now()));
+}
+
+uint64_t TimerWheel::next_tick() {
+   uint64_t best = ~0ULL;
+   TwLink *l, *head;
+   int level, i, idx;
+
+   for (level = 0; level < TW_LEVELS; level++) {
+      idx = (int) (cur >> (TW_SLOT_BIT * level)) & TW_MASK;
+      for (i = 1; i <= TW_N_SLOT; i++) {
+         head = &slot[level][(idx + i) & TW_MASK];
+         if (head->next == head)
+            continue;
+         for (l = head->next; l != head; l = l->next) {
+            if (entry(l)->expire < best)
+               best = entry(l)->expire;
+         }
+         break;
+      }
+   }
+   return (best);
+}
@@ -0,0 +1,151 @@
+/*****************************************************************//**
+ * @file chu_twheel.h
+ *
+ * @brief Software timers multiplexed on the system timer (timer wheel)
+ *
+ * Detailed description:
+ *  - one-shot and periodic callbacks; any number of timers share the
+ *    slot-0 system timer
+ *  - hierarchical wheel: TW_LEVELS levels of 2^TW_SLOT_BIT slots; level
+ *    0 slots are one granule (2^TW_GRAN_BIT clocks) wide, each higher
+ *    level 2^TW_SLOT_BIT times wider; timers of a higher level move
+ *    down (cascade) when the lower level wraps
+ *  - start/cancel are O(1) (intrusive doubly-linked slot lists)
+ *  - poll() makes one bus read (lower 32 bits of the timer, extended in
+ *    software) and runs the expired callbacks; it must be called at
+ *    least every 2^32 clocks (about 43 s); service() does the same with
+ *    a time the caller already has (e.g., after a timer alarm)
+ *  - a callback never runs early; it runs at the first service pass
+ *    in the granule after its expiry (late by up to one granule plus
+ *    the polling interval)
+ *  - a periodic timer keeps its grid (expiry += period); a period
+ *    shorter than a granule fires at most once per granule
+ *  - callbacks run from poll()/service() and may start or cancel any
+ *    timer, including their own
+ *  - usage:
+ *      void blink(void *arg) { ... }
+ *      TwTimer blink_tmr = {blink, 0};
+ *      TimerWheel wheel;
+ *      wheel.start(&blink_tmr, TimerCore::ms2tick(500), TimerCore::ms2tick(500));
+ *      while (1) {
+ *         wheel.poll();
+ *         ...
+ *      }
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _CHU_TWHEEL_H_INCLUDED
+#define _CHU_TWHEEL_H_INCLUDED
+
+#include "chu_init.h"
+
+#ifndef TW_GRAN_BIT
+#define TW_GRAN_BIT 16        // granule: 2^16 clocks (655 us at 100 MHz)
+#endif
+#define TW_SLOT_BIT 6         // 64 slots per level
+#define TW_LEVELS   4         // range 2^24 granules (about 3 hours)
+#define TW_N_SLOT   (1 << TW_SLOT_BIT)
+
+typedef void (*TwFunc)(void *arg);
+
+/**
+ * list link; slot heads are sentinels of circular lists
+ */
+typedef struct TwLink {
+   struct TwLink *next;
+   struct TwLink *prev;
+} TwLink;
+
+/**
+ * software timer (set func and arg; the rest is maintained by the wheel)
+ */
+typedef struct TwTimer {
+   TwFunc func;
+   void *arg;                 // passed to func
+   // state
+   TwLink link;               // slot list
+   uint64_t expire;           // absolute tick
+   uint64_t period;           // clocks; 0 for one-shot
+   int pending;
+} TwTimer;
+
+/**
+ * timer wheel
+ */
+class TimerWheel {
+public:
+   /**
+    * constructor.
+    * @note no bus access; the time base is read on first use
+    *
+    */
+   TimerWheel();
+
+   /**
+    * start (or restart) a timer
+    * @param t timer (must stay valid while pending)
+    * @param delay clocks from now to the first expiry
+    * @param period clocks between expiries; 0 for one-shot
+    *
+    */
+   void start(TwTimer *t, uint64_t delay, uint64_t period = 0);
+
+   /**
+    * start (or restart) a timer at an absolute time
+    * @param t timer
+    * @param tick absolute expiry (now_tick() time base)
+    * @param period clocks between expiries; 0 for one-shot
+    * @note no bus access once the wheel has read the time base
+    *
+    */
+   void start_at(TwTimer *t, uint64_t tick, uint64_t period = 0);
+
+   /**
+    * cancel a timer (no effect if not pending)
+    *
+    */
+   void cancel(TwTimer *t);
+
+   /**
+    * read the timer once and run the expired callbacks
+    * @return # callbacks run
+    *
+    */
+   int poll();
+
+   /**
+    * run the callbacks expired at a given time (no bus access)
+    * @param now absolute tick (now_tick() time base)
+    * @return # callbacks run
+    *
+    */
+   int service(uint64_t now);
+
+   /**
+    * earliest expiry of the pending timers
+    * @return absolute tick; ~0 if none pending
+    * @note scans the first non-empty slot of each level
+    *
+    */
+   uint64_t next_tick();
+
+   /** # pending timers */
+   int count() {
+      return (n_pending);
+   }
+
+private:
+   TwLink slot[TW_LEVELS][TW_N_SLOT];
+   uint64_t cur;              // last granule serviced
+   uint64_t now_est;          // last time read (extended from 32 bits)
+   int n_pending;
+   int init;
+   uint64_t read_now();
+   void insert(TwTimer *t, uint64_t min_gran);
+   void cascade(int level, int idx);
+   int fire(int idx);
+};
+
+#endif  // _CHU_TWHEEL_H_INCLUDED
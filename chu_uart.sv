@@ -1,10 +1,15 @@
 // 
 //  Reg map (each port uses 4 address space)
 //    * 0: read data and status
-//    * 1: write baud rate 
+//    * 1: write baud rate: bit 10-0: dvsr; bit 23-16: dvsr_frac
+//         (a tick every dvsr+1+dvsr_frac/256 clocks on average)
+//    * 1: read fifo levels: bit 31-16: free tx entries; bit 15-0: rx bytes
 //    * 2: write data 
 //    * 3: dummy write to remove data from head of rx FIFO 
+//  * offsets from chu_io_map.svh (generated from chu_io_map.def)
 //
+`include "chu_io_map.svh"
+
 module chu_uart
    #(parameter  FIFO_DEPTH_BIT = 8)  // # addr bits of FIFO
    (
@@ -24,27 +29,40 @@ module chu_uart
    // signal declaration
    logic wr_uart, rd_uart, wr_dvsr ;
    logic tx_full, rx_empty;
+   logic [FIFO_DEPTH_BIT:0] tx_count, rx_count;
+   logic [15:0] tx_free, rx_used;
    logic [10:0] dvsr_reg;
+   logic [7:0] frac_reg;
    logic [7:0] r_data;
    logic ctrl_reg;
 
    // body
    // instantiate uart
    uart #(.DBIT(8), .SB_TICK(16), .FIFO_W(FIFO_DEPTH_BIT)) uart_unit    
-   (.*, .dvsr(dvsr_reg), .w_data(wr_data[7:0]) );
+   (.*, .dvsr(dvsr_reg), .dvsr_frac(frac_reg), .w_data(wr_data[7:0]) );
    
    // dvsr register
    always_ff @(posedge clk, posedge reset)
-      if (reset)
+      if (reset) begin
          dvsr_reg <= 0;
+         frac_reg <= 0;
+      end
       else   
-         if (wr_dvsr)
-            dvsr_reg <= wr_data[10:0];
+         if (wr_dvsr) begin
+            dvsr_reg <= wr_data[`UART_DVSR_MSB:`UART_DVSR_LSB];
+            frac_reg <= wr_data[`UART_DVSR_FRAC_MSB:`UART_DVSR_FRAC_LSB];
+         end
    // decoding logic
-   assign wr_dvsr = (write && cs && (addr[1:0]==2'b01));
-   assign wr_uart = (write && cs && (addr[1:0]==2'b10));
-   assign rd_uart = (write && cs && (addr[1:0]==2'b11));
+   assign wr_dvsr = (write && cs && (addr[1:0]==`UART_DVSR_REG));
+   assign wr_uart = (write && cs && (addr[1:0]==`UART_WR_DATA_REG));
+   assign rd_uart = (write && cs && (addr[1:0]==`UART_RM_RD_DATA_REG));
    // slot read interface
-   assign rd_data = {22'h000000, tx_full,  rx_empty, r_data};
+   assign tx_free = (1 << FIFO_DEPTH_BIT) - tx_count;
+   assign rx_used = rx_count;
+   always_comb
+      if (addr[1:0]==`UART_LEVEL_REG)
+         rd_data = {tx_free, rx_used};
+      else
+         rd_data = {22'h000000, tx_full,  rx_empty, r_data};
 endmodule
 
@@ -0,0 +1,109 @@
+//  * Reg map;
+//    * 00: write: control register:
+//        bit 0: enable (the counter is reloaded when enabled)
+//        bit 1: clear reset flag (1-clock pulse)
+//    * 00: read: status register:
+//        bit 0: enabled
+//        bit 1: reset flag (last cpu reset caused by the watchdog)
+//    * 01: write: timeout (# clocks)
+//    * 01: read: # clocks left
+//    * 10: write: kick: bit 31-16: key (must be `WDT_KEY_MAGIC);
+//        bit 15-0: tag; reloads the counter and stores the tag;
+//        ignored while disabled, so the tag of the task that let the
+//        watchdog expire is kept
+//    * 10: read: tag of the last accepted kick
+//  * when the counter of an enabled watchdog reaches 0, wdt_reset is
+//    asserted for 2^RST_W clocks, the reset flag is set and the
+//    watchdog disables itself
+//  * reset only by por (board reset): flag, tag and timeout survive the
+//    cpu/mmio reset it causes, so the firmware can tell which task hung
+//  * offsets/fields from chu_io_map.svh (generated from chu_io_map.def)
+
+`include "chu_io_map.svh"
+
+module chu_watchdog
+   #(parameter RST_W = 4)    // reset pulse of 2^RST_W clocks
+   (
+    input  logic clk,
+    input  logic por,
+    // slot interface
+    input  logic cs,
+    input  logic read,
+    input  logic write,
+    input  logic [4:0] addr,
+    input  logic [31:0] wr_data,
+    output logic [31:0] rd_data,
+    // cpu/mmio reset request
+    output logic wdt_reset
+   );
+
+   // signal declaration
+   logic en_reg, flag_reg;
+   logic [31:0] load_reg, count_reg;
+   logic [15:0] tag_reg;
+   logic [RST_W-1:0] pulse_reg;
+   logic pulse_on;
+   logic wr_ctrl, wr_load, wr_kick, kick, expire;
+
+   //***************************************************************
+   // counter, enable, flag and tag
+   //***************************************************************
+   always_ff @(posedge clk, posedge por)
+      if (por) begin
+         en_reg <= 1'b0;
+         flag_reg <= 1'b0;
+         load_reg <= 32'hffffffff;
+         count_reg <= 32'hffffffff;
+         tag_reg <= 0;
+      end
+      else begin
+         if (wr_load)
+            load_reg <= wr_data;
+         if (wr_ctrl) begin
+            en_reg <= wr_data[`WDT_EN_LSB];
+            if (wr_data[`WDT_EN_LSB] && !en_reg)
+               count_reg <= load_reg;
+         end
+         else if (expire)
+            en_reg <= 1'b0;
+         if (kick) begin
+            count_reg <= load_reg;
+            tag_reg <= wr_data[`WDT_TAG_MSB:`WDT_TAG_LSB];
+         end
+         else if (en_reg && count_reg != 0)
+            count_reg <= count_reg - 1;
+         if (expire)
+            flag_reg <= 1'b1;
+         else if (wr_ctrl && wr_data[`WDT_CLR_FLAG_LSB])
+            flag_reg <= 1'b0;
+      end
+
+   //***************************************************************
+   // reset pulse
+   //***************************************************************
+   always_ff @(posedge clk, posedge por)
+      if (por)
+         pulse_reg <= 0;
+      else
+         if (expire)
+            pulse_reg <= {RST_W{1'b1}};
+         else if (pulse_on)
+            pulse_reg <= pulse_reg - 1;
+   assign pulse_on = (pulse_reg != 0);
+   assign wdt_reset = pulse_on;
+
+   // decoding logic
+   assign wr_ctrl = write && cs && (addr[1:0]==`WDT_CTRL_REG);
+   assign wr_load = write && cs && (addr[1:0]==`WDT_LOAD_REG);
+   assign wr_kick = write && cs && (addr[1:0]==`WDT_KICK_REG);
+   assign kick = wr_kick && en_reg && (wr_data[`WDT_KEY_MSB:`WDT_KEY_LSB]==`WDT_KEY_MAGIC);
+   assign expire = en_reg && (count_reg == 0) && !kick;
+   // slot read interface
+   always_comb
+      case (addr[1:0])
+         `WDT_STATUS_REG: rd_data = {30'h0, flag_reg, en_reg};
+         `WDT_COUNT_REG: rd_data = count_reg;
+         `WDT_TAG_REG: rd_data = {16'h0000, tag_reg};
+         default: rd_data = 32'h0;
+      endcase
+endmodule
@@ -4,6 +4,9 @@
 //  * DRP interface is connected to atomtically read
 //    out the pres-designated channels
 //  * the readout is stored into corresponding register
+//  * offsets from chu_io_map.svh (generated from chu_io_map.def)
+
+`include "chu_io_map.svh"
 
 module chu_xadc_core
    (
@@ -88,17 +91,17 @@ module chu_xadc_core
    // read multiplexing 
    always_comb
       case(addr[2:0])
-         3'b000:
+         `XADC_ADC_0_REG:
             r_data <= {16'h0000, adc0_out_reg};
-         3'b001:
+         `XADC_ADC_0_REG+1:
             r_data <= {16'h0000, adc1_out_reg};
-         3'b010:
+         `XADC_ADC_0_REG+2:
             r_data <= {16'h0000, adc2_out_reg};
-         3'b011:
+         `XADC_ADC_0_REG+3:
             r_data <= {16'h0000, adc3_out_reg};
-         3'b100:
+         `XADC_TMP_REG:
             r_data <= {16'h0000, tmp_out_reg};
-         default:
+         default:   // `XADC_VCC_REG
             r_data <= {16'h0000, vcc_out_reg};
       endcase
       assign rd_data = r_data;
@@ -0,0 +1,82 @@
+// Runs main_sampler_test.cpp against the Verilated mmio_sys_sampler RTL
+// and reports the task statistics of its scheduler in RTL clocks.
+//
+// build (Verilator 5):
+//   verilator --cc --exe --build -j 0 -Wno-fatal --top-module mmio_sys_cosim
+//       -CFLAGS "-O2 -D_SIM_IO_ACCESS_USED -I$(pwd)"
+//       mmio_sys_cosim.sv mmio_sys_sampler.sv cosim_xadc_fpro.sv
+//       chu_timer.sv chu_watchdog.sv chu_uart.sv uart.sv uart_rx.sv uart_tx.sv
+//       baud_gen.sv fifo.sv fifo_ctrl.sv reg_file.sv chu_gpo.sv chu_gpi.sv
+//       chu_xadc_core.sv chu_io_pwm_core.sv chu_led_mux_core.sv led_mux8.sv
+//       chu_i2c_core.sv i2c_master.sv chu_mmio_controller.sv
+//       cosim_main.cpp temp_monitor.cpp chu_io_cosim.cpp chu_io_sim.cpp chu_init.cpp
+//       timer_core.cpp uart_core.cpp gpio_cores.cpp xadc_core.cpp
+//       sseg_core.cpp i2c_core.cpp chu_sched.cpp wdt_core.cpp chu_telem.cpp
+//   - cosim_xadc_fpro.sv replaces the vendor xadc_fpro core
+//   - linking chu_io_cosim.cpp routes all io_read()/io_write() to the RTL
+// run:
+//   obj_dir/Vmmio_sys_cosim [# frames] [sw]
+//   - default 3 frames of 200 ms; sw is the 16-bit switch setting
+//     (default 0x1919)
+//   - uart output of the application is decoded from the tx pin
+//   - at the end the scheduler report (Scheduler::report()) lists per
+//     task the runs, overruns, skipped releases, release jitter and
+//     execution time measured on the RTL
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "chu_io_cosim.h"
+
+#define main sampler_main
+#include "main_sampler_test.cpp"
+#undef main
+
+/**
+ * backend ending the run: prints the task report once the bus clock
+ * passes the limit
+ */
+class RunLimit : public SimBusBackend {
+public:
+   RunLimit(CosimBus *bus_p, uint64_t n) : bus(bus_p), limit(n) {}
+
+   uint32_t read(uint32_t addr) {
+      check();
+      return (bus->read(addr));
+   }
+
+   void write(uint32_t addr, uint32_t data) {
+      check();
+      bus->write(addr, data);
+   }
+
+   // a batch stays one burst on the rtl bus
+   void write_burst(const IoWrDesc *desc, int n) {
+      check();
+      bus->write_burst(desc, n);
+   }
+
+private:
+   CosimBus *bus;
+   uint64_t limit;
+
+   void check() {
+      if (bus->cycle() < limit)
+         return;
+      printf("\n[cosim] %llu clk\n", (unsigned long long) bus->cycle());
+      sched.report();
+      exit(0);
+   }
+};
+
+int main(int argc, char **argv) {
+   int n = (argc > 1) ? atoi(argv[1]) : 3;
+   uint32_t s = (argc > 2) ? (uint32_t) strtoul(argv[2], 0, 0) : 0x1919;
+   CosimBus &bus = cosim_bus();
+   RunLimit lim(&bus, n * TimerCore::ms2tick(200));
+
+   bus.set_sw(s);
+   bus.adc().set_temp(40.0);
+   bus.adt7420().set_temp(24.5);
+   sim_io_set_backend(&lim);
+   return (sampler_main());
+}
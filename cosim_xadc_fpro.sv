@@ -0,0 +1,78 @@
+// simulation replacement of the xadc_fpro wizard core (Verilator)
+//  * same ports as xadc_fpro.sv
+//  * sequences the 6 channels used by chu_xadc_core, one conversion
+//    every CONV_CLKS clocks (eoc_out pulse with channel_out)
+//  * the DRP read issued on eoc returns the value supplied by the C++
+//    harness through cosim_xadc_data() one clock later (drdy_out)
+
+module xadc_fpro
+   #(parameter CONV_CLKS = 256)
+   (
+    input  logic [6:0] daddr_in,
+    input  logic dclk_in,
+    input  logic den_in,
+    input  logic [15:0] di_in,
+    input  logic dwe_in,
+    input  logic reset_in,
+    input  logic vauxp2, vauxn2,
+    input  logic vauxp3, vauxn3,
+    input  logic vauxp10, vauxn10,
+    input  logic vauxp11, vauxn11,
+    input  logic vp_in, vn_in,
+    output logic busy_out,
+    output logic [4:0] channel_out,
+    output logic [15:0] do_out,
+    output logic drdy_out,
+    output logic eoc_out,
+    output logic eos_out,
+    output logic alarm_out
+   );
+
+   import "DPI-C" function int cosim_xadc_data(input int channel);
+
+   // declaration
+   logic [15:0] c_reg;
+   logic [2:0] seq_reg;
+   logic [4:0] ch;
+
+   // sequence: temp, vcc, vaux3, vaux10, vaux2, vaux11
+   always_comb
+      case (seq_reg)
+         3'd0: ch = 5'b00000;
+         3'd1: ch = 5'b00001;
+         3'd2: ch = 5'b10011;
+         3'd3: ch = 5'b11010;
+         3'd4: ch = 5'b10010;
+         default: ch = 5'b11011;
+      endcase
+
+   always_ff @(posedge dclk_in, posedge reset_in)
+      if (reset_in) begin
+         c_reg <= 0;
+         seq_reg <= 0;
+         channel_out <= 0;
+         eoc_out <= 1'b0;
+         drdy_out <= 1'b0;
+         do_out <= 16'h0000;
+      end
+      else begin
+         eoc_out <= 1'b0;
+         drdy_out <= 1'b0;
+         if (c_reg == CONV_CLKS - 1) begin
+            c_reg <= 0;
+            channel_out <= ch;
+            eoc_out <= 1'b1;
+            seq_reg <= (seq_reg == 3'd5) ? 3'd0 : seq_reg + 1;
+         end
+         else
+            c_reg <= c_reg + 1;
+         if (den_in) begin
+            do_out <= 16'(cosim_xadc_data({27'b0, daddr_in[4:0]}));
+            drdy_out <= 1'b1;
+         end
+      end
+
+   assign busy_out = 1'b0;
+   assign eos_out = eoc_out && (channel_out == 5'b11011);
+   assign alarm_out = 1'b0;
+endmodule
@@ -0,0 +1,465 @@
+// Host benchmark of the driver and application hot paths.
+//
+// build:
+//   g++ -O2 -D_SIM_IO_ACCESS_USED -I. driver_bench.cpp temp_monitor.cpp
+//       chu_io_sim.cpp chu_init.cpp timer_core.cpp uart_core.cpp
+//       gpio_cores.cpp xadc_core.cpp sseg_core.cpp i2c_core.cpp
+//       chu_telem.cpp chu_log.cpp -o driver_bench
+// run:
+//   ./driver_bench [min_ms]        (default 200 ms per benchmark)
+//
+// output (CSV on stdout, one line per benchmark, stable order):
+//   name,iters,ns_per_op,rd_per_op,wr_per_op,alloc_per_op
+//   - iters and ns/op are host time and only meaningful relative to
+//     another run on the same machine; rd/wr/alloc per op come from a fixed # of
+//     iterations and can be diffed between commits
+//   - the bus is a counting stub (BenchBus), not SimBus, so that the
+//     numbers contain the driver code only: reads return fixed values
+//     (uart never full, xadc temperature 40 C) and cost no simulated time
+//   - fmt_*: number to text without the bus; *_divmod is the former
+//     UartCore::disp() loop (one % and one / per digit), kept here as
+//     the reference for the chu_fmt.h routines; x86 divides in
+//     hardware, so the host ratio understates the gain on the MCS,
+//     where each / or % is a software division call; likewise
+//     fmt_double_float (former UartCore::disp(double): double multiply,
+//     cast and subtract per digit) vs fmt_double (integer-only split of
+//     the IEEE-754 bits) is a lower bound for the MCS, which has no FPU
+//   - uart_line_pieces vs uart_line_print: one log line as 3 disp()
+//     calls vs one fmt_print() (chu_print.h); rd_per_op shows the tx
+//     fifo level reads saved
+//   - telem_frame_2ch: one binary telemetry frame with both temperatures
+//     (chu_telem.h); wr_per_op is the # bytes on the wire, against about
+//     44 for the two text lines
+//   - log_record: one deferred log record with 2 arguments (chu_log.h;
+//     the ring is emptied each iteration): a timer read and 5 word
+//     stores against a formatted uart line
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+#include <chrono>
+
+#include "chu_init.h"
+#include "chu_io_sim.h"
+#include "temp_monitor.h"
+#include "chu_fmt.h"
+#include "chu_print.h"
+#include "chu_telem.h"
+#include "chu_log.h"
+
+/**********************************************************************
+ * allocation counter
+ **********************************************************************/
+static unsigned long n_alloc = 0;
+
+void *operator new(size_t size) {
+   void *p;
+
+   n_alloc++;
+   p = malloc(size ? size : 1);
+   if (p == 0)
+      throw std::bad_alloc();
+   return (p);
+}
+
+void *operator new[](size_t size) {
+   return (operator new(size));
+}
+
+void operator delete(void *p) noexcept {
+   free(p);
+}
+
+void operator delete[](void *p) noexcept {
+   free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+   free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+   free(p);
+}
+
+/**********************************************************************
+ * counting bus stub
+ **********************************************************************/
+class BenchBus : public SimBusBackend {
+public:
+   BenchBus() : n_rd(0), n_wr(0), tick(0), cmp(0), xadc_raw(0) {}
+
+   uint32_t read(uint32_t addr) {
+      n_rd++;
+      switch (slot(addr)) {
+      case TIMER_SLOT:
+         tick += 4;
+         if (reg(addr) == TimerCore::STATUS_REG)
+            return ((tick >= cmp) ? TimerCore::MATCH_FIELD : 0);
+         return ((addr & 0x04) ? (uint32_t) (tick >> 32) : (uint32_t) tick);
+      case UART_SLOT:
+         if (reg(addr) == UartCore::LEVEL_REG)
+            return (256 << UART_TX_FREE_LSB);  // tx empty, rx empty
+         return (UartCore::RX_EMPT_FIELD);   // tx not full, rx empty
+      case S5_XDAC:
+         return (xadc_raw);
+      default:
+         return (0);
+      }
+   }
+
+   void write(uint32_t addr, uint32_t data) {
+      n_wr++;
+      if (slot(addr) != TIMER_SLOT)
+         return;
+      if (reg(addr) == TimerCore::CMP_LOWER_REG)
+         cmp = (cmp & 0xffff00000000ULL) | data;
+      else if (reg(addr) == TimerCore::CMP_UPPER_REG)
+         cmp = (cmp & 0xffffffffULL) | (uint64_t) (data & 0xffff) << 32;
+   }
+
+   void set_xadc_temp(double c) {
+      xadc_raw = (uint32_t) ((c + 273.15) * 4096.0 / 503.975) << 4;
+   }
+
+   unsigned long n_rd, n_wr;
+
+private:
+   uint64_t tick;
+   uint64_t cmp;        // timer compare value
+   uint32_t xadc_raw;
+
+   static int slot(uint32_t addr) {
+      return ((int) ((addr - BRIDGE_BASE) >> 7) & 0x3f);
+   }
+
+   static int reg(uint32_t addr) {
+      return ((int) (addr >> 2) & 0x1f);
+   }
+};
+
+/**********************************************************************
+ * harness
+ **********************************************************************/
+static BenchBus bus;
+static volatile uint32_t sink;   // keeps results alive
+static double min_ns = 200e6;
+
+typedef void (*BenchFunc)(long iters);
+
+#define COUNT_ITERS 4096   // fixed # iterations for the per-op counts
+
+// counts from COUNT_ITERS iterations (identical on every host); time from
+// a growing # iterations until one run takes min_ns
+static void run(const char *name, BenchFunc f) {
+   long iters;
+   unsigned long rd0, wr0, al0;
+   double ns, rd, wr, al;
+
+   rd0 = bus.n_rd;
+   wr0 = bus.n_wr;
+   al0 = n_alloc;
+   f(COUNT_ITERS);
+   rd = (double) (bus.n_rd - rd0) / COUNT_ITERS;
+   wr = (double) (bus.n_wr - wr0) / COUNT_ITERS;
+   al = (double) (n_alloc - al0) / COUNT_ITERS;
+   for (iters = COUNT_ITERS;; iters = iters * 4) {
+      std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+      f(iters);
+      std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+      ns = (double) std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+      if (ns >= min_ns || iters >= (1L << 30))
+         break;
+   }
+   printf("%s,%ld,%.2f,%.3f,%.3f,%.3f\n", name, iters, ns / iters, rd, wr, al);
+}
+
+/**********************************************************************
+ * benchmarks
+ **********************************************************************/
+SsegCore sseg(get_slot_addr(BRIDGE_BASE, S8_SSEG));
+XadcCore adc(get_slot_addr(BRIDGE_BASE, S5_XDAC));
+
+static void b_uart_disp_int10(long iters) {
+   for (long i = 0; i < iters; i++)
+      uart.disp((int) (i * 7919 - 123456), 10, 0);
+}
+
+static void b_uart_disp_int16(long iters) {
+   for (long i = 0; i < iters; i++)
+      uart.disp((int) (i * 7919), 16, 8);
+}
+
+static void b_uart_disp_double(long iters) {
+   for (long i = 0; i < iters; i++)
+      uart.disp(23.0 + (double) (i & 0xff) / 64.0, 3);
+}
+
+static void b_uart_line_pieces(long iters) {
+   for (long i = 0; i < iters; i++) {
+      uart.disp("temperature (C): ");
+      uart.disp_fix((int32_t) (i & 0x7ff), 4, 3);
+      uart.disp("\n\r");
+   }
+}
+
+static void b_uart_line_print(long iters) {
+   for (long i = 0; i < iters; i++)
+      fmt_print(uart, FMT_STR("temperature (C): {:.3}\n\r"), fmt_fix((int32_t) (i & 0x7ff), 4));
+}
+
+static void b_telem_frame_2ch(long iters) {
+   TelemSample s[2] = {{TELEM_CH_FPGA_TEMP, 6, 0}, {TELEM_CH_EXT_TEMP, 4, 0}};
+
+   for (long i = 0; i < iters; i++) {
+      s[0].v = (int32_t) (i & 0x1fff);
+      s[1].v = (int32_t) (i & 0x7ff);
+      telem_send(s, 2);
+   }
+}
+
+static void b_log_record(long iters) {
+   for (long i = 0; i < iters; i++) {
+      log_write<LOG_LEVEL_TRACE>(FMT_STR("i2c wr {:02x} ack {}"), (uint8_t) i, 0);
+      log_tail = log_head;
+   }
+}
+
+// former UartCore::disp() conversion: one % and one / per digit
+static char *fmt_divmod(char *end, uint64_t un, int base) {
+   int rem;
+
+   do {
+      rem = (int) (un % base);
+      un = un / base;
+      *--end = (char) ((rem < 10) ? rem + '0' : rem - 10 + 'a');
+   } while (un);
+   return (end);
+}
+
+static void b_fmt_int10_divmod(long iters) {
+   char buf[34];
+   uint32_t acc = 0;
+
+   for (long i = 0; i < iters; i++)
+      acc += (uint32_t) *fmt_divmod(&buf[33], (uint32_t) (i * 7919 + 123456), 10);
+   sink = acc;
+}
+
+static void b_fmt_int10(long iters) {
+   char buf[34];
+   uint32_t acc = 0;
+
+   for (long i = 0; i < iters; i++)
+      acc += (uint32_t) *fmt_dec32(&buf[33], (uint32_t) (i * 7919 + 123456));
+   sink = acc;
+}
+
+static void b_fmt_int16_divmod(long iters) {
+   char buf[34];
+   uint32_t acc = 0;
+
+   for (long i = 0; i < iters; i++)
+      acc += (uint32_t) *fmt_divmod(&buf[33], (uint32_t) (i * 7919), 16);
+   sink = acc;
+}
+
+static void b_fmt_int16(long iters) {
+   char buf[34];
+   uint32_t acc = 0;
+
+   for (long i = 0; i < iters; i++)
+      acc += (uint32_t) *fmt_pow2_32(&buf[33], (uint32_t) (i * 7919), 4);
+   sink = acc;
+}
+
+// 48-bit timer ticks
+static void b_fmt_u64_divmod(long iters) {
+   char buf[65];
+   uint32_t acc = 0;
+
+   for (long i = 0; i < iters; i++)
+      acc += (uint32_t) *fmt_divmod(&buf[64], 0x800000000000ULL + (uint64_t) i * 999983, 10);
+   sink = acc;
+}
+
+static void b_fmt_u64(long iters) {
+   char buf[65];
+   uint32_t acc = 0;
+
+   for (long i = 0; i < iters; i++)
+      acc += (uint32_t) *fmt_dec64(&buf[64], 0x800000000000ULL + (uint64_t) i * 999983);
+   sink = acc;
+}
+
+// former UartCore::disp(double, 3) conversion
+static char *fmt_double_float(char *p, double f, int digit) {
+   double fa, frac;
+   int n, i, i_part;
+
+   fa = f;
+   if (f < 0.0) {
+      fa = -f;
+      *p++ = '-';
+   }
+   i_part = (int) fa;
+   p = p + 10;
+   p = fmt_divmod(p, (uint32_t) i_part, 10);   // not timed separately
+   *p++ = '.';
+   frac = fa - (double) i_part;
+   for (n = 0; n < digit; n++) {
+      frac = frac * 10.0;
+      i = (int) frac;
+      *p++ = (char) ('0' + i);
+      frac = frac - i;
+   }
+   return (p);
+}
+
+static double dbl_in[4096];   // inputs, so the loops time formatting only
+
+static void b_fmt_double_float(long iters) {
+   char buf[48];
+   uint32_t acc = 0;
+
+   for (long i = 0; i < iters; i++)
+      acc += (uint32_t) fmt_double_float(buf, dbl_in[i & 0xfff], 3)[-1];
+   sink = acc;
+}
+
+static void b_fmt_double(long iters) {
+   char buf[48], *p;
+   uint32_t acc = 0, ip, fq;
+
+   for (long i = 0; i < iters; i++) {
+      fmt_dbl_split(dbl_in[i & 0xfff], &ip, &fq);
+      p = fmt_dec32(&buf[12], ip);
+      p = fmt_frac_q32(&buf[13], fq, 3);
+      acc += (uint32_t) p[-1] + (uint32_t) buf[11];
+   }
+   sink = acc;
+}
+
+// ADT7420 code (Q4) straight to text
+static void b_fmt_fix_q4(long iters) {
+   char buf[48], *p;
+   uint32_t acc = 0, v;
+
+   for (long i = 0; i < iters; i++) {
+      v = (uint32_t) (i & 0xfff);
+      p = fmt_dec32(&buf[12], v >> 4);
+      p = fmt_frac_q32(&buf[13], v << 28, 3);
+      acc += (uint32_t) p[-1] + (uint32_t) buf[11];
+   }
+   sink = acc;
+}
+
+// write_led() is private; write_1ptn() is a single pattern update + write_led()
+static void b_sseg_write_led(long iters) {
+   for (long i = 0; i < iters; i++)
+      sseg.write_1ptn((uint8_t) (0x80 | (i & 0x7f)), (int) (i & 0x07));
+}
+
+static void b_sseg_h2s(long iters) {
+   uint32_t acc = 0;
+
+   for (long i = 0; i < iters; i++)
+      acc += sseg.h2s((int) (i & 0x0f));
+   sink = acc;
+}
+
+static void b_disp_temp(long iters) {
+   float c;
+
+   for (long i = 0; i < iters; i++) {
+      c = 15.0f + (float) (i & 0x3ff) * 0.1f;   // 15.0 to 117.3 C
+      sink = dispTemp(&sseg, c, cel2fer(c), (int) (i >> 10) & 0x01, (int) i & 0x01);
+   }
+}
+
+static void b_cel2fer(long iters) {
+   float acc = 0.0f;
+
+   for (long i = 0; i < iters; i++)
+      acc += cel2fer((float) (i & 0xff));
+   sink = (uint32_t) acc;
+}
+
+static void b_adt2cel(long iters) {
+   uint8_t bytes[2];
+   float acc = 0.0f;
+
+   for (long i = 0; i < iters; i++) {
+      bytes[0] = (uint8_t) (i >> 5);   // covers negative codes
+      bytes[1] = (uint8_t) (i << 3);
+      acc += adt2cel(bytes);
+   }
+   sink = (uint32_t) acc;
+}
+
+static void b_now_us(long iters) {
+   unsigned long acc = 0;
+
+   for (long i = 0; i < iters; i++)
+      acc += now_us();
+   sink = (uint32_t) acc;
+}
+
+static void b_now_ms(long iters) {
+   unsigned long acc = 0;
+
+   for (long i = 0; i < iters; i++)
+      acc += now_ms();
+   sink = (uint32_t) acc;
+}
+
+// 1 us = 100 clocks = 25 timer reads of BenchBus; # polls per call is fixed
+static void b_sleep_us(long iters) {
+   for (long i = 0; i < iters; i++)
+      sleep_us(1);
+}
+
+static void b_xadc_read_fpga_temp(long iters) {
+   double acc = 0.0;
+
+   for (long i = 0; i < iters; i++)
+      acc += adc.read_fpga_temp();
+   sink = (uint32_t) acc;
+}
+
+int main(int argc, char **argv) {
+   if (argc > 1)
+      min_ns = atof(argv[1]) * 1e6;
+   bus.set_xadc_temp(40.0);
+   for (int i = 0; i < 4096; i++)
+      dbl_in[i] = 23.0 + (double) i / 61.0;
+   sim_io_set_backend(&bus);
+
+   printf("name,iters,ns_per_op,rd_per_op,wr_per_op,alloc_per_op\n");
+   run("uart_disp_int_base10", b_uart_disp_int10);
+   run("uart_disp_int_base16", b_uart_disp_int16);
+   run("uart_disp_double", b_uart_disp_double);
+   run("uart_line_pieces", b_uart_line_pieces);
+   run("uart_line_print", b_uart_line_print);
+   run("telem_frame_2ch", b_telem_frame_2ch);
+   run("log_record", b_log_record);
+   run("fmt_int10_divmod", b_fmt_int10_divmod);
+   run("fmt_int10", b_fmt_int10);
+   run("fmt_int16_divmod", b_fmt_int16_divmod);
+   run("fmt_int16", b_fmt_int16);
+   run("fmt_u64_divmod", b_fmt_u64_divmod);
+   run("fmt_u64", b_fmt_u64);
+   run("fmt_double_float", b_fmt_double_float);
+   run("fmt_double", b_fmt_double);
+   run("fmt_fix_q4", b_fmt_fix_q4);
+   run("sseg_write_led", b_sseg_write_led);
+   run("sseg_h2s", b_sseg_h2s);
+   run("dispTemp", b_disp_temp);
+   run("cel2fer", b_cel2fer);
+   run("adt2cel", b_adt2cel);
+   run("xadc_read_fpga_temp", b_xadc_read_fpga_temp);
+   run("now_us", b_now_us);
+   run("now_ms", b_now_ms);
+   run("sleep_us", b_sleep_us);
+   return (0);
+}
@@ -9,6 +9,7 @@ module fifo
     input  logic rd, wr,
     input  logic [DATA_WIDTH-1:0] w_data,
     output logic empty, full,
+    output logic [ADDR_WIDTH:0] count,   // # words stored
     output logic [DATA_WIDTH-1:0] r_data
    );
 
@@ -7,6 +7,7 @@ module fifo_ctrl
     input  logic clk, reset,
     input  logic rd, wr,
     output logic empty, full,
+    output logic [ADDR_WIDTH:0] count,   // # words stored
     output logic [ADDR_WIDTH-1:0] w_addr,
     output logic [ADDR_WIDTH-1:0] r_addr
    );
@@ -77,5 +78,7 @@ module fifo_ctrl
    assign r_addr = r_ptr_logic;
    assign full = full_logic;
    assign empty = empty_logic;
+   assign count = full_logic ? {1'b1, {ADDR_WIDTH{1'b0}}} :
+                               {1'b0, w_ptr_logic - r_ptr_logic};
 endmodule
 
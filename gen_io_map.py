@@ -0,0 +1,353 @@
+#!/usr/bin/env python3
+"""Generate chu_io_map.h, chu_io_map.svh and chu_io_regs.h from chu_io_map.def.
+
+usage: python3 gen_io_map.py [map.def] [output dir]
+
+The description is checked before anything is written:
+  - names are unique (slots, constants, registers and fields per core)
+  - register offsets fit the 32-word slot and do not overlap
+    (a read-only and a write-only register may share an offset)
+  - fields fit 32 bits and do not overlap within a register
+  - symbolic values fit their field
+"""
+
+import os
+import sys
+
+
+class MapError(Exception):
+    pass
+
+
+class Reg:
+    def __init__(self, name, offset, access, count, comment):
+        self.name = name
+        self.offset = offset
+        self.access = access
+        self.count = count
+        self.comment = comment
+        self.fields = []
+
+
+class Field:
+    def __init__(self, name, msb, lsb, comment):
+        self.name = name
+        self.msb = msb
+        self.lsb = lsb
+        self.comment = comment
+        self.values = []
+
+    def mask(self):
+        return ((1 << (self.msb - self.lsb + 1)) - 1) << self.lsb
+
+
+class Core:
+    def __init__(self, name, module, comment):
+        self.name = name
+        self.module = module
+        self.comment = comment
+        self.regs = []
+
+
+class IoMap:
+    def __init__(self):
+        self.consts = []   # (name, value, comment)
+        self.slots = []
+        self.videos = []
+        self.cores = []
+
+
+def parse_int(text, line_no):
+    try:
+        return int(text, 0)
+    except ValueError:
+        raise MapError("line %d: bad number '%s'" % (line_no, text))
+
+
+def parse(path):
+    io_map = IoMap()
+    core = reg = field = None
+    pending = []   # comment lines preceding an item
+    with open(path) as f:
+        for line_no, line in enumerate(f, 1):
+            text, _, comment = line.partition("#")
+            comment = comment.strip()
+            tok = text.split()
+            if not tok:
+                # a comment block documents the item that follows it
+                if line.strip() == "":
+                    pending = []
+                elif comment:
+                    pending.append(comment)
+                continue
+            kind, args = tok[0], tok[1:]
+            doc = comment or " ".join(pending)
+            pending = []
+            if kind == "const" and len(args) == 2:
+                io_map.consts.append((args[0], args[1], doc))
+            elif kind in ("slot", "video") and len(args) == 2:
+                n = parse_int(args[1], line_no)
+                limit = 64 if kind == "slot" else 8
+                if not 0 <= n < limit:
+                    raise MapError("line %d: %s # out of range" % (line_no, kind))
+                (io_map.slots if kind == "slot" else io_map.videos).append(
+                    (args[0], n, doc))
+            elif kind == "core" and len(args) == 2:
+                core = Core(args[0], args[1], doc)
+                io_map.cores.append(core)
+                reg = field = None
+            elif kind == "reg" and len(args) in (3, 4) and core:
+                if args[2] not in ("r", "w", "rw"):
+                    raise MapError("line %d: access must be r, w or rw" % line_no)
+                count = parse_int(args[3], line_no) if len(args) == 4 else 1
+                reg = Reg(args[0], parse_int(args[1], line_no), args[2], count, doc)
+                core.regs.append(reg)
+                field = None
+            elif kind == "field" and len(args) == 2 and reg:
+                msb, _, lsb = args[1].partition(":")
+                msb = parse_int(msb, line_no)
+                lsb = parse_int(lsb, line_no) if lsb else msb
+                field = Field(args[0], msb, lsb, doc)
+                reg.fields.append(field)
+            elif kind == "value" and len(args) == 2 and field:
+                field.values.append((args[0], parse_int(args[1], line_no), doc))
+            else:
+                raise MapError("line %d: cannot parse '%s'" % (line_no, line.strip()))
+    return io_map
+
+
+def check(io_map):
+    names = set()
+    for name, _, _ in io_map.consts + io_map.slots + io_map.videos:
+        if name in names:
+            raise MapError("duplicate name %s" % name)
+        names.add(name)
+    for core in io_map.cores:
+        if core.name in [c.name for c in io_map.cores if c is not core]:
+            raise MapError("duplicate core %s" % core.name)
+        core_names = set()
+        rd_words, wr_words = {}, {}
+        for reg in core.regs:
+            items = [reg.name] + [f.name for f in reg.fields]
+            for name in items:
+                if name in core_names:
+                    raise MapError("%s: duplicate name %s" % (core.name, name))
+                core_names.add(name)
+            if reg.offset < 0 or reg.count < 1 or reg.offset + reg.count > 32:
+                raise MapError("%s.%s: outside the 32-word slot" % (core.name, reg.name))
+            for word in range(reg.offset, reg.offset + reg.count):
+                for flag, used in (("r", rd_words), ("w", wr_words)):
+                    if flag in reg.access:
+                        if word in used:
+                            raise MapError("%s.%s: overlaps %s" %
+                                           (core.name, reg.name, used[word]))
+                        used[word] = reg.name
+            bits = 0
+            for f in reg.fields:
+                if not 0 <= f.lsb <= f.msb < 32:
+                    raise MapError("%s.%s: bad bit range" % (core.name, f.name))
+                if bits & f.mask():
+                    raise MapError("%s.%s: overlaps another field" % (core.name, f.name))
+                bits |= f.mask()
+                for vname, v, _ in f.values:
+                    if not 0 <= v < (1 << (f.msb - f.lsb + 1)):
+                        raise MapError("%s.%s.%s: does not fit" % (core.name, f.name, vname))
+
+
+def c_comment(doc):
+    return ("   // " + doc) if doc else ""
+
+
+def gen_h(io_map):
+    out = []
+    w = out.append
+    w("""/*********************************************************************
+ * @file chu_io_map.h
+ * *
+ * @brief define io map and system frequency
+ *
+ * file contains constants to specify io and video configuration:
+ *   - base address the subsystem
+ *   - slot # with a symbolic constant
+ *   - register offsets and field masks of each core
+ *   - generated by gen_io_map.py from chu_io_map.def; edit the
+ *     .def file and regenerate (chu_io_map.svh is generated from the
+ *     same description, so hardware and firmware maps always match)
+ *
+ *
+ * @author p chu
+ * @version v1.0: initial release
+ *********************************************************************/
+
+#ifndef _CHU_IO_MAP_INCLUDED
+#define _CHU_IO_MAP_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**********************************************************************
+ * Xilinx nexys4 ddr board "sampler/daisy" configuration
+ *********************************************************************/
+""")
+    for i, (name, value, doc) in enumerate(io_map.consts):
+        if doc:
+            if i > 0:
+                w("")
+            w("// %s" % doc)
+        w("#define %s %s" % (name, value))
+    w("")
+    w("// slot module definition")
+    w("// format: Slot#_ModuleType_Name")
+    for name, n, _ in io_map.slots:
+        w("#define %-12s %2d" % (name, n))
+    w("")
+    w("// video module definition")
+    for name, n, _ in io_map.videos:
+        w("#define %-11s %2d" % (name, n))
+    for core in io_map.cores:
+        w("")
+        w("// %s core (%s)" % (core.name.lower(), core.module))
+        for reg in core.regs:
+            w("#define %s_%s %d%s" % (core.name, reg.name, reg.offset, c_comment(reg.comment)))
+            if reg.count > 1:
+                w("#define %s_%s_COUNT %d" % (core.name, reg.name, reg.count))
+            for f in reg.fields:
+                w("#define %s_%s_FIELD 0x%08x%s" % (core.name, f.name, f.mask(),
+                                                     c_comment(f.comment)))
+                w("#define %s_%s_LSB %d" % (core.name, f.name, f.lsb))
+                for vname, v, doc in f.values:
+                    w("#define %s_%s_%s %d%s" % (core.name, f.name, vname, v, c_comment(doc)))
+    w("""/*********************************************************************/
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+
+#endif  // _CHU_IO_MAP_INCLUDED
+""")
+    return out
+
+
+def sv_value(value, names):
+    # C hex to SV literal; prefix references to other constants
+    if value.startswith("0x"):
+        return "32'h" + value[2:]
+    terms = value.split("+")
+    return "+".join(("`" + t) if t in names else t for t in terms)
+
+
+def gen_svh(io_map):
+    out = []
+    w = out.append
+    w("// chu_io_map.svh: generated by gen_io_map.py from chu_io_map.def")
+    w("")
+    w("`ifndef _CHU_IO_MAP_INCLUDED")
+    w("`define _CHU_IO_MAP_INCLUDED")
+    w("")
+    names = [c[0] for c in io_map.consts]
+    for i, (name, value, doc) in enumerate(io_map.consts):
+        if doc:
+            if i > 0:
+                w("")
+            w("// %s" % doc)
+        w("`define %s %s" % (name, sv_value(value, names)))
+    w("")
+    w("// slot module definition")
+    w("// format: Slot#_ModuleType_Name")
+    for name, n, _ in io_map.slots:
+        w("`define %-12s %2d" % (name, n))
+    w("")
+    w("// video module definition")
+    for name, n, _ in io_map.videos:
+        w("`define %-11s %2d" % (name, n))
+    for core in io_map.cores:
+        w("")
+        w("// %s core (%s)" % (core.name.lower(), core.module))
+        for reg in core.regs:
+            w("`define %s_%s %d%s" % (core.name, reg.name, reg.offset, c_comment(reg.comment)))
+            if reg.count > 1:
+                w("`define %s_%s_COUNT %d" % (core.name, reg.name, reg.count))
+            for f in reg.fields:
+                w("`define %s_%s_MSB %d%s" % (core.name, f.name, f.msb, c_comment(f.comment)))
+                w("`define %s_%s_LSB %d" % (core.name, f.name, f.lsb))
+                for vname, v, doc in f.values:
+                    w("`define %s_%s_%s %d%s" % (core.name, f.name, vname, v, c_comment(doc)))
+    w("")
+    w("`endif //_CHU_IO_MAP")
+    w("")
+    return out
+
+
+def gen_regs(io_map):
+    access = {"r": "IO_RD", "w": "IO_WR", "rw": "IO_RW"}
+    out = []
+    w = out.append
+    w("""/*****************************************************************//**
+ * @file chu_io_regs.h
+ *
+ * @brief typed register/field descriptors of the io cores
+ *
+ * Detailed description:
+ *  - generated by gen_io_map.py from chu_io_map.def; do not edit
+ *  - one namespace per core (e.g., uart_regs); see chu_io_field.h
+ *  - usage:
+ *      empty = io_read_field(base_addr, uart_regs::RX_EMPT);
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _CHU_IO_REGS_H_INCLUDED
+#define _CHU_IO_REGS_H_INCLUDED
+
+#include "chu_io_field.h"
+""")
+    for core in io_map.cores:
+        w("/* %s core (%s) */" % (core.name.lower(), core.module))
+        w("namespace %s_regs {" % core.name.lower())
+        for reg in core.regs:
+            count = (", %d" % reg.count) if reg.count > 1 else ""
+            w("typedef IoReg<%d, %s%s> %s;%s" % (reg.offset, access[reg.access], count,
+                                                 reg.name, c_comment(reg.comment)))
+            for f in reg.fields:
+                w("typedef IoField<%s, %d, %d> %s;%s" % (reg.name, f.lsb, f.msb - f.lsb + 1,
+                                                         f.name, c_comment(f.comment)))
+                if f.values:
+                    w("enum {")
+                    items = ["   %s_%s = %d" % (f.name, vname, v) for vname, v, _ in f.values]
+                    w(",\n".join(items))
+                    w("};")
+        w("}")
+        w("")
+    w("#endif  // _CHU_IO_REGS_H_INCLUDED")
+    return out
+
+
+def write(path, lines):
+    text = "\n".join(lines)
+    if not text.endswith("\n"):
+        text += "\n"
+    # repo convention: CRLF line endings
+    with open(path, "w", newline="\r\n") as f:
+        f.write(text)
+
+
+def main():
+    src = sys.argv[1] if len(sys.argv) > 1 else "chu_io_map.def"
+    dst = sys.argv[2] if len(sys.argv) > 2 else os.path.dirname(os.path.abspath(src))
+    try:
+        io_map = parse(src)
+        check(io_map)
+    except (MapError, OSError) as e:
+        sys.stderr.write("gen_io_map: %s\n" % e)
+        return 1
+    write(os.path.join(dst, "chu_io_map.h"), gen_h(io_map))
+    write(os.path.join(dst, "chu_io_map.svh"), gen_svh(io_map))
+    write(os.path.join(dst, "chu_io_regs.h"), gen_regs(io_map))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -8,6 +8,7 @@
  ********************************************************************/
 
 #include "gpio_cores.h"
+#include "chu_log.h"
 
 /**********************************************************************
  * GpiCore
@@ -60,6 +61,7 @@ int DebounceCore::read_db(int bit_pos) {
 GpoCore::GpoCore(uint32_t core_base_addr) {
    base_addr = core_base_addr;
    wr_data = 0;
+   batch = 0;
 }
 
 GpoCore::~GpoCore() {
@@ -67,12 +69,26 @@ GpoCore::~GpoCore() {
 
 void GpoCore::write(uint32_t data) {
    wr_data = data;
-   io_write(base_addr, DATA_REG, wr_data);
+   if (regs.update(DATA_REG, wr_data))
+      io_write_or_queue(batch, base_addr, DATA_REG, wr_data);
 }
 
 void GpoCore::write(int bit_value, int bit_pos) {
    bit_write(wr_data, bit_pos, bit_value);
-   io_write(base_addr, DATA_REG, wr_data);
+   if (regs.update(DATA_REG, wr_data))
+      io_write_or_queue(batch, base_addr, DATA_REG, wr_data);
+}
+
+unsigned long GpoCore::suppressed_writes() {
+   return (regs.suppressed());
+}
+
+void GpoCore::invalidate() {
+   regs.invalidate();
+}
+
+void GpoCore::set_batch(IoBatch *b) {
+   batch = b;
 }
 
 /**********************************************************************
@@ -80,6 +96,7 @@ void GpoCore::write(int bit_value, int bit_pos) {
  **********************************************************************/
 PwmCore::PwmCore(uint32_t core_base_addr) {
    base_addr = core_base_addr;
+   batch = 0;
    set_freq(1000);
 }
 
@@ -88,25 +105,37 @@ PwmCore::~PwmCore() {
 
 void PwmCore::set_freq(int freq) {
    uint32_t dvsr;
-   dvsr = (uint32_t) SYS_CLK_FREQ * 1000000 / MAX / freq;
-   io_write(base_addr, DVSR_REG, dvsr);
+   dvsr = freq_dvsr(freq);
+   if (regs.update(DVSR_REG, dvsr))
+      io_write_or_queue(batch, base_addr, DVSR_REG, dvsr);
 }
 
 void PwmCore::set_duty(int duty, int channel) {
    uint32_t d;
 
-   if (duty > MAX) {
-      d = MAX;
-   } else {
-      d = duty;
-   }
-   io_write(base_addr, DUTY_REG_BASE + channel, d);
+   if (!channel_ok(channel))
+      return;
+   d = duty_val(duty);
+   if (regs.update(DUTY_REG_BASE + channel, d))
+      io_write_or_queue(batch, base_addr, DUTY_REG_BASE + channel, d);
 }
 
 void PwmCore::set_duty(double f, int channel) {
    int duty;
    duty = (int) (f * MAX);
-   debug("set_duty_f: ", f, duty);
+   LOG_TRACE("pwm ch {} duty {:.3} = {}", channel, f, duty);
    set_duty(duty, channel);
 }
 
+unsigned long PwmCore::suppressed_writes() {
+   return (regs.suppressed());
+}
+
+void PwmCore::invalidate() {
+   regs.invalidate();
+}
+
+void PwmCore::set_batch(IoBatch *b) {
+   batch = b;
+}
+
@@ -13,6 +13,8 @@
 #define _GPIO_H_INCLUDED
 
 #include "chu_init.h"
+#include "chu_io_shadow.h"
+#include "chu_io_batch.h"
 
 /**********************************************************************
  * gpi (general-purpose input) core driver
@@ -32,7 +34,7 @@ public:
     *
     */
    enum {
-      DATA_REG = 0 /**< input data register */
+      DATA_REG = GPI_DATA_REG /**< input data register */
    };
    /**
     * constructor.
@@ -81,7 +83,7 @@ public:
     *
     */
    enum {
-      DATA_REG = 0 /**< output data register */
+      DATA_REG = GPO_DATA_REG /**< output data register */
    };
    /**
     * constructor.
@@ -106,9 +108,30 @@ public:
     */
    void write(int bit_value, int bit_pos);
 
+   /**
+    * number of writes dropped because the data register already held
+    * the value (core reads back 0, so the driver keeps a shadow copy)
+    * @return # suppressed writes
+    */
+   unsigned long suppressed_writes();
+
+   /**
+    * forget the shadow copy; next write goes to the core
+    * @note use after the core is reset outside the driver
+    */
+   void invalidate();
+
+   /**
+    * queue register writes into a batch instead of writing the core
+    * @param b batch flushed by the caller; 0 for immediate writes
+    */
+   void set_batch(IoBatch *b);
+
 private:
    uint32_t base_addr;
    uint32_t wr_data;      // same as GPO core data reg
+   IoShadow<1> regs;      // last value written to data reg
+   IoBatch *batch;        // 0: write immediately
 };
 
 
@@ -131,8 +154,8 @@ public:
     *
     */
    enum {
-      DVSR_REG = 0,         /**< pwm divisor register */
-      DUTY_REG_BASE = 0x10  /**< channel 0 duty cycle register */
+      DVSR_REG = PWM_DVSR_REG,          /**< pwm divisor register */
+      DUTY_REG_BASE = PWM_DUTY_REG_BASE /**< channel 0 duty cycle register */
    };
    /**
     * symbolic constant
@@ -151,6 +174,22 @@ public:
    PwmCore(uint32_t core_base_addr);
    ~PwmCore();
 
+   /* register values (also used by slot_cores.h) */
+   /** divisor register value of a switching frequency */
+   static uint32_t freq_dvsr(int freq) {
+      return ((uint32_t) SYS_CLK_FREQ * 1000000 / MAX / freq);
+   }
+
+   /** duty register value, saturated at MAX */
+   static uint32_t duty_val(int duty) {
+      return ((duty > MAX) ? (uint32_t) MAX : (uint32_t) duty);
+   }
+
+   /** 1 if channel has a duty register */
+   static int channel_ok(int channel) {
+      return (channel >= 0 && channel < PWM_DUTY_REG_BASE_COUNT);
+   }
+
    /* methods */
    /**
     * set pwm switching frequency
@@ -165,6 +204,7 @@ public:
     *
     * @param duty duty cycle (between 0 and MAX)
     * @param channel pwm channel number
+    * @note a channel outside 0 to PWM_DUTY_REG_BASE_COUNT-1 is ignored
     *
     */
    void set_duty(int duty, int channel);
@@ -178,9 +218,30 @@ public:
     */
    void set_duty(double f, int channel);
 
+   /**
+    * number of divisor/duty writes dropped because the register
+    * already held the value
+    * @return # suppressed writes
+    */
+   unsigned long suppressed_writes();
+
+   /**
+    * forget the shadow copies; next write of each register goes to the core
+    * @note use after the core is reset outside the driver
+    */
+   void invalidate();
+
+   /**
+    * queue register writes into a batch instead of writing the core
+    * @param b batch flushed by the caller; 0 for immediate writes
+    */
+   void set_batch(IoBatch *b);
+
 private:
    uint32_t base_addr;
    uint32_t freq;
+   IoShadow<DUTY_REG_BASE + PWM_DUTY_REG_BASE_COUNT> regs;   // divisor and duty regs
+   IoBatch *batch;        // 0: write immediately
 };
 
 
@@ -203,8 +264,8 @@ public:
     *
     */
    enum {
-      NORMAL_DATA_REG = 0, /**< un-treated input data register */
-      DB_DATA_REG = 1      /**< debounced input data register */
+      NORMAL_DATA_REG = DEBOUNCE_NORMAL_DATA_REG, /**< un-treated input data register */
+      DB_DATA_REG = DEBOUNCE_DB_DATA_REG          /**< debounced input data register */
    };
    /**
     * constructor.
@@ -1,4 +1,11 @@
+// log threshold of this file; per-byte trace with -DI2C_LOG_LEVEL=4
+#ifndef I2C_LOG_LEVEL
+#define I2C_LOG_LEVEL LOG_LEVEL
+#endif
+#define LOG_MODULE_LEVEL I2C_LOG_LEVEL
+
 #include "i2c_core.h"
+#include "chu_log.h"
 
 /* methods */
 I2cCore::I2cCore(uint32_t core_base_addr) {
@@ -9,16 +16,13 @@ I2cCore::~I2cCore() {
 }                  // not used
 
 void I2cCore::set_freq(int freq) {
-   uint32_t dvsr;
-
    // 25% of i2c period = (1/freq)/4; sys clock period = 1/f_sys
    // dvsr = # sys clocks =  ((1/freq)/4)/(1/f_sys) = f_sys/freq/4
-   dvsr = (uint32_t) (SYS_CLK_FREQ * 1000000 / freq / 4);
-   io_write(base_addr, DVSR_REG, dvsr);
+   io_write(base_addr, DVSR_REG, freq_dvsr(freq));
 }
 
 int I2cCore::ready() {
-   return ((int) (io_read(base_addr,RD_REG) >> 8) & 0x01);
+   return ((int) io_read_field(base_addr, i2c_regs::READY));
 }
 
 void I2cCore::start() {
@@ -48,12 +52,15 @@ int I2cCore::write_byte(uint8_t data) {
    io_write(base_addr, WR_REG, acc_data);
    while (!ready()) {
    }
-   ack = (io_read(base_addr, RD_REG) & 0x0200) >> 9;
+   ack = io_read_field(base_addr, i2c_regs::ACK);
+   LOG_TRACE("i2c wr {:02x} ack {}", data, ack);
    if (ack == 0)
       return (0);
-   else
+   else {
       // slave fails to ack
+      LOG_WARN("i2c no ack for {:02x}", data);
       return (-1);
+   }
 }
 
 //last: last byte in read cycle (0:no; 1:yes)
@@ -67,52 +74,18 @@ int I2cCore::read_byte(int last) {
    io_write(base_addr, WR_REG, acc_data);
    while (!ready()) {
    }
-   return (io_read(base_addr, RD_REG) & 0x00ff);
+   return ((int) io_read_field(base_addr, i2c_regs::DOUT));
 }
 
 
 int I2cCore::read_transaction(uint8_t dev, uint8_t *bytes, int num,
       int rstart) {
-   uint8_t dev_byte;
-   int ack1;
-   int i;
-
-   dev_byte = (dev << 1) | 0x01;   // LSB=1 for I2c read
-   start();
-   ack1 = write_byte(dev_byte);    // send device id/read
-   for (i = 0; i < (num - 1); i++) {
-      *bytes = read_byte(0);
-      bytes++;
-   }
-   *bytes = read_byte(1);   // last byte in read cycle
-   if (rstart == 1) {
-      restart();
-   } else {
-      stop();
-   }
-   return (ack1);
+   return (i2c_read_transaction(*this, dev, bytes, num, rstart));
 }
 
 int I2cCore::write_transaction(uint8_t dev, uint8_t *bytes, int num,
       int rstart) {
-   uint8_t dev_byte;
-   int ack1, ack;
-   int i;
-
-   dev_byte = (dev << 1);   // LSB=0 for I2c write
-   start();
-   ack = write_byte(dev_byte);  // send device id/write
-   for (i = 0; i < num; i++) {
-      ack1 = write_byte(*bytes);
-      ack = ack + ack1;
-      bytes++;
-   }
-   if (rstart == 1) {
-      restart();
-   } else {
-      stop();
-   }
-   return (ack);
+   return (i2c_write_transaction(*this, dev, bytes, num, rstart));
 }
 
 
@@ -31,6 +31,7 @@
  *
  */
 class I2cCore {
+public:
    /**
     * Register map
     *
@@ -42,22 +43,21 @@ class I2cCore {
     * bits 8: ready
     */
    enum {
-      DVSR_REG = 0, /**< i2c clock divisor register */
-      WR_REG = 1,   /**< write data/command register */
-      RD_REG = 0    /**< read data/status register */
+      DVSR_REG = I2C_DVSR_REG, /**< i2c clock divisor register */
+      WR_REG = I2C_WR_REG,     /**< write data/command register */
+      RD_REG = I2C_RD_REG      /**< read data/status register */
    };
    /**
     * Symbolic commands
     *
     */
    enum {
-      I2C_START_CMD = 0x00 << 8,
-      I2C_WR_CMD = 0x01 << 8,
-      I2C_RD_CMD = 0x02 << 8,
-      I2C_STOP_CMD = 0x03 << 8,
-      I2C_RESTART_CMD = 0x04 << 8
+      I2C_START_CMD = I2C_CMD_START << I2C_CMD_LSB,
+      I2C_WR_CMD = I2C_CMD_WR << I2C_CMD_LSB,
+      I2C_RD_CMD = I2C_CMD_RD << I2C_CMD_LSB,
+      I2C_STOP_CMD = I2C_CMD_STOP << I2C_CMD_LSB,
+      I2C_RESTART_CMD = I2C_CMD_RESTART << I2C_CMD_LSB
    };
-public:
    /* methods */
    /**
     * Constructor
@@ -67,6 +67,14 @@ public:
    I2cCore(uint32_t core_base_addr);
    ~I2cCore();                  // not used
 
+   /**
+    * divisor register value of an sclk frequency (also used by
+    * slot_cores.h): 25% of the i2c period in sys clocks
+    */
+   static uint32_t freq_dvsr(int freq) {
+      return ((uint32_t) (SYS_CLK_FREQ * 1000000 / freq / 4));
+   }
+
    /**
     * set i2c clock (sclk) frequency
     *
@@ -159,6 +167,45 @@ private:
 
 };
 
+/**
+ * read/write transaction on any driver with the I2cCore byte commands
+ * (I2cCore and SlotI2cCore<>); see I2cCore::read_transaction()
+ */
+template <class C>
+int i2c_read_transaction(C &core, uint8_t dev, uint8_t *bytes, int num, int rstart) {
+   int ack1, i;
+
+   core.start();
+   ack1 = core.write_byte((dev << 1) | 0x01);   // LSB=1 for I2c read
+   for (i = 0; i < (num - 1); i++) {
+      *bytes = core.read_byte(0);
+      bytes++;
+   }
+   *bytes = core.read_byte(1);   // last byte in read cycle
+   if (rstart == 1)
+      core.restart();
+   else
+      core.stop();
+   return (ack1);
+}
+
+template <class C>
+int i2c_write_transaction(C &core, uint8_t dev, uint8_t *bytes, int num, int rstart) {
+   int ack, i;
+
+   core.start();
+   ack = core.write_byte(dev << 1);   // LSB=0 for I2c write
+   for (i = 0; i < num; i++) {
+      ack = ack + core.write_byte(*bytes);
+      bytes++;
+   }
+   if (rstart == 1)
+      core.restart();
+   else
+      core.stop();
+   return (ack);
+}
+
 #endif  //_I2C_CORE_H_INCLUDED
 
 
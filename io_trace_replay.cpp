@@ -0,0 +1,206 @@
+// Replays a captured io access trace (chu_io_trace.h) through the
+// simulated FPro bus.
+//
+// build:
+//   g++ -O2 -I. io_trace_replay.cpp chu_io_sim.cpp -o io_trace_replay
+// capture (board running a -D_IO_TRACE_USED build; send 't' to dump):
+//   stty -F /dev/ttyUSB1 921600 raw && cat /dev/ttyUSB1 > trace.bin
+// run:
+//   ./io_trace_replay [-v] [-u] trace.bin
+//     -v  print every access: tick, slot, reg, r/w, data, model data
+//     -u  print the uart tx bytes produced by the replayed writes
+//
+// - the stream is located by its "IOTR" header, so the capture may
+//   contain other uart output before and after it
+// - each access is issued when the bus clock reaches its recorded tick
+//   (relative to the first record); an access the model cannot issue
+//   in time (bus clock already past the tick) is counted as late
+// - read data of the model is compared with the recorded data; a
+//   mismatch means the model (or the hardware) behaves differently,
+//   e.g., a core ready earlier than modeled; slot 0 (timer) reads
+//   return absolute counts and are expected to differ
+// - the report lists accesses and mismatches per slot, the longest gap
+//   between two accesses and the access rate
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "chu_io_sim.h"
+
+#define TRACE_MAGIC      0x52544f49   // "IOTR"
+#define TRACE_VERSION    1
+#define TRACE_REC_SIZE   12
+#define TRACE_WR_BIT     31
+#define MAX_MISMATCH_MSG 10           // mismatches printed without -v
+
+struct TraceRec {
+   uint64_t tick;     // unwrapped timer count
+   uint32_t offset;   // word offset from BRIDGE_BASE
+   int wr;
+   uint32_t data;
+};
+
+static uint32_t get_u32(const unsigned char *p) {
+   return ((uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 |
+           (uint32_t) p[3] << 24);
+}
+
+// locate and check the stream; return # records or -1
+static int decode(const std::vector<unsigned char> &buf, std::vector<TraceRec> &recs,
+                  unsigned long *lost, int *clk_mhz) {
+   size_t pos, i, n, len;
+   uint32_t sum, hdr, raw_tick, prev_tick = 0;
+   uint64_t tick = 0;
+   const unsigned char *p;
+   TraceRec r;
+
+   for (pos = 0; pos + 16 <= buf.size(); pos++) {
+      if (get_u32(&buf[pos]) == TRACE_MAGIC)
+         break;
+   }
+   if (pos + 16 > buf.size()) {
+      fprintf(stderr, "no trace header found\n");
+      return (-1);
+   }
+   p = &buf[pos];
+   hdr = get_u32(p + 4);
+   if ((hdr & 0xff) != TRACE_VERSION || ((hdr >> 8) & 0xff) != TRACE_REC_SIZE) {
+      fprintf(stderr, "unsupported trace version %u\n", hdr & 0xff);
+      return (-1);
+   }
+   *clk_mhz = (int) (hdr >> 16);
+   n = get_u32(p + 8);
+   *lost = get_u32(p + 12);
+   len = 16 + n * TRACE_REC_SIZE + 4;
+   if (pos + len > buf.size()) {
+      fprintf(stderr, "trace truncated (%lu of %lu bytes)\n",
+              (unsigned long) (buf.size() - pos), (unsigned long) len);
+      return (-1);
+   }
+   sum = 0;
+   for (i = 0; i < len - 4; i += 4)
+      sum = sum + get_u32(p + i);
+   if (sum != get_u32(p + len - 4)) {
+      fprintf(stderr, "trace checksum error\n");
+      return (-1);
+   }
+   for (i = 0; i < n; i++) {
+      const unsigned char *q = p + 16 + i * TRACE_REC_SIZE;
+
+      raw_tick = get_u32(q);
+      // 32-bit tick wraps every 2^32 clocks; a backward step is a timer clear
+      if (i > 0 && raw_tick - prev_tick < 0x80000000u)
+         tick = tick + (raw_tick - prev_tick);
+      prev_tick = raw_tick;
+      r.tick = tick;
+      r.offset = get_u32(q + 4) & ~(1u << TRACE_WR_BIT);
+      r.wr = (int) (get_u32(q + 4) >> TRACE_WR_BIT);
+      r.data = get_u32(q + 8);
+      recs.push_back(r);
+   }
+   return ((int) n);
+}
+
+int main(int argc, char **argv) {
+   const char *path = 0;
+   int verbose = 0, show_uart = 0, clk_mhz = SYS_CLK_FREQ;
+   unsigned long lost = 0, late = 0, n_mis = 0;
+   unsigned long rd[SimBus::N_SLOT] = {0}, wr[SimBus::N_SLOT] = {0}, mis[SimBus::N_SLOT] = {0};
+   uint64_t start, target, late_max = 0, gap, gap_max = 0, span;
+   size_t gap_at = 0;
+   std::vector<unsigned char> buf;
+   std::vector<TraceRec> recs;
+   FILE *fp;
+   int c, n, slot;
+
+   for (int i = 1; i < argc; i++) {
+      if (strcmp(argv[i], "-v") == 0)
+         verbose = 1;
+      else if (strcmp(argv[i], "-u") == 0)
+         show_uart = 1;
+      else
+         path = argv[i];
+   }
+   if (path == 0) {
+      fprintf(stderr, "usage: %s [-v] [-u] trace.bin\n", argv[0]);
+      return (2);
+   }
+   fp = fopen(path, "rb");
+   if (fp == 0) {
+      perror(path);
+      return (2);
+   }
+   while ((c = fgetc(fp)) != EOF)
+      buf.push_back((unsigned char) c);
+   fclose(fp);
+   n = decode(buf, recs, &lost, &clk_mhz);
+   if (n < 0)
+      return (1);
+   if (clk_mhz != SYS_CLK_FREQ)
+      printf("note: trace recorded at %d MHz; replayed at %d MHz\n", clk_mhz, SYS_CLK_FREQ);
+
+   SimBus &bus = sim_bus();
+   bus.uart.set_echo(0);
+   start = bus.cycle();
+   for (size_t i = 0; i < recs.size(); i++) {
+      const TraceRec &r = recs[i];
+      uint32_t addr = BRIDGE_BASE + 4 * r.offset, data;
+
+      target = start + r.tick - recs[0].tick;
+      if (bus.cycle() <= target) {
+         bus.advance(target - bus.cycle());
+      } else {
+         late++;
+         if (bus.cycle() - target > late_max)
+            late_max = bus.cycle() - target;
+      }
+      if (i > 0) {
+         gap = r.tick - recs[i - 1].tick;
+         if (gap > gap_max) {
+            gap_max = gap;
+            gap_at = i;
+         }
+      }
+      slot = (int) (r.offset >> 5) & (SimBus::N_SLOT - 1);
+      if (r.wr) {
+         bus.write(addr, r.data);
+         wr[slot]++;
+         data = r.data;
+      } else {
+         data = bus.read(addr);
+         rd[slot]++;
+         if (data != r.data) {
+            mis[slot]++;
+            if (slot != S0_SYS_TIMER && n_mis++ < MAX_MISMATCH_MSG && !verbose)
+               printf("mismatch: tick %llu slot %d reg %d: trace 0x%08x, model 0x%08x\n",
+                      (unsigned long long) r.tick, slot, (int) (r.offset & 0x1f),
+                      r.data, data);
+         }
+      }
+      if (verbose)
+         printf("%12llu %2d %2d %c 0x%08x 0x%08x%s\n", (unsigned long long) r.tick, slot,
+                (int) (r.offset & 0x1f), r.wr ? 'w' : 'r', r.data, data,
+                (!r.wr && data != r.data) ? " *" : "");
+   }
+   bus.uart.drain();
+
+   span = recs.empty() ? 0 : recs.back().tick - recs[0].tick;
+   printf("records %d (%lu overwritten before dump), span %llu clocks (%.3f ms)\n", n, lost,
+          (unsigned long long) span, (double) span / (clk_mhz * 1000.0));
+   printf("  slot      rd      wr  mismatch\n");
+   for (int i = 0; i < SimBus::N_SLOT; i++) {
+      if (rd[i] || wr[i])
+         printf("%6d%8lu%8lu%10lu\n", i, rd[i], wr[i], mis[i]);
+   }
+   if (span > 0)
+      printf("rate %.1f accesses/ms\n", (double) n * clk_mhz * 1000.0 / span);
+   if (n > 1)
+      printf("longest gap %llu clocks before record %lu (slot %d reg %d)\n",
+             (unsigned long long) gap_max, (unsigned long) gap_at,
+             (int) (recs[gap_at].offset >> 5) & 0x3f, (int) (recs[gap_at].offset & 0x1f));
+   printf("late %lu (max %llu clocks)\n", late, (unsigned long long) late_max);
+   if (show_uart)
+      printf("uart tx:\n%s\n", bus.uart.tx_log().c_str());
+   return (0);
+}
@@ -0,0 +1,296 @@
+// Renders the deferred log records (chu_log.h) of a -D_LOG_USED build.
+//
+// build:
+//   g++ -O2 -I. log_decode.cpp -o log_decode
+// capture (board running main_sampler_test built with -D_LOG_USED):
+//   stty -F /dev/ttyUSB1 921600 raw && cat /dev/ttyUSB1 > log.bin
+// run:
+//   ./log_decode [-b baud] [-l n] log.bin|tty src.cpp ...
+//     src.cpp  sources of the build; their LOG_ERROR/WARN/INFO/TRACE("...")
+//              strings form the string table (e.g., *.cpp *.h)
+//     -b       baud rate of a tty (default 921600; raw mode; Ctrl-C ends)
+//     -l n     show levels up to n only (1 error ... 4 trace)
+//
+// - one line per record: time in us since the first record (unwrapped
+//   from the 32-bit tick at SYS_CLK_FREQ MHz), level (E/W/I/T) and the
+//   message rendered with the chu_print.h format of its string;
+//   unknown ids print the raw words
+// - the table is keyed by the same compile-time hash as the target
+//   (log_hash()); two strings with the same hash are reported
+// - text in the stream (e.g., the 's' report) is skipped: the longest
+//   valid tail of a chunk is taken; other frames (e.g., telemetry)
+//   fail the crc and are counted as bad chunks
+// - statistics on stderr: records, unknown ids, bad chunks and records
+//   dropped on target (ring full)
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "chu_log.h"
+
+static volatile sig_atomic_t stop = 0;
+
+static void on_sigint(int) {
+   stop = 1;
+}
+
+static speed_t baud2speed(long baud) {
+   switch (baud) {
+   case 9600:   return (B9600);
+   case 19200:  return (B19200);
+   case 38400:  return (B38400);
+   case 57600:  return (B57600);
+   case 115200: return (B115200);
+   case 230400: return (B230400);
+   case 460800: return (B460800);
+   case 921600: return (B921600);
+   default:     return (0);
+   }
+}
+
+// raw 8N1 at baud; returns -1 on error
+static int set_raw(int fd, long baud) {
+   struct termios t;
+   speed_t sp = baud2speed(baud);
+
+   if (sp == 0) {
+      fprintf(stderr, "unsupported baud rate %ld\n", baud);
+      return (-1);
+   }
+   if (tcgetattr(fd, &t) < 0) {
+      perror("tcgetattr");
+      return (-1);
+   }
+   cfmakeraw(&t);
+   cfsetispeed(&t, sp);
+   cfsetospeed(&t, sp);
+   t.c_cc[VMIN] = 1;
+   t.c_cc[VTIME] = 0;
+   if (tcsetattr(fd, TCSANOW, &t) < 0) {
+      perror("tcsetattr");
+      return (-1);
+   }
+   return (0);
+}
+
+// C string literal(s) starting at s[i] == '"'; adjacent literals are joined
+static std::string literal(const std::string &s, size_t i) {
+   std::string out;
+
+   while (i < s.size() && s[i] == '"') {
+      for (i++; i < s.size() && s[i] != '"'; i++) {
+         if (s[i] != '\\' || i + 1 >= s.size()) {
+            out += s[i];
+            continue;
+         }
+         i++;
+         switch (s[i]) {
+         case 'n':  out += '\n'; break;
+         case 'r':  out += '\r'; break;
+         case 't':  out += '\t'; break;
+         case 'x':
+            out += (char) strtol(s.substr(i + 1, 2).c_str(), 0, 16);
+            i = i + 2;
+            break;
+         default:   out += s[i]; break;
+         }
+      }
+      for (i++; i < s.size() && (s[i] == ' ' || s[i] == '\t' || s[i] == '\r' ||
+                                 s[i] == '\n'); i++) {
+      }
+   }
+   return (out);
+}
+
+// add the LOG_xxx("...") strings of a source file; returns -1 on error
+static int scan(const char *path, std::map<uint32_t, std::string> &table) {
+   static const char *const macros[] = {"ERROR", "WARN", "INFO", "TRACE"};
+   std::string s, fmt, name;
+   size_t pos, i;
+   uint32_t id;
+   FILE *fp;
+   int c, err = 0;
+
+   fp = fopen(path, "rb");
+   if (fp == 0) {
+      perror(path);
+      return (-1);
+   }
+   while ((c = fgetc(fp)) != EOF)
+      s += (char) c;
+   fclose(fp);
+   for (pos = s.find("LOG_"); pos != std::string::npos; pos = s.find("LOG_", pos + 4)) {
+      if (pos > 0 && (isalnum((unsigned char) s[pos - 1]) || s[pos - 1] == '_'))
+         continue;
+      for (i = pos + 4; i < s.size() && isupper((unsigned char) s[i]); i++) {
+      }
+      name = s.substr(pos + 4, i - pos - 4);
+      if (i >= s.size() || s[i] != '(')
+         continue;
+      if (name != macros[0] && name != macros[1] && name != macros[2] && name != macros[3])
+         continue;
+      for (i++; i < s.size() && (s[i] == ' ' || s[i] == '\t'); i++) {
+      }
+      if (i >= s.size() || s[i] != '"')
+         continue;   // e.g., the macro definition
+      fmt = literal(s, i);
+      id = log_hash(fmt.c_str());
+      if (table.count(id) && table[id] != fmt) {
+         fprintf(stderr, "%s: id 0x%08x of \"%s\" also used by \"%s\"\n", path, id,
+                 fmt.c_str(), table[id].c_str());
+         err = -1;
+      }
+      table[id] = fmt;
+   }
+   return (err);
+}
+
+class Decoder {
+public:
+   unsigned long records, unknown, bad, dropped;
+   const std::map<uint32_t, std::string> *table;
+   int max_level;
+
+   Decoder() {
+      records = unknown = bad = dropped = 0;
+      table = 0;
+      max_level = LOG_LEVEL_TRACE;
+      tick = 0;
+      prev_tick = 0;
+   }
+
+   // one byte of the stream
+   void put(uint8_t b) {
+      if (b != 0) {
+         chunk.push_back(b);
+         return;
+      }
+      if (!chunk.empty())
+         record();
+      chunk.clear();
+   }
+
+private:
+   std::vector<uint8_t> chunk;
+   uint64_t tick;
+   uint32_t prev_tick;
+
+   // payload of a frame; -1 if malformed
+   static int payload(const uint8_t *in, int n, uint8_t *pl) {
+      int len;
+
+      if (n > LOG_FRAME_MAX)
+         return (-1);
+      len = telem_cobs_decode(in, n, pl);
+      if (len < 1 + 4 * LOG_HDR_WORDS + 2 || (len - 3) % 4 != 0)
+         return (-1);
+      if (telem_crc16(pl, len - 2, 0xffff) != (uint16_t) (pl[len - 2] | pl[len - 1] << 8))
+         return (-1);
+      if ((int) (pl[9] & 0x0f) != (len - 3) / 4)
+         return (-1);   // word count of the record header
+      return (len);
+   }
+
+   void record() {
+      uint8_t pl[LOG_FRAME_MAX];
+      uint32_t rec[LOG_REC_MAX];
+      char msg[256];
+      int len = -1, n, i, level;
+      size_t k;
+      std::map<uint32_t, std::string>::const_iterator it;
+
+      // text before a frame: the frame is the longest valid tail
+      for (k = 0; k < chunk.size() && len < 0; k++)
+         len = payload(&chunk[k], (int) (chunk.size() - k), pl);
+      if (len < 0) {
+         bad++;
+         return;
+      }
+      n = (len - 3) / 4;
+      for (i = 0; i < n; i++)
+         rec[i] = (uint32_t) pl[1 + 4 * i] | (uint32_t) pl[2 + 4 * i] << 8 |
+                  (uint32_t) pl[3 + 4 * i] << 16 | (uint32_t) pl[4 + 4 * i] << 24;
+      if (pl[0]) {
+         printf("-- %d record(s) dropped --\n", pl[0]);
+         dropped = dropped + pl[0];
+      }
+      if (records > 0)
+         tick = tick + (uint32_t) (rec[1] - prev_tick);
+      prev_tick = rec[1];
+      records++;
+      level = (int) (rec[2] >> 4) & 0x0f;
+      if (level > max_level)
+         return;
+      it = table->find(rec[0]);
+      len = (it == table->end()) ? -1 :
+            log_render(msg, sizeof(msg) - 1, it->second.c_str(), rec, n);
+      printf("%14.3f %c ", (double) tick / SYS_CLK_FREQ, "?EWIT"[(level <= 4) ? level : 0]);
+      if (len < 0) {
+         unknown++;
+         printf("? id 0x%08x:", rec[0]);
+         for (i = LOG_HDR_WORDS; i < n; i++)
+            printf(" 0x%08x", rec[i]);
+         printf("\n");
+         return;
+      }
+      // one line per record
+      while (len > 0 && (msg[len - 1] == '\n' || msg[len - 1] == '\r'))
+         len--;
+      msg[len] = '\0';
+      printf("%s\n", msg);
+   }
+};
+
+int main(int argc, char **argv) {
+   const char *path = 0;
+   long baud = 921600;
+   std::map<uint32_t, std::string> table;
+   Decoder dec;
+   uint8_t buf[256];
+   ssize_t n;
+   int fd;
+
+   for (int i = 1; i < argc; i++) {
+      if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+         baud = atol(argv[++i]);
+      else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+         dec.max_level = atoi(argv[++i]);
+      else if (path == 0)
+         path = argv[i];
+      else if (scan(argv[i], table) < 0)
+         return (2);
+   }
+   if (path == 0 || table.empty()) {
+      fprintf(stderr, "usage: %s [-b baud] [-l level] log.bin|tty src.cpp ...\n", argv[0]);
+      return (2);
+   }
+   fd = open(path, O_RDONLY | O_NOCTTY);
+   if (fd < 0) {
+      perror(path);
+      return (2);
+   }
+   if (isatty(fd)) {
+      if (set_raw(fd, baud) < 0)
+         return (2);
+      signal(SIGINT, on_sigint);
+   }
+   dec.table = &table;
+   while (!stop && (n = read(fd, buf, sizeof(buf))) > 0) {
+      for (ssize_t i = 0; i < n; i++)
+         dec.put(buf[i]);
+      fflush(stdout);
+   }
+   close(fd);
+   fprintf(stderr, "strings %lu, records %lu, unknown ids %lu, bad chunks %lu, dropped %lu\n",
+           (unsigned long) table.size(), dec.records, dec.unknown, dec.bad, dec.dropped);
+   return (0);
+}
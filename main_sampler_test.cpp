@@ -5,265 +5,210 @@
 #include "xadc_core.h"
 #include "sseg_core.h"
 #include "i2c_core.h"
+#include "chu_io_stat.h"
+#include "chu_io_trace.h"
+#include "chu_prof.h"
+#include "chu_sched.h"
+#include "wdt_core.h"
+#include "chu_print.h"
+#include "chu_report.h"
+#include "chu_telem.h"
+#include "chu_log.h"
+#include "temp_monitor.h"
+
+// io transaction budget per 200 ms frame (checked with -D_IO_STATS_USED)
+// reads are dominated by I2cCore::ready() polling during ADT7420 access;
+// scheduler slots are not counted: timer polling and one watchdog kick
+// per task run and per idle (about 55 writes per frame); neither is the
+// uart, whose tx drain follows the amount of console text (about 46
+// writes per frame, and a report would push the next frame over budget)
+// writes: about 25 per frame (sseg 8, pwm 8, i2c 9) at steady
+// temperatures; all digits and colors changing at every display run
+// stays below 64
+#define FRAME_RD_BUDGET 16000
+#define FRAME_WR_BUDGET 64
+// console rate (fractional baud divisor: 921659 baud, +64 ppm)
+#define CONSOLE_BAUD 921600
+// watchdog timeout; above the longest task plus the 20 ms input period
+#define WDT_TIMEOUT TimerCore::ms2tick(1000)
 
-// reads either SW0-6 or SW8-14 based on segsSel input and returns SW value
-// this is used at the temperature limit input
-int getTempLimit(GpiCore *sw_p, int segsSel) {
-   int s, limit;
-
-   s = sw_p->read();
-   if (segsSel == 1) {
-      limit = (s >> 8) & 0x7f;
-   } else {
-      limit = s & 0x7f; 
-   }
-   return limit;
+GpoCore led(get_slot_addr(BRIDGE_BASE, S2_LED));
+GpiCore sw(get_slot_addr(BRIDGE_BASE, S3_SW));
+XadcCore adc(get_slot_addr(BRIDGE_BASE, S5_XDAC));
+PwmCore pwm(get_slot_addr(BRIDGE_BASE, S6_PWM));
+SsegCore sseg(get_slot_addr(BRIDGE_BASE, S8_SSEG));
+I2cCore adt7420(get_slot_addr(BRIDGE_BASE, S10_I2C));
+WdtCore wdt(get_slot_addr(BRIDGE_BASE, S4_WDT));
+IoBatch out;   // led/pwm/sseg writes of one task run
+Scheduler sched;
+
+// internal temp is Left digits 4-7 and RGB, external temp is Right digits 0-3 and RGB
+// Left=1, Right=0
+static int intLimit, extLimit, intIsFer, extIsFer;
+static float intTempC, extTempC;
+static int telemOn;   // 1: binary telemetry frames instead of text lines
+
+// switches: limits (mirrored on the LEDs) and C/F format
+static void inputTask(void *) {
+   intLimit = getTempLimit(&sw, 1);
+   extLimit = getTempLimit(&sw, 0);
+   dispTempLimit(&led, extLimit, intLimit);
+   intIsFer = getTempFormat(&sw, 1);
+   extIsFer = getTempFormat(&sw, 0);
+   out.flush();
 }
 
-// Shifts the upper limit 8 bits to the left and combines with the lower limit and combines them.
-// They are then output to the LEDs to mirror SW0-6 anf SW8-14
-void dispTempLimit(GpoCore *led_p, int lowerLim, int upperLim) {
-   int ledDisp = 0;
-
-   ledDisp = ledDisp | (lowerLim & 0x7f);
-   ledDisp = ledDisp | ((upperLim & 0x7f) << 8);
-   led_p->write(ledDisp);
+static void intTempTask(void *) {
+   if (telemOn)
+      intTempC = (float) adc.read_fpga_temp();
+   else
+      intTempC = getIntTempC(&adc);
 }
 
-// reads either SW7 or SW5 based on segsSel input and returns SW value
-// this is used at the temperature format select
-int getTempFormat(GpiCore *sw_p, int segsSel) {
-   int s;
-   if (segsSel == 1) {
-      s = sw_p->read(15);
-   } else {
-      s = sw_p->read(7);
-   }
-   return s;
+// runs after intTempTask in the same release: one frame with both readings
+static void extTempTask(void *) {
+   TelemSample s[2];
+   int code;
 
-}
-
-// sets a RGB to red if color = 1, or green if color = 0. rgbPos determines which RGB is set.
-// Used to display if a temperature surpassed the user selected limit
-void setRGB(PwmCore *pwm_p, int color, int rgbPos) {
-   double bright, duty;
-   bright = 30.0; // 30% brightness
-   duty = bright / 100.0;
-   
-   if (rgbPos == 1) {
-      for (int n = 0; n < 3; n++) {
-         pwm_p->set_duty(0.0, n + 3);
-      }
-      pwm_p->set_duty(duty, color + 4);
-   } else {
-      for (int n = 0; n < 3; n++) {
-         pwm_p->set_duty(0.0, n);
-      }
-      pwm_p->set_duty(duty, color + 1);
+   if (!telemOn) {
+      extTempC = getExtTempC(&adt7420);
+      return;
    }
+   code = readExtTempCode(&adt7420);
+   extTempC = (float) code / 16;
+   s[0].ch = TELEM_CH_FPGA_TEMP;
+   s[0].frac_bits = 6;   // XADC step about 0.12 C; range +-512 C
+   s[0].v = (int32_t) (intTempC * 64 + ((intTempC < 0) ? -0.5f : 0.5f));
+   s[1].ch = TELEM_CH_EXT_TEMP;
+   s[1].frac_bits = 4;   // ADT7420 code as is
+   s[1].v = code;
+   telem_send(s, 2);
 }
 
-// Reads the Temperature from the XADC Cores, and outputs it as a float
-// Used as the internal temperature
-float getIntTempC(XadcCore *adc_p) {
-   double reading;
-   float tempC;
-
-      // display on-chip sensor and 4 channels in console
-      uart.disp("FPGA temp: ");
-      reading = adc_p->read_fpga_temp();
-      uart.disp(reading, 3);
-      uart.disp("\n\r");
-      tempC = (float) reading;
-      return tempC;
-}
-
-// Reads the Temperature from the I2C Cores, and outputs it as a float
-// Used as the external temperature
-float getExtTempC(I2cCore *adt7420_p) {
-   const uint8_t DEV_ADDR = 0x4b;
-   uint8_t wbytes[2], bytes[2];
-   //int ack;
-   uint16_t tmp;
-   float tmpC;
-
-   wbytes[0] = 0x00;
-   adt7420_p->write_transaction(DEV_ADDR, wbytes, 1, 1);
-   adt7420_p->read_transaction(DEV_ADDR, bytes, 2, 0);
-
-   // conversion
-   tmp = (uint16_t) bytes[0];
-   tmp = (tmp << 8) + (uint16_t) bytes[1];
-   if (tmp & 0x8000) {
-      tmp = tmp >> 3;
-      tmpC = (float) ((int) tmp - 8192) / 16;
-   } else {
-      tmp = tmp >> 3;
-      tmpC = (float) tmp / 16;
-   }
-   uart.disp("temperature (C): ");
-   uart.disp(tmpC);
-   uart.disp("\n\r");
-   return tmpC;
-}
+// RGB and 7-seg from the latest readings
+static void dispTask(void *) {
+   int intColor, extColor;
+   bool intIsHundred, extIsHundred;
 
-// Converts Celsius float to Fahrenheit float
-float cel2fer(float tmpC) {
-   float tmpF;
-   tmpF = (tmpC * (9.00f / 5.00f)) + 32.00f;
-   return tmpF;
+   intColor = (intTempC > intLimit) ? 1 : 0;   // Red : Green
+   extColor = (extTempC > extLimit) ? 1 : 0;
+   setRGB(&pwm, intColor, 1);
+   setRGB(&pwm, extColor, 0);
+   clearDisp(&sseg);
+   intIsHundred = dispTemp(&sseg, intTempC, cel2fer(intTempC), intIsFer, 1);
+   extIsHundred = dispTemp(&sseg, extTempC, cel2fer(extTempC), extIsFer, 0);
+   dispDp(&sseg, intIsHundred, extIsHundred);
+   out.flush();
 }
 
-// Clears all digits and decimal points on the seven segment display
-void clearDisp(SsegCore *sseg_p) {
-   // clear digits and dp
-   const uint8_t BLANK = 0xff;
-   for (int i = 0; i < 8; i++) {
-      sseg_p->write_1ptn(BLANK, i);
-   }
-   sseg_p->set_dp(0x00);
+// buffered uart output to the tx fifo (256 bytes, about 2.8 ms at 921600 baud)
+// with -D_LOG_USED: LOG_xxx() records first (decode with log_decode.cpp)
+static void txTask(void *) {
+#ifdef _LOG_USED
+   log_poll();
+#endif
+   uart.tx_poll();
 }
 
-// Displays the appripriate temperature based on user input (C or F). dislpays first decimal if double digit temp.
-// segsSel determines if it is on the right (0) or left (1) side of the sevensegment
-// displays whole number if triple digit temp. Outputs bool flagging if the displayed temp is at least 100
-bool dispTemp(SsegCore *sseg_p, float tmpC, float tmpF, int isFer, int segsSel) {
-   const uint8_t BLANK = 0xff;
-   int posAdj, tempInt, whole, hundreds, tens, ones, tenths;
-   bool isCel;
-   bool isHundred = false; 
-   float temp;
-
-   // segsSel = 0 -> right 4 digits, posAdj = 0
-   // segsSel = 1 -> left 4 digits, posAdj = 4
-   if (segsSel == 1) {
-      posAdj = 4;
-   } else {
-      posAdj = 0;
-   }
-
-   if (isFer == 1) {
-      isCel = false;
-      temp = tmpF;
-   } else {
-      isCel = true;
-      temp = tmpC;
-   }
-
-   if (temp < 0.00f) {
-      temp = 0.00f;
-   }
-
-   tempInt = (int)(temp * 10.00f + 0.50f);
-   if (temp >= 100.00f) {
-      whole = (int)(temp + 0.5f);
-   } else {
-      whole = tempInt / 10;
-   }
-   hundreds = (whole / 100) % 10;
-   tens = (whole / 10) % 10;
-   ones = whole % 10;
-   tenths = tempInt % 10;
-   
-   if (whole >= 100){
-      isHundred = true;
-   }
-
-   if (isHundred) {
-      sseg_p->write_1ptn(sseg_p->h2s(hundreds), 3+posAdj);
-      sseg_p->write_1ptn(sseg_p->h2s(tens), 2+posAdj);
-      sseg_p->write_1ptn(sseg_p->h2s(ones), 1+posAdj);
-   } else {
-      if (whole >= 10) {
-         sseg_p->write_1ptn(sseg_p->h2s(tens), 3+posAdj);
-      } else {
-         sseg_p->write_1ptn(BLANK, 3+posAdj);
+// uart commands: 's' task statistics; 't' io trace; 'p' profile;
+// 'b' text/binary telemetry (decode with telem_decode.cpp)
+static void cmdTask(void *) {
+   int cmd, mode;
+
+   while ((cmd = uart.rx_byte()) != -1) {
+      if (cmd == SCHED_CMD) {
+         // one block: the lines after the report must not be dropped
+         mode = report_begin();
+         sched.report();
+         fmt_print(uart, FMT_STR("uart tx dropped/peak {}/{}\n\r"),
+                   uart.tx_dropped(), uart.tx_peak());
+#ifdef _LOG_USED
+         fmt_print(uart, FMT_STR("log records dropped {}\n\r"), log_dropped());
+#endif
+         report_end(mode);
       }
-      sseg_p->write_1ptn(sseg_p->h2s(ones), 2+posAdj);
-      sseg_p->write_1ptn(sseg_p->h2s(tenths), 1+posAdj);
+      if (cmd == TELEM_CMD)
+         telemOn = !telemOn;
+#ifdef _IO_TRACE_USED
+      if (cmd == IO_TRACE_CMD)
+         io_trace_dump();
+#endif
+#ifdef _PROF_USED
+      if (cmd == PROF_CMD)
+         prof_report();
+#endif
    }
-
-   if (isCel) {
-      sseg_p->write_1ptn(sseg_p->h2s(0x0C), 0+posAdj);   // hex C pattern
-   } else {
-      sseg_p->write_1ptn(sseg_p->h2s(0x0F), 0+posAdj);   // hex F pattern
-   }
-   
-   return isHundred; 
 }
 
-// Properly places the decimal points on seven segment display based on the bool output from dispTemp()
-void dispDp(SsegCore *sseg_p, bool intIsHundred, bool extIsHundred) {
-    uint8_t dpPos;
-
-    if (intIsHundred && extIsHundred) { // both temps >= 100
-        dpPos = (1 << 1) | (1 << 5);
-    }
-    else if (intIsHundred && !extIsHundred) { // only internal temp >= 100
-        dpPos = (1 << 2) | (1 << 5);
-    }
-    else if (!intIsHundred && extIsHundred) { // only external temp >= 100
-        dpPos = (1 << 1) | (1 << 6);
-    }
-    else { // neither is >= 100
-        dpPos = (1 << 2) | (1 << 6);
-    }
-
-    sseg_p->set_dp(dpPos);
+#ifdef _IO_STATS_USED
+// report the first frame and any frame over budget; the timer (polled
+// while the scheduler idles), the watchdog (kicked by the scheduler) and
+// the uart (tx drain of the console text) are left out of the budget
+static void statTask(void *) {
+   static int frameCnt = 0;
+   unsigned long rd, wr;
+
+   rd = io_stat_reads(-1) - io_stat_reads(S0_SYS_TIMER) - io_stat_reads(S4_WDT) -
+        io_stat_reads(S1_UART1);
+   wr = io_stat_writes(-1) - io_stat_writes(S0_SYS_TIMER) - io_stat_writes(S4_WDT) -
+        io_stat_writes(S1_UART1);
+   if (frameCnt == 0 || rd > FRAME_RD_BUDGET || wr > FRAME_WR_BUDGET) {
+      io_stat_report();
+   }
+   io_stat_clear();
+   frameCnt++;
 }
-
-GpoCore led(get_slot_addr(BRIDGE_BASE, S2_LED));
-GpiCore sw(get_slot_addr(BRIDGE_BASE, S3_SW));
-XadcCore adc(get_slot_addr(BRIDGE_BASE, S5_XDAC));
-PwmCore pwm(get_slot_addr(BRIDGE_BASE, S6_PWM));
-SsegCore sseg(get_slot_addr(BRIDGE_BASE, S8_SSEG));
-I2cCore adt7420(get_slot_addr(BRIDGE_BASE, S10_I2C));
-
+#endif
+
+// period, deadline, offset; fast tasks first so equal deadlines favor them
+static SchedTask inputT = {"input", inputTask, 0, TimerCore::ms2tick(20)};
+static SchedTask dispT = {"disp", dispTask, 0, TimerCore::ms2tick(50), 0, TimerCore::ms2tick(10)};
+static SchedTask cmdT = {"cmd", cmdTask, 0, TimerCore::ms2tick(50), 0, TimerCore::ms2tick(25)};
+static SchedTask txT = {"uartTx", txTask, 0, TimerCore::ms2tick(20), 0, TimerCore::ms2tick(5)};
+static SchedTask intTempT = {"intTemp", intTempTask, 0, TimerCore::ms2tick(200)};
+static SchedTask extTempT = {"extTemp", extTempTask, 0, TimerCore::ms2tick(200)};
+#ifdef _IO_STATS_USED
+static SchedTask statT = {"stat", statTask, 0, TimerCore::ms2tick(200), TimerCore::ms2tick(1), TimerCore::ms2tick(200)};
+#endif
 
 int main() {
-   // internal temp is Left digits 4-7 and RGB, external temp is Right digits 0-3 and RGB
-   // Left=1, Right=0
-   int intLimit, extLimit, intIsFer, extIsFer, intColor, extColor;
-   float intTempC, extTempC, intTempF, extTempF;
-   bool intIsHundred, extIsHundred;
-
+   // log output never waits for the uart; overflow is dropped and counted
+   uart.set_tx_mode(UartCore::TX_DROP);
    pwm.set_freq(50);
-   while (1) {
-      
-      // User Input
-      intLimit = getTempLimit(&sw, 1);
-      extLimit = getTempLimit(&sw, 0);
-      dispTempLimit(&led, extLimit, intLimit);
-      intIsFer = getTempFormat(&sw, 1);
-      extIsFer = getTempFormat(&sw, 0);
-      
-      // Sensing
-      intTempC = getIntTempC(&adc);
-      extTempC = getExtTempC(&adt7420);
-      intTempF = cel2fer(intTempC);
-      extTempF = cel2fer(extTempC);
-      
-      // RGB Display
-      if (intTempC > intLimit) {
-         intColor = 1; // Red
-      } else {
-         intColor = 0; // Green 
-      }
-      if (extTempC > extLimit) {
-         extColor = 1; // Red
-      } else {
-         extColor = 0; // Green
-      }
-      setRGB(&pwm, intColor, 1);
-      setRGB(&pwm, extColor, 0);
-      
-      // Sseg Display
-      clearDisp(&sseg);
-      intIsHundred = dispTemp(&sseg, intTempC, intTempF, intIsFer, 1);
-      extIsHundred = dispTemp(&sseg, extTempC, extTempF, extIsFer, 0);
-      dispDp(&sseg, intIsHundred, extIsHundred);
-      
-      sleep_ms(200);
-   } //while
+   led.set_batch(&out);
+   pwm.set_batch(&out);
+   sseg.set_batch(&out);
+#ifdef _IO_TRACE_USED
+   // skip the timer (scheduler) and i2c ready polling; send 't' to dump
+   io_trace_start((uint32_t) ~(bit(S0_SYS_TIMER) | bit(S10_I2C)));
+#endif
+   // after io_trace_start(): a replay needs the divisor for uart timing
+   uart.set_baud_rate(CONSOLE_BAUD);
+#ifdef _IO_STATS_USED
+   io_stat_clear();
+#endif
+   sched.add(&inputT);
+   sched.add(&dispT);
+   sched.add(&cmdT);
+   sched.add(&txT);
+   sched.add(&intTempT);
+   sched.add(&extTempT);
+#ifdef _IO_STATS_USED
+   sched.add(&statT);
+#endif
+   // task descriptors are initialized data: after a watchdog reset
+   // (no reload of the memory image) they still hold the old counts
+   sched.clear_stats();
+   if (wdt.fired()) {
+      fmt_print(uart, FMT_STR("watchdog reset in task {}\n\r"),
+                sched.task_name(wdt.tag()));
+      wdt.clear_flag();
+   }
+   wdt.start(WDT_TIMEOUT);
+   sched.set_watchdog(&wdt);
+#ifdef _IO_TRACE_USED
+   io_trace_set_watchdog(&wdt);   // a dump outlasts the timeout at low baud
+#endif
+   sched.run();
+   return (0);   // not reached
 } //main
-
@@ -38,6 +38,8 @@ module mcs_top_sampler
    // declaration
    logic clk_100M;
    logic reset_sys;
+   logic por;          // board reset button
+   logic wdt_reset;    // watchdog timeout
    // MCS IO bus
    logic io_addr_strobe;
    logic io_read_strobe;
@@ -58,10 +60,14 @@ module mcs_top_sampler
    logic [7:0] pwm; 
    // ddfs/audio pdm 
    logic pdm, ddfs_sq_wave;
+   // timer alarm; for the MCS INTC_Interrupt input when the cpu ip
+   // is generated with one external interrupt (unused otherwise)
+   logic timer_irq;
 
    // body
    assign clk_100M = clk;       // 100 MHz external clock
-   assign reset_sys = !reset_n;
+   assign por = !reset_n;
+   assign reset_sys = por || wdt_reset;
    // audio
    assign audio_pdm = pdm;
    assign audio_on = 1'b1;
@@ -0,0 +1,79 @@
+// co-simulation top for Verilator (see chu_io_cosim.h)
+//  * mmio_sys_sampler with the 16-switch/16-led board configuration
+//  * FPro bus driven by the C++ io_read()/io_write() backend
+//  * i2c lines are pulled up; the C++ sensor model pulls sda low
+//  * unused analog/spi/ps2/ddfs pins tied off
+//  * use cosim_xadc_fpro.sv in place of xadc_fpro.sv
+
+module mmio_sys_cosim
+   (
+    input  logic clk,
+    input  logic reset,
+    // FPro bus
+    input  logic mmio_cs,
+    input  logic mmio_wr,
+    input  logic mmio_rd,
+    input  logic [20:0] mmio_addr,
+    input  logic [31:0] mmio_wr_data,
+    output logic [31:0] mmio_rd_data,
+    // board pins
+    input  logic [15:0] sw,
+    output logic [15:0] led,
+    input  logic rx,
+    output logic tx,
+    output logic [7:0] pwm,
+    output logic [7:0] an,
+    output logic [7:0] sseg,
+    // i2c line levels and slave pull-down
+    output logic scl,
+    output logic sda,
+    input  logic sda_slave_low,
+    // system timer alarm interrupt
+    output logic timer_irq,
+    // watchdog reset request (not fed back; see CosimBus::wdt_reset())
+    output logic wdt_reset
+   );
+
+   // declaration
+   tri1 scl_line, sda_line;
+   tri  ps2d_line, ps2c_line;
+
+   // body
+   assign sda_line = sda_slave_low ? 1'b0 : 1'bz;
+   assign scl = scl_line;
+   assign sda = sda_line;
+
+   mmio_sys_sampler #(.N_SW(16), .N_LED(16)) mmio_unit (
+    .clk(clk),
+    .reset(reset),
+    .por(reset),
+    .mmio_cs(mmio_cs),
+    .mmio_wr(mmio_wr),
+    .mmio_rd(mmio_rd),
+    .mmio_addr(mmio_addr),
+    .mmio_wr_data(mmio_wr_data),
+    .mmio_rd_data(mmio_rd_data),
+    .sw(sw),
+    .led(led),
+    .rx(rx),
+    .tx(tx),
+    .adc_p(4'b0000),
+    .adc_n(4'b0000),
+    .pwm(pwm),
+    .btn(5'b00000),
+    .an(an),
+    .sseg(sseg),
+    .acl_sclk(),
+    .acl_mosi(),
+    .acl_miso(1'b0),
+    .acl_ss(),
+    .tmp_i2c_scl(scl_line),
+    .tmp_i2c_sda(sda_line),
+    .ps2d(ps2d_line),
+    .ps2c(ps2c_line),
+    .ddfs_sq_wave(),
+    .pdm(),
+    .timer_irq(timer_irq),
+    .wdt_reset(wdt_reset)
+   );
+endmodule
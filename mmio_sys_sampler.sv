@@ -9,6 +9,8 @@ module mmio_sys_sampler
 (
    input logic clk,
    input logic reset,
+   // board reset (watchdog only; reset includes it)
+   input logic por,
    // FPro bus 
    input  logic mmio_cs,
    input  logic mmio_wr,
@@ -44,7 +46,11 @@ module mmio_sys_sampler
    // ddfs square wave output
    output  logic  ddfs_sq_wave,
    // 1-bit dac 
-    output logic  pdm 
+    output logic  pdm,
+   // system timer alarm interrupt
+    output logic  timer_irq,
+   // watchdog reset request (to the cpu/mmio reset)
+    output logic  wdt_reset
 );
 
    //declaration
@@ -85,7 +91,8 @@ module mmio_sys_sampler
     .write(mem_wr_array[`S0_SYS_TIMER]),
     .addr(reg_addr_array[`S0_SYS_TIMER]),
     .rd_data(rd_data_array[`S0_SYS_TIMER]),
-    .wr_data(wr_data_array[`S0_SYS_TIMER])
+    .wr_data(wr_data_array[`S0_SYS_TIMER]),
+    .irq(timer_irq)
     );
 
    // slot 1: UART 
@@ -128,19 +135,18 @@ module mmio_sys_sampler
     .din(sw)
     );
     
-    // slot 4: reserved for user defined  
-   // chu_gpi #(.W(N_SW)) user_slot4 
-   // (.clk(clk),
-   //  .reset(reset),
-   //  .cs(cs_array[`S4_USER]),
-   //  .read(mem_rd_array[`S4_USER]),
-   //  .write(mem_wr_array[`S4_USER]),
-   //  .addr(reg_addr_array[`S4_USER]),
-   //  .rd_data(rd_data_array[`S4_USER]),
-   //  .wr_data(wr_data_array[`S4_USER]),
-   //  .din(sw)
-   //  );
-   assign rd_data_array[`S4_USER] = 32'h00000000;
+   // slot 4: watchdog (reset by por only)
+   chu_watchdog wdt_slot4 
+   (.clk(clk),
+    .por(por),
+    .cs(cs_array[`S4_WDT]),
+    .read(mem_rd_array[`S4_WDT]),
+    .write(mem_wr_array[`S4_WDT]),
+    .addr(reg_addr_array[`S4_WDT]),
+    .rd_data(rd_data_array[`S4_WDT]),
+    .wr_data(wr_data_array[`S4_WDT]),
+    .wdt_reset(wdt_reset)
+    );
    
    // slot 5: xadc 
    chu_xadc_core xadc_slot5 
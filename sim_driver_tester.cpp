@@ -0,0 +1,1174 @@
+// Runs the unmodified MMIO drivers against the simulated FPro bus.
+//
+// build:
+//   g++ -D_SIM_IO_ACCESS_USED -I. sim_driver_tester.cpp chu_io_sim.cpp
+//       chu_init.cpp timer_core.cpp uart_core.cpp gpio_cores.cpp
+//       xadc_core.cpp sseg_core.cpp i2c_core.cpp chu_io_trace.cpp
+//       chu_prof.cpp -o sim_driver_tester
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <string>
+
+#include "chu_init.h"
+#include "chu_io_sim.h"
+#include "gpio_cores.h"
+#include "xadc_core.h"
+#include "sseg_core.h"
+#include "i2c_core.h"
+#include "slot_cores.h"
+#include "chu_io_trace.h"
+#include "chu_prof.h"
+#include "chu_sched.h"
+#include "chu_twheel.h"
+#include "wdt_core.h"
+#include "chu_fmt.h"
+#include "chu_print.h"
+#include "chu_report.h"
+#include "chu_telem.h"
+#include "chu_log.h"
+
+// Test Helpers //////////////////////////////////////////////////
+
+static int g_fail = 0;
+
+// checks expected bool value
+#define EXPECT_TRUE(cond) do { \
+  if (!(cond)) { \
+    std::printf("[FAIL] %s\n", #cond); \
+    g_fail++; \
+  } else { \
+    std::printf("[PASS] %s\n", #cond); \
+  } \
+} while (0)
+
+// checks expected int value
+#define EXPECT_EQ_INT(a,b) do { \
+  int a_val = (a), b_val = (b); \
+  if (a_val != b_val) { \
+    std::printf("[FAIL] %s != %s  (%d vs %d)\n", #a, #b, a_val, b_val); \
+    g_fail++; \
+  } else { \
+    std::printf("[PASS] %s == %s  (%d)\n", #a, #b, a_val); \
+  } \
+} while (0)
+
+// checks expected uint32_t value
+#define EXPECT_EQ_U32(a,b) do { \
+  uint32_t a_val = (a), b_val = (b); \
+  if (a_val != b_val) { \
+    std::printf("[FAIL] %s != %s  (0x%08X vs 0x%08X)\n", #a, #b, a_val, b_val); \
+    g_fail++; \
+  } else { \
+    std::printf("[PASS] %s == %s  (0x%08X)\n", #a, #b, a_val); \
+  } \
+} while (0)
+
+// checks expected float with tolerance = eps
+#define EXPECT_NEAR(a,b,eps) do { \
+  float a_val = (a), b_val = (b); \
+  if (std::fabs(a_val - b_val) > (eps)) { \
+    std::printf("[FAIL] |%s-%s| > %g  (%.6f vs %.6f)\n", #a, #b, (double)(eps), a_val, b_val); \
+    g_fail++; \
+  } else { \
+    std::printf("[PASS] %s ~= %s  (%.6f)\n", #a, #b, a_val); \
+  } \
+} while (0)
+
+// Cores in the slots of mmio_sys_sampler //////////////////////////
+
+GpoCore led(get_slot_addr(BRIDGE_BASE, S2_LED));
+GpiCore sw(get_slot_addr(BRIDGE_BASE, S3_SW));
+XadcCore adc(get_slot_addr(BRIDGE_BASE, S5_XDAC));
+PwmCore pwm(get_slot_addr(BRIDGE_BASE, S6_PWM));
+SsegCore sseg(get_slot_addr(BRIDGE_BASE, S8_SSEG));
+I2cCore adt7420(get_slot_addr(BRIDGE_BASE, S10_I2C));
+
+// Tests ////////////////////////////////////////////////////////////
+
+// checks the timer counts bus clocks and sleep waits long enough
+static void test_timer() {
+  std::puts("\n=== test timer ===");
+  unsigned long t0, t1;
+
+  t0 = now_us();
+  sleep_ms(5);
+  t1 = now_us();
+  EXPECT_TRUE(t1 - t0 >= 5000);
+  EXPECT_TRUE(t1 - t0 < 5100);
+}
+
+// checks the division-free tick conversions against the divide
+static void test_tick_div() {
+  std::puts("\n=== test tick conversion ===");
+  const uint64_t MAX48 = (1ULL << 48) - 1;
+  uint64_t x = 0x123456789abcULL;
+  int bad_us = 0, bad_ms = 0;
+
+  EXPECT_TRUE(TimerCore::tick2us(MAX48) == MAX48 / SYS_CLK_FREQ);
+  EXPECT_TRUE(TimerCore::tick2ms(MAX48) == MAX48 / (1000 * SYS_CLK_FREQ));
+  EXPECT_TRUE(TimerCore::tick2us(TimerCore::us2tick(12345) - 1) == 12344);
+  EXPECT_TRUE(TimerCore::tick2ms(TimerCore::ms2tick(200)) == 200);
+  for (int i = 0; i < 100000; i++) {
+    x = (x * 6364136223846793005ULL + 1442695040888963407ULL);
+    uint64_t t = (i & 1) ? (x >> 16) : (x >> (16 + (i % 40)));   // all magnitudes
+    if (TimerCore::tick2us(t) != t / SYS_CLK_FREQ)
+      bad_us++;
+    if (TimerCore::tick2ms(t) != t / (1000 * SYS_CLK_FREQ))
+      bad_ms++;
+  }
+  EXPECT_EQ_INT(bad_us, 0);
+  EXPECT_EQ_INT(bad_ms, 0);
+  EXPECT_TRUE(tick_div<3>(MAX48) == MAX48 / 3);
+  EXPECT_TRUE(tick_div<125000>(MAX48 - 7) == (MAX48 - 7) / 125000);
+}
+
+// checks the uart divisor and the transmitted characters
+static void test_uart() {
+  std::puts("\n=== test uart ===");
+  SimUart &u = sim_bus().uart;
+
+  EXPECT_EQ_U32(u.get_dvsr(), 100000000 / 16 / 9600 - 1);
+  u.set_echo(0);
+  u.tx_log().clear();
+  uart.disp("T=");
+  uart.disp(-42);
+  uart.disp(' ');
+  uart.disp(0x1f, 16);
+  uart.disp(' ');
+  uart.disp(3.25, 2);
+  sleep_ms(50);   // let the frames shift out
+  EXPECT_TRUE(u.tx_log() == "T=-42 1f 3.25");
+  u.set_echo(1);
+
+  u.rx_push('a');
+  EXPECT_EQ_INT(uart.rx_byte(), 'a');
+  EXPECT_EQ_INT(uart.rx_byte(), -1);
+}
+
+// checks the buffered tx path: O(1) queueing, drop and block policies
+static void test_uart_ring() {
+  std::puts("\n=== test uart ring ===");
+  SimUart &u = sim_bus().uart;
+  UartCore ut(get_slot_addr(BRIDGE_BASE, S1_UART1));
+  std::string big(1000, 'x');
+  uint64_t t0;
+
+  u.set_echo(0);
+  sleep_ms(50);
+  u.tx_log().clear();
+  ut.set_tx_mode(UartCore::TX_DROP);
+  t0 = sim_bus().cycle();
+  ut.disp("hello ");
+  ut.disp(12);
+  EXPECT_EQ_INT((int)(sim_bus().cycle() - t0), 0);   // no bus access
+  EXPECT_EQ_INT(ut.tx_pending(), 8);
+  EXPECT_EQ_INT(ut.tx_poll(), 8);
+  EXPECT_EQ_INT(ut.tx_poll(), 0);
+  sleep_ms(20);
+  EXPECT_TRUE(u.tx_log() == "hello 12");
+
+  // drop: a string that does not fit is dropped whole
+  u.tx_log().clear();
+  ut.disp(big.c_str());
+  ut.disp(big.c_str());
+  EXPECT_EQ_INT(ut.tx_pending(), 1000);
+  EXPECT_EQ_INT((int)ut.tx_dropped(), 1000);
+  EXPECT_EQ_INT(ut.tx_peak(), 1000);
+  EXPECT_EQ_INT(ut.tx_poll(), SimUart::FIFO_DEPTH);
+  ut.tx_flush();
+  EXPECT_EQ_INT(ut.tx_pending(), 0);
+  ut.tx_clear_stats();
+  EXPECT_EQ_INT((int)ut.tx_dropped(), 0);
+
+  // block: nothing lost
+  ut.set_tx_mode(UartCore::TX_BLOCK);
+  ut.disp(big.c_str());
+  ut.disp(big.c_str());
+  ut.set_tx_mode(UartCore::TX_DIRECT);   // flushes
+  EXPECT_EQ_INT(ut.tx_pending(), 0);
+  EXPECT_EQ_INT((int)ut.tx_dropped(), 0);
+  sleep_ms(4000);
+  EXPECT_EQ_INT((int)u.tx_log().size(), 3000);
+  u.set_echo(1);
+}
+
+// checks fifo levels and the bulk read/write paths
+static void test_uart_level() {
+  std::puts("\n=== test uart level ===");
+  SimBus &bus = sim_bus();
+  SimUart &u = bus.uart;
+  uint8_t big[300], buf[8];
+  unsigned long rd, wr;
+
+  u.set_echo(0);
+  sleep_ms(400);
+  u.tx_log().clear();
+  EXPECT_EQ_INT(uart.tx_fifo_free(), SimUart::FIFO_DEPTH);
+  EXPECT_EQ_INT(uart.rx_fifo_used(), 0);
+  rd = bus.reads();
+  wr = bus.writes();
+  uart.disp("0123456789");
+  EXPECT_EQ_INT((int)(bus.reads() - rd), 1);   // one level read
+  EXPECT_EQ_INT((int)(bus.writes() - wr), 10);
+  EXPECT_EQ_INT(uart.tx_fifo_free(), SimUart::FIFO_DEPTH - 10);
+
+  memset(big, 'y', sizeof(big));
+  EXPECT_EQ_INT(uart.write(big, 300), SimUart::FIFO_DEPTH - 10);
+  EXPECT_EQ_INT(uart.tx_fifo_free(), 0);
+  EXPECT_EQ_INT(uart.write(big, 300), 0);
+  sleep_ms(400);
+  EXPECT_EQ_INT((int)u.tx_log().size(), SimUart::FIFO_DEPTH);
+
+  for (int i = 0; i < 5; i++)
+    u.rx_push('a' + i);
+  EXPECT_EQ_INT(uart.rx_fifo_used(), 5);
+  EXPECT_EQ_INT(uart.read(buf, 3), 3);
+  EXPECT_TRUE(memcmp(buf, "abc", 3) == 0);
+  EXPECT_EQ_INT(uart.read(buf, 8), 2);
+  EXPECT_TRUE(memcmp(buf, "de", 2) == 0);
+  EXPECT_EQ_INT(uart.read(buf, 8), 0);
+  u.set_echo(1);
+}
+
+// checks the fractional divisor: selection, reported error, line rate
+static void test_uart_baud() {
+  std::puts("\n=== test uart baud ===");
+  SimUart &u = sim_bus().uart;
+  uint8_t blk[100];
+  uint64_t t0;
+
+  uart.set_baud_rate(115200);
+  EXPECT_EQ_U32(u.get_dvsr(), 53);
+  EXPECT_EQ_U32(u.get_dvsr_frac(), 65);
+  EXPECT_EQ_INT(uart.get_baud_rate(), 115199);
+  EXPECT_TRUE(std::abs(uart.get_baud_error()) < 100);
+
+  uart.set_baud_rate(921600);
+  EXPECT_EQ_U32(u.get_dvsr(), 5);
+  EXPECT_EQ_U32(u.get_dvsr_frac(), 200);
+  EXPECT_EQ_INT(uart.get_baud_rate(), 921659);
+  EXPECT_TRUE(std::abs(uart.get_baud_error()) < 100);   // integer dvsr: -3.1%
+
+  // 100 frames of 10 bits at 921600 baud: 108507 clocks
+  u.set_echo(0);
+  sleep_ms(400);
+  u.tx_log().clear();
+  memset(blk, 'z', sizeof(blk));
+  t0 = sim_bus().cycle();
+  EXPECT_EQ_INT(uart.write(blk, 100), 100);
+  while (uart.tx_fifo_free() < SimUart::FIFO_DEPTH) {
+  }
+  EXPECT_NEAR((float)(sim_bus().cycle() - t0), 108507.0f, 200.0f);
+  EXPECT_EQ_INT((int)u.tx_log().size(), 100);
+  u.set_echo(1);
+
+  // out-of-range requests are clamped; the error stays finite
+  uart.set_baud_rate(1);
+  EXPECT_EQ_INT(uart.get_baud_rate(), UartCore::BAUD_MIN);
+  EXPECT_TRUE(std::abs(uart.get_baud_error()) < 100);
+  uart.set_baud_rate(0);
+  EXPECT_TRUE(std::abs(uart.get_baud_error()) < 100);
+  uart.set_baud_rate(100000000);
+  EXPECT_EQ_INT(uart.get_baud_rate(), UartCore::BAUD_MAX);
+  EXPECT_EQ_INT(uart.get_baud_error(), 0);
+  // the slot template shares the clamp and divisor selection
+  SlotUartCore<S1_UART1> uart_s;
+  uart.set_baud_rate(0);
+  uint32_t dvsr = u.get_dvsr();
+  uart_s.set_baud_rate(0);
+  EXPECT_EQ_U32(u.get_dvsr(), dvsr);
+
+  uart.set_baud_rate(9600);
+  EXPECT_EQ_U32(u.get_dvsr(), 100000000 / 16 / 9600 - 1);
+
+  // baud_gen with dvsr 0 ticks only in the periods stretched by frac
+  uint32_t uart_addr = get_slot_addr(BRIDGE_BASE, S1_UART1);
+  io_write(uart_addr, UartCore::DVSR_REG, 0);
+  EXPECT_EQ_INT((int)u.frame_cycles(), 0);
+  io_write(uart_addr, UartCore::DVSR_REG, 128 << 16);   // tick every 3 clocks
+  EXPECT_EQ_INT((int)u.frame_cycles(), 160 * 3);
+  uart.set_baud_rate(9600);
+}
+
+// checks the division-free formatters against snprintf and disp() output
+static void test_fmt() {
+  std::puts("\n=== test fmt ===");
+  SimUart &u = sim_bus().uart;
+  char buf[72], ref[72], *end = &buf[70];
+  int bad = 0;
+
+  end[0] = '\0';
+  for (uint64_t p = 1; p != 0 && p <= 10000000000000000000ULL; p *= 10) {
+    for (int d = -2; d <= 2; d++) {
+      uint64_t n = p + d;
+      snprintf(ref, sizeof(ref), "%llu", (unsigned long long)n);
+      bad += strcmp(fmt_dec64(end, n), ref) != 0;
+      if (n <= 0xffffffffULL) {
+        bad += strcmp(fmt_dec32(end, (uint32_t)n), ref) != 0;
+        snprintf(ref, sizeof(ref), "%x", (unsigned)n);
+        bad += strcmp(fmt_pow2_32(end, (uint32_t)n, 4), ref) != 0;
+        snprintf(ref, sizeof(ref), "%o", (unsigned)n);
+        bad += strcmp(fmt_pow2_32(end, (uint32_t)n, 3), ref) != 0;
+      }
+    }
+  }
+  for (uint32_t i = 0, n = 0; i < 100000; i++, n = n * 1664525u + 1013904223u) {
+    uint64_t m = (uint64_t)n << 24 ^ i;
+    snprintf(ref, sizeof(ref), "%u", n);
+    bad += strcmp(fmt_dec32(end, n), ref) != 0;
+    snprintf(ref, sizeof(ref), "%llu", (unsigned long long)m);
+    bad += strcmp(fmt_dec64(end, m), ref) != 0;
+    snprintf(ref, sizeof(ref), "%llx", (unsigned long long)m);
+    bad += strcmp(fmt_pow2_64(end, m, 4), ref) != 0;
+  }
+  EXPECT_EQ_INT(bad, 0);
+  EXPECT_TRUE(strcmp(fmt_dec64(end, ~0ULL), "18446744073709551615") == 0);
+  EXPECT_TRUE(strcmp(fmt_pow2_32(end, 5, 1), "101") == 0);
+
+  u.set_echo(0);
+  sleep_ms(50);
+  u.tx_log().clear();
+  uart.disp((int)0x80000000, 10, 0);
+  uart.disp(' ');
+  uart.disp(-7, 10, 4);
+  uart.disp(' ');
+  uart.disp(-1, 16, 0);
+  uart.disp(' ');
+  uart.disp(0);
+  uart.disp(' ');
+  uart.disp_u64(281474976710655ULL);   // 2^48 - 1
+  uart.disp(' ');
+  uart.disp_u64(0x123456789aULL, 16, 12);
+  sleep_ms(100);
+  EXPECT_TRUE(u.tx_log() == "-2147483648   -7 ffffffff 0 281474976710655   123456789a");
+  u.set_echo(1);
+}
+
+// former UartCore::disp(double, digit) (per-digit double arithmetic)
+static std::string ref_disp_double(double f, int digit) {
+  std::string s;
+  double fa = f, frac;
+  int i_part, i;
+
+  if (f < 0.0) {
+    fa = -f;
+    s += "-";
+  }
+  i_part = (int)fa;
+  s += std::to_string(i_part) + ".";
+  frac = fa - (double)i_part;
+  for (int n = 0; n < digit; n++) {
+    frac = frac * 10.0;
+    i = (int)frac;
+    s += std::to_string(i);
+    frac = frac - i;
+  }
+  return s;
+}
+
+static std::string q32_str(double f, int digit) {
+  char buf[48], *p;
+  uint32_t ip, fq;
+  int neg = fmt_dbl_split(f, &ip, &fq);
+
+  p = fmt_dec32(&buf[12], ip);
+  if (neg)
+    *--p = '-';
+  buf[12] = '.';
+  *fmt_frac_q32(&buf[13], fq, digit) = '\0';
+  return std::string(p);
+}
+
+// checks the integer-only double/fixed-point formatting
+static void test_fmt_fix() {
+  std::puts("\n=== test fmt fixed point ===");
+  SimUart &u = sim_bus().uart;
+  int bad16 = 0, bad1000 = 0, bad_rand = 0;
+  uint32_t r = 12345;
+
+  for (int k = -128 * 16; k <= 150 * 16; k++)       // ADT7420 range, Q4
+    for (int d = 0; d <= 6; d++)
+      bad16 += q32_str(k / 16.0, d) != ref_disp_double(k / 16.0, d);
+  // 3-decimal values: the digits of k/1000 (the former code printed
+  // e.g. 99.992 for 99.993, stored as 99.99299999...)
+  for (int k = -100000; k <= 100000; k += 7) {
+    char want[24];
+    snprintf(want, sizeof(want), "%s%d.%03d", (k < 0) ? "-" : "", std::abs(k) / 1000,
+             std::abs(k) % 1000);
+    for (int d = 1; d <= 3; d++)
+      bad1000 += q32_str(k / 1000.0, d) != std::string(want, strlen(want) - 3 + d);
+  }
+  for (int k = 0; k < 100000; k++) {
+    r = r * 1664525u + 1013904223u;
+    double f = ((int32_t)r) / 2147483.648;          // +-1000, 53-bit noise
+    bad_rand += q32_str(f, 3) != ref_disp_double(f, 3);
+  }
+  EXPECT_EQ_INT(bad16, 0);
+  EXPECT_EQ_INT(bad1000, 0);
+  EXPECT_EQ_INT(bad_rand, 0);
+  EXPECT_TRUE(q32_str(0.29, 2) == "0.29");
+  EXPECT_TRUE(q32_str(-0.0, 1) == "0.0");
+  EXPECT_TRUE(q32_str(0.9999999999, 3) == "0.999");
+  EXPECT_TRUE(q32_str(4294967296.0, 1) == "4294967295.0");   // saturated
+
+  u.set_echo(0);
+  sleep_ms(100);
+  u.tx_log().clear();
+  uart.disp(-3.25, 2);
+  uart.disp(' ');
+  uart.disp_fix(-1, 4, 3);                            // -1/16
+  uart.disp(' ');
+  uart.disp_fix(401, 4, 4);                           // 25.0625
+  uart.disp(' ');
+  uart.disp_scaled(2512, 2);
+  uart.disp(' ');
+  uart.disp_scaled(-5, 3);
+  uart.disp(' ');
+  uart.disp_scaled(7, 0);
+  sleep_ms(100);
+  EXPECT_TRUE(u.tx_log() == "-3.25 -0.062 25.0625 25.12 -0.005 7");
+  u.set_echo(1);
+}
+
+// checks the compile-time format strings and the single bulk write
+static void test_print() {
+  std::puts("\n=== test print ===");
+  SimBus &bus = sim_bus();
+  SimUart &u = bus.uart;
+  char buf[64];
+  unsigned long rd, wr;
+  int n;
+
+  n = fmt_format(buf, sizeof(buf), FMT_STR("a{}b{:5}c{:05}d{:x}e{:08b}"), -12, 34, -56,
+                 0xbeefu, 5);
+  EXPECT_TRUE(std::string(buf, n) == "a-12b   34c-0056dbeefe00000101");
+  n = fmt_format(buf, sizeof(buf), FMT_STR("{} {:.1} {:.0} {:7.2}|"), 2.5, -0.25,
+                 7.9, fmt_fix(-1, 4));
+  EXPECT_TRUE(std::string(buf, n) == "2.500 -0.2 7   -0.06|");
+  n = fmt_format(buf, sizeof(buf), FMT_STR("{}{:3}[{}]{}"), 'x', 'y', "str",
+                 18446744073709551615ULL);
+  EXPECT_TRUE(std::string(buf, n) == "x  y[str]18446744073709551615");
+  n = fmt_format(buf, sizeof(buf), FMT_STR("{:x} {:o} {}"), -1, 8, -(1LL << 40));
+  EXPECT_TRUE(std::string(buf, n) == "ffffffff 10 -1099511627776");
+  n = fmt_format(buf, 6, FMT_STR("no args, truncated"));
+  EXPECT_TRUE(std::string(buf, n) == "no arg");
+
+  u.set_echo(0);
+  sleep_ms(100);
+  u.tx_log().clear();
+  rd = bus.reads();
+  wr = bus.writes();
+  fmt_print(uart, FMT_STR("T={:.3} C, {} samples\n\r"), fmt_fix(401, 4), 12);
+  EXPECT_EQ_INT((int)(bus.reads() - rd), 1);   // one level read
+  EXPECT_EQ_INT((int)(bus.writes() - wr), 24);
+  sleep_ms(100);
+  EXPECT_TRUE(u.tx_log() == "T=25.062 C, 12 samples\n\r");
+  u.set_echo(1);
+}
+
+// checks the telemetry codec and a frame sent over the uart
+static void test_telem() {
+  std::puts("\n=== test telem ===");
+  SimUart &u = sim_bus().uart;
+  uint8_t src[600], enc[620], dec[620], frame[TELEM_FRAME_MAX];
+  TelemSample s[2] = {{TELEM_CH_FPGA_TEMP, 6, -2880}, {TELEM_CH_EXT_TEMP, 4, 40000}};
+  TelemFrame f;
+  uint32_t r = 777;
+  int bad = 0, n, len;
+
+  EXPECT_EQ_U32(telem_crc16((const uint8_t *)"123456789", 9, 0xffff), 0x29b1);
+  for (int k = 0; k < 200; k++) {       // zeros, runs of 254+ non-zeros
+    n = (k * 37) % 600;
+    for (int i = 0; i < n; i++) {
+      r = r * 1664525u + 1013904223u;
+      src[i] = (k & 1) ? (uint8_t)(r >> 24) : (uint8_t)((r >> 24) % 4 ? 0x55 : 0);
+    }
+    len = telem_cobs_encode(src, n, enc);
+    bad += len > n + n / 254 + 1 || memchr(enc, 0, len) != 0;
+    bad += telem_cobs_decode(enc, len, dec) != n || memcmp(src, dec, n) != 0;
+  }
+  EXPECT_EQ_INT(bad, 0);
+
+  len = telem_encode(frame, 7, 0x12345678, s, 2);
+  EXPECT_EQ_INT(len, 15);
+  EXPECT_EQ_INT(frame[len - 1], 0);
+  EXPECT_EQ_INT(telem_decode(frame, len - 1, &f), 0);
+  EXPECT_EQ_INT(f.seq, 7);
+  EXPECT_EQ_U32(f.time_us, 0x12345678);
+  EXPECT_EQ_INT(f.n, 2);
+  EXPECT_EQ_INT(f.s[0].ch, TELEM_CH_FPGA_TEMP);
+  EXPECT_EQ_INT(f.s[0].frac_bits, 6);
+  EXPECT_EQ_INT(f.s[0].v, -2880);
+  EXPECT_EQ_INT(f.s[1].v, 32767);       // saturated
+  frame[4] ^= 0x01;
+  EXPECT_EQ_INT(telem_decode(frame, len - 1, &f), -1);
+
+  u.set_echo(0);
+  sleep_ms(100);
+  u.tx_log().clear();
+  telem_send(s, 2);
+  telem_send(s, 1);
+  sleep_ms(100);
+  std::string log = u.tx_log();
+  EXPECT_EQ_INT((int)log.size(), 15 + 12);
+  EXPECT_EQ_INT(telem_decode((const uint8_t *)log.data(), 14, &f), 0);
+  n = f.seq;
+  EXPECT_EQ_INT(telem_decode((const uint8_t *)log.data() + 15, 11, &f), 0);
+  EXPECT_EQ_INT(f.seq, (n + 1) & 0xff);
+  EXPECT_EQ_INT(f.n, 1);
+  u.set_echo(1);
+}
+
+// checks deferred log records, their uart frames and host rendering
+static void test_log() {
+  std::puts("\n=== test log ===");
+  SimUart &u = sim_bus().uart;
+  uint8_t pl[LOG_FRAME_MAX];
+  uint32_t rec[LOG_REC_MAX];
+  char msg[80];
+  int n, len, sent;
+  unsigned long drop0;
+
+  u.set_echo(0);
+  sleep_ms(100);
+  u.tx_log().clear();
+  log_write<LOG_LEVEL_TRACE>(FMT_STR("i2c wr {:02x} ack {}"), (uint8_t)0x96, -1);
+  log_write<LOG_LEVEL_INFO>(FMT_STR("t={:.2} n={} x={:x} c={}"), 25.5, -5000000000LL, 0xbeefu, 'k');
+  log_write<LOG_LEVEL_ERROR>(FMT_STR("no args"));
+  EXPECT_EQ_INT((int)(log_head - log_tail), 5 + 9 + 3);
+  EXPECT_EQ_INT(log_poll(), 3);
+  EXPECT_EQ_INT((int)(log_head - log_tail), 0);
+  sleep_ms(100);
+  std::string s = u.tx_log();
+
+  // first frame: no drops, id/type header, 2 argument words
+  len = telem_cobs_decode((const uint8_t *)s.data(), (int)s.find('\0'), pl);
+  EXPECT_EQ_INT(len, 1 + 4 * 5 + 2);
+  EXPECT_EQ_INT(pl[0], 0);
+  EXPECT_EQ_U32(telem_crc16(pl, len - 2, 0xffff), pl[len - 2] | pl[len - 1] << 8);
+  n = (len - 3) / 4;
+  for (int i = 0; i < n; i++)
+    memcpy(&rec[i], &pl[1 + 4 * i], 4);
+  EXPECT_EQ_U32(rec[0], log_hash("i2c wr {:02x} ack {}"));
+  EXPECT_EQ_U32(rec[2], (LOG_T_I32 << 4 | LOG_T_U32) << 8 | LOG_LEVEL_TRACE << 4 | 5);
+  len = log_render(msg, sizeof(msg), "i2c wr {:02x} ack {}", rec, n);
+  EXPECT_TRUE(std::string(msg, len) == "i2c wr 96 ack -1");
+
+  s = s.substr(s.find('\0') + 1);
+  len = telem_cobs_decode((const uint8_t *)s.data(), (int)s.find('\0'), pl);
+  n = (len - 3) / 4;
+  for (int i = 0; i < n; i++)
+    memcpy(&rec[i], &pl[1 + 4 * i], 4);
+  len = log_render(msg, sizeof(msg), "t={:.2} n={} x={:x} c={}", rec, n);
+  EXPECT_TRUE(std::string(msg, len) == "t=25.50 n=-5000000000 x=beef c=k");
+  EXPECT_EQ_INT(log_render(msg, sizeof(msg), "t={} n={}", rec, n), -1);   // wrong string
+
+  // built without _LOG_USED: no record, arguments not evaluated
+  n = 0;
+  LOG_ERROR("never {}", ++n);
+  LOG_TRACE("never {}", ++n);
+  EXPECT_EQ_INT(n, 0);
+  EXPECT_EQ_INT((int)(log_head - log_tail), 0);
+
+  // full ring: records dropped and reported with the next frame
+  drop0 = log_dropped();
+  for (int i = 0; i < LOG_DEPTH / 4 + 10; i++)
+    log_write<LOG_LEVEL_INFO>(FMT_STR("fill {}"), i);
+  EXPECT_EQ_INT((int)(log_dropped() - drop0), 10);
+  u.tx_log().clear();
+  sent = 0;
+  while (log_head != log_tail) {
+    sent += log_poll();
+    sleep_ms(1);
+  }
+  EXPECT_EQ_INT(sent, LOG_DEPTH / 4);
+  sleep_ms(100);
+  len = telem_cobs_decode((const uint8_t *)u.tx_log().data(), (int)u.tx_log().find('\0'), pl);
+  EXPECT_EQ_INT(pl[0], 10);
+  u.set_echo(1);
+}
+
+// checks switches in and LEDs out
+static void test_gpio() {
+  std::puts("\n=== test gpio ===");
+  sim_bus().sw.set(0x8034);
+  EXPECT_EQ_U32(sw.read(), 0x8034);
+  EXPECT_EQ_INT(sw.read(15), 1);
+  EXPECT_EQ_INT(sw.read(0), 0);
+  led.write(0x1234);
+  EXPECT_EQ_U32(sim_bus().led.dout(), 0x1234);
+  led.write(1, 0);
+  EXPECT_EQ_U32(sim_bus().led.dout(), 0x1235);
+}
+
+// checks the XADC temperature transfer function
+static void test_xadc() {
+  std::puts("\n=== test xadc ===");
+  sim_bus().adc.set_temp(45.0);
+  EXPECT_NEAR((float)adc.read_fpga_temp(), 45.0f, 0.13f);
+  sim_bus().adc.set_vcc(1.0);
+  EXPECT_NEAR((float)adc.read_fpga_vcc(), 1.0f, 0.001f);
+}
+
+// checks the pwm divisor and duty registers
+static void test_pwm() {
+  std::puts("\n=== test pwm ===");
+  pwm.set_freq(50);
+  EXPECT_EQ_U32(sim_bus().pwm.dvsr(), 100000000 / 1024 / 50);
+  pwm.set_duty(0.3, 4);
+  EXPECT_EQ_U32(sim_bus().pwm.duty(4), (uint32_t)(0.3 * 1024));
+  pwm.set_duty(2000, 5);
+  EXPECT_EQ_U32(sim_bus().pwm.duty(5), 1024);
+  // out-of-range channels write nothing (no alias, no shadow overrun)
+  unsigned long n_wr = sim_bus().pwm.writes();
+  pwm.set_duty(100, 16);
+  pwm.set_duty(100, -1);
+  EXPECT_EQ_INT((int)(sim_bus().pwm.writes() - n_wr), 0);
+  EXPECT_EQ_U32(sim_bus().pwm.dvsr(), 100000000 / 1024 / 50);
+}
+
+// checks pattern packing of the 7-seg words
+static void test_sseg() {
+  std::puts("\n=== test sseg ===");
+  uint8_t ptn[8] = {0xc0, 0xf9, 0xa4, 0xb0, 0x99, 0x92, 0x82, 0xf8};
+
+  sseg.write_8ptn(ptn);
+  sseg.set_dp(0x04);
+  EXPECT_EQ_INT(sim_bus().sseg.ptn(0), 0xc0);
+  EXPECT_EQ_INT(sim_bus().sseg.ptn(7), 0xf8);
+  EXPECT_EQ_INT(sim_bus().sseg.ptn(2), 0xa4 & 0x7f);  // dp on (active low)
+}
+
+// checks the generated field descriptors against the driver masks
+static void test_io_map() {
+  std::puts("\n=== test io map ===");
+  EXPECT_EQ_U32(uart_regs::RX_EMPT::mask, UartCore::RX_EMPT_FIELD);
+  EXPECT_EQ_U32(uart_regs::TX_FULL::get(0x2ff), 1);
+  EXPECT_EQ_U32(uart_regs::RX_DATA::get(0x2a5), 0xa5);
+  EXPECT_EQ_INT(i2c_regs::READY::test(0x100), 1);
+  EXPECT_EQ_U32(i2c_regs::CMD::put(i2c_regs::CMD_RESTART), I2cCore::I2C_RESTART_CMD);
+  EXPECT_EQ_U32(timer_regs::CLR::replace(0x01, 1), 0x03);
+  EXPECT_EQ_U32(xadc_regs::TMP_DATA::get(0xfff0), 0xfff);
+}
+
+// checks that rewriting unchanged values to write-only cores is elided
+static void test_shadow() {
+  std::puts("\n=== test shadow registers ===");
+  unsigned long n_wr, n_sup;
+  uint8_t ptn[8] = {0xc0, 0xf9, 0xa4, 0xb0, 0x99, 0x92, 0x82, 0xf8};
+
+  led.write(0x00ff);
+  n_wr = sim_bus().led.writes();
+  n_sup = led.suppressed_writes();
+  led.write(0x00ff);
+  led.write(1, 0);   // bit already 1
+  EXPECT_EQ_INT((int)(sim_bus().led.writes() - n_wr), 0);
+  EXPECT_EQ_INT((int)(led.suppressed_writes() - n_sup), 2);
+  led.invalidate();
+  led.write(0x00ff);
+  EXPECT_EQ_INT((int)(sim_bus().led.writes() - n_wr), 1);
+
+  pwm.set_duty(100, 3);
+  n_wr = sim_bus().pwm.writes();
+  pwm.set_duty(100, 3);
+  pwm.set_duty(200, 2);
+  EXPECT_EQ_INT((int)(sim_bus().pwm.writes() - n_wr), 1);
+  EXPECT_EQ_U32(sim_bus().pwm.duty(2), 200);
+
+  sseg.write_8ptn(ptn);
+  n_wr = sim_bus().sseg.writes();
+  sseg.write_1ptn(0x80, 6);   // left word only
+  EXPECT_EQ_INT((int)(sim_bus().sseg.writes() - n_wr), 1);
+  EXPECT_EQ_INT(sim_bus().sseg.ptn(6), 0x80);
+
+  // slot-addressed templates drop the same writes
+  SlotGpoCore<S2_LED> led_s;
+  SlotSsegCore<S8_SSEG> sseg_s;
+
+  led_s.write(0x0f0f);
+  n_wr = sim_bus().led.writes();
+  led_s.write(0x0f0f);
+  led_s.write(1, 0);
+  EXPECT_EQ_INT((int)(sim_bus().led.writes() - n_wr), 0);
+  sseg_s.write_8ptn(ptn);
+  n_wr = sim_bus().sseg.writes();
+  sseg_s.write_1ptn(0x80, 6);
+  sseg_s.write_1ptn(0x80, 6);
+  EXPECT_EQ_INT((int)(sim_bus().sseg.writes() - n_wr), 1);
+  EXPECT_EQ_INT(sim_bus().sseg.ptn(6), 0x80);
+  // the class drivers no longer match the cores
+  led.invalidate();
+  sseg.invalidate();
+}
+
+// checks that queued writes reach the cores only on flush, coalesced
+static void test_batch() {
+  std::puts("\n=== test batch writes ===");
+  IoBatch out;
+  unsigned long n_wr, n_burst;
+
+  led.write(0);
+  sseg.write_1ptn(0xff, 0);
+  n_wr = sim_bus().writes();
+  n_burst = sim_bus().bursts();
+  led.set_batch(&out);
+  sseg.set_batch(&out);
+  pwm.set_batch(&out);
+  led.write(0x0f);
+  led.write(0xf0);            // replaces the pending led write
+  sseg.write_1ptn(0x80, 0);   // right word only
+  pwm.set_duty(300, 5);
+  EXPECT_EQ_INT(out.pending(), 3);
+  EXPECT_EQ_INT((int)(sim_bus().writes() - n_wr), 0);
+  EXPECT_EQ_U32(sim_bus().led.dout(), 0);
+  out.flush();
+  EXPECT_EQ_INT(out.pending(), 0);
+  EXPECT_EQ_INT((int)(sim_bus().writes() - n_wr), 3);
+  EXPECT_EQ_INT((int)(sim_bus().bursts() - n_burst), 1);
+  EXPECT_EQ_U32(sim_bus().led.dout(), 0xf0);
+  EXPECT_EQ_INT(sim_bus().sseg.ptn(0), 0x80);
+  EXPECT_EQ_U32(sim_bus().pwm.duty(5), 300);
+
+  for (int i = 0; i < IO_BATCH_SIZE; i++)
+    out.add(get_slot_addr(BRIDGE_BASE, S7_BTN) + 4 * i, i);
+  out.add(get_slot_addr(BRIDGE_BASE, S2_LED), 0x55);   // full: flushes first
+  EXPECT_EQ_INT(out.pending(), 1);
+  out.flush();
+  EXPECT_EQ_U32(sim_bus().led.dout(), 0x55);
+  led.set_batch(0);
+  sseg.set_batch(0);
+  pwm.set_batch(0);
+}
+
+// checks an ADT7420 read through the i2c core
+static void test_i2c() {
+  std::puts("\n=== test i2c ===");
+  uint8_t wbytes[1], bytes[2];
+  int ack;
+  uint16_t tmp;
+
+  sim_bus().i2c.adt7420().set_temp(27.5);
+  wbytes[0] = 0x00;
+  ack = adt7420.write_transaction(0x4b, wbytes, 1, 1);
+  EXPECT_EQ_INT(ack, 0);
+  ack = adt7420.read_transaction(0x4b, bytes, 2, 0);
+  EXPECT_EQ_INT(ack, 0);
+  tmp = (uint16_t)((bytes[0] << 8) | bytes[1]);
+  EXPECT_NEAR((float)(tmp >> 3) / 16, 27.5f, 1e-6f);
+
+  wbytes[0] = 0x0b;
+  adt7420.write_transaction(0x4b, wbytes, 1, 1);
+  adt7420.read_transaction(0x4b, bytes, 1, 0);
+  EXPECT_EQ_INT(bytes[0], 0xcb);
+
+  ack = adt7420.write_transaction(0x48, wbytes, 1, 0);
+  EXPECT_TRUE(ack != 0);
+}
+
+// checks the trace ring buffer and its binary stream-out
+static void test_trace() {
+  std::puts("\n=== test io trace ===");
+  uint32_t addr = get_slot_addr(BRIDGE_BASE, S2_LED);
+  IoTraceRec r0, r1;
+  size_t pos;
+  std::string &log = sim_bus().uart.tx_log();
+
+  io_trace_clear();
+  io_trace_start(bit(S2_LED));
+  io_trace_wr(addr, 0x1234);
+  io_trace_rd(get_slot_addr(BRIDGE_BASE, S3_SW), 0x55);   // slot not selected
+  io_trace_rd(addr + 4, 0x5678);
+  io_trace_stop();
+  io_trace_wr(addr, 0x9abc);
+  EXPECT_EQ_INT(io_trace_count(), 2);
+  io_trace_get(0, &r0);
+  io_trace_get(1, &r1);
+  EXPECT_EQ_U32(r0.addr, (1u << IO_TRACE_WR_BIT) | (S2_LED * 32));
+  EXPECT_EQ_U32(r0.data, 0x1234);
+  EXPECT_EQ_U32(r1.addr, S2_LED * 32 + 1);
+  EXPECT_TRUE(r1.tick > r0.tick);
+  EXPECT_EQ_INT(io_trace_get(2, &r1), -1);
+
+  io_trace_start(0xffffffff);
+  for (int i = 0; i < IO_TRACE_DEPTH + 10; i++)
+    io_trace_wr(addr, i);
+  io_trace_stop();
+  EXPECT_EQ_INT(io_trace_count(), IO_TRACE_DEPTH);
+  EXPECT_EQ_INT((int)io_trace_lost(), 12);
+  io_trace_get(0, &r0);
+  EXPECT_EQ_U32(r0.data, 10);
+
+  // the dump outlasts the watchdog timeout; its kicks keep the tag
+  WdtCore w(get_slot_addr(BRIDGE_BASE, S4_WDT));
+  unsigned long resets = sim_bus().wdt.resets();
+  uint64_t t0;
+
+  uart.set_baud_rate(921600);
+  w.start(TimerCore::ms2tick(10));
+  w.kick(5);
+  io_trace_set_watchdog(&w);
+  sim_bus().uart.drain();
+  pos = log.size();
+  sim_bus().uart.set_echo(0);   // binary
+  t0 = sim_bus().cycle();
+  io_trace_dump();
+  sim_bus().uart.drain();
+  sim_bus().uart.set_echo(1);
+  EXPECT_TRUE(sim_bus().cycle() - t0 > TimerCore::ms2tick(50));
+  EXPECT_EQ_INT((int)(sim_bus().wdt.resets() - resets), 0);
+  EXPECT_EQ_INT(w.tag(), 5);
+  w.stop();
+  io_trace_set_watchdog(0);
+  uart.set_baud_rate(9600);
+  EXPECT_EQ_INT((int)(log.size() - pos), 16 + IO_TRACE_DEPTH * IO_TRACE_REC_SIZE + 4);
+  EXPECT_TRUE(log.compare(pos, 4, "IOTR") == 0);
+  io_trace_clear();
+}
+
+// checks probe statistics and the log2 histogram
+static void test_prof() {
+  std::puts("\n=== test profiler ===");
+  static ProfProbe p = {"test"};
+  uint32_t t0, t1;
+
+  prof_record(&p, 100);   // bin 6
+  prof_record(&p, 1);     // bin 0
+  prof_record(&p, 4095);  // bin 11
+  prof_record(&p, 4096);  // bin 12
+  EXPECT_EQ_INT((int)p.count, 4);
+  EXPECT_EQ_INT((int)p.min, 1);
+  EXPECT_EQ_INT((int)p.max, 4096);
+  EXPECT_EQ_INT((int)p.total, 8292);
+  EXPECT_EQ_INT((int)p.hist[0], 1);
+  EXPECT_EQ_INT((int)p.hist[6], 1);
+  EXPECT_EQ_INT((int)p.hist[11], 1);
+  EXPECT_EQ_INT((int)p.hist[12], 1);
+  prof_record(&p, 1ULL << 40);   // clamped to the last bin
+  EXPECT_EQ_INT((int)p.hist[PROF_N_BIN - 1], 1);
+
+  t0 = prof_tick();
+  sleep_us(10);
+  t1 = prof_tick();
+  EXPECT_TRUE((uint32_t)(t1 - t0) >= 10 * SYS_CLK_FREQ);
+  prof_clear();
+  EXPECT_EQ_INT((int)p.count, 0);
+  EXPECT_EQ_INT((int)p.hist[6], 0);
+
+  // a report blocks instead of dropping its tail, then restores the mode
+  uart.set_tx_mode(UartCore::TX_DROP);
+  int mode = report_begin();
+  EXPECT_EQ_INT(mode, UartCore::TX_DROP);
+  EXPECT_EQ_INT(uart.get_tx_mode(), UartCore::TX_BLOCK);
+  report_end(mode);
+  prof_report();
+  EXPECT_EQ_INT(uart.get_tx_mode(), UartCore::TX_DROP);
+  uart.set_tx_mode(UartCore::TX_DIRECT);
+}
+
+// checks that a carry of the lower word between the two reads of
+// read_tick() does not corrupt the 48-bit value
+static void test_timer_snapshot() {
+  std::puts("\n=== test timer snapshot ===");
+  extern TimerCore _sys_timer;   // chu_init.cpp
+  TimerCore &timer = _sys_timer;
+  uint64_t c, t, prev;
+  int back = 0;
+
+  // next lower-word read returns 0xfffffffe; carry before the upper read
+  c = sim_bus().timer.count();
+  sim_bus().advance((0xfffffffeULL - (c & 0xffffffffULL) - SimBus::DEF_ACCESS_CYCLES) & 0xffffffffULL);
+  c = sim_bus().timer.count();
+  t = timer.read_tick();
+  EXPECT_EQ_U32((uint32_t)t, 0xfffffffe);
+  EXPECT_EQ_U32((uint32_t)(t >> 32), (uint32_t)(c >> 32));
+  EXPECT_TRUE(sim_bus().timer.count() > t);
+  EXPECT_TRUE(sim_bus().timer.count() - t < 100);
+
+  prev = timer.read_tick();
+  for (int i = 0; i < 1000; i++) {
+    t = timer.read_tick();
+    if (t < prev)
+      back++;
+    prev = t;
+  }
+  EXPECT_EQ_INT(back, 0);
+  EXPECT_EQ_U32((uint32_t)(timer.read_tick32() - (uint32_t)prev) < 100, 1);
+}
+
+static void test_timer_alarm() {
+  std::puts("\n=== test timer alarm ===");
+  extern TimerCore _sys_timer;   // chu_init.cpp
+  TimerCore &timer = _sys_timer;
+  SimBus &bus = sim_bus();
+  uint64_t t, deadline;
+  unsigned long rd0, wr0;
+
+  // deadline wait: 2 writes to arm, then 1 status read per poll
+  t = timer.read_tick();
+  deadline = t + TimerCore::us2tick(200);
+  rd0 = bus.reads();
+  wr0 = bus.writes();
+  timer.sleep_until(deadline);
+  EXPECT_EQ_INT((int)(bus.writes() - wr0), 2);
+  EXPECT_TRUE(bus.timer.count() >= deadline);
+  EXPECT_TRUE(bus.timer.count() - deadline < 100);
+  EXPECT_TRUE(bus.reads() - rd0 <= TimerCore::us2tick(200) / SimBus::DEF_ACCESS_CYCLES + 2);
+
+  // sticky flag: stays set; cleared by cancel
+  bus.advance(1000);
+  EXPECT_EQ_INT(timer.alarm_expired(), 1);
+  timer.cancel_alarm();
+  EXPECT_EQ_INT(timer.alarm_expired(), 0);
+
+  // not reached yet; checks between other work
+  timer.set_alarm(timer.read_tick() + 5000);
+  EXPECT_EQ_INT(timer.alarm_expired(), 0);
+  bus.advance(4000);
+  EXPECT_EQ_INT(timer.alarm_expired(), 0);
+  bus.advance(1000);
+  EXPECT_EQ_INT(timer.alarm_expired(), 1);
+
+  // a deadline already passed matches at once
+  timer.set_alarm(timer.read_tick() - 10);
+  EXPECT_EQ_INT(timer.alarm_expired(), 1);
+
+  // interrupt line follows match only when enabled
+  EXPECT_EQ_INT(bus.timer.irq(), 0);
+  timer.alarm_irq(1);
+  EXPECT_EQ_INT(bus.timer.irq(), 1);
+  timer.cancel_alarm();
+  EXPECT_EQ_INT(bus.timer.irq(), 0);
+  timer.alarm_irq(0);
+  t = timer.read_tick();
+  bus.advance(100);
+  EXPECT_TRUE(timer.read_tick() > t);   // counter still running
+}
+
+// task body: logs its id and stays busy for a number of clocks
+struct SchedWork {
+  char id;
+  uint64_t clocks;
+};
+static std::string g_sched_log;
+static void sched_work(void *arg) {
+  SchedWork *w = (SchedWork *)arg;
+
+  g_sched_log += w->id;
+  sim_bus().advance(w->clocks);
+}
+
+static void test_sched() {
+  std::puts("\n=== test scheduler ===");
+  SchedWork fast_work = {'f', 100};
+  SchedWork slow_work = {'s', TimerCore::ms2tick(3)};
+  SchedTask fast = {"fast", sched_work, &fast_work, TimerCore::ms2tick(1)};
+  SchedTask slow = {"slow", sched_work, &slow_work, TimerCore::ms2tick(5)};
+  Scheduler s;
+  uint64_t t0, t0_fast;
+
+  s.add(&slow);
+  s.add(&fast);
+  t0 = slow.st.release;
+  t0_fast = fast.st.release;
+  g_sched_log.clear();
+  s.run_until(t0 + TimerCore::ms2tick(20));
+  // earliest deadline first at the common release
+  EXPECT_TRUE(g_sched_log.compare(0, 2, "fs") == 0);
+  EXPECT_EQ_INT(fast.deadline == TimerCore::ms2tick(1), 1);
+  // slow: on its grid, no drift from the execution time
+  EXPECT_EQ_INT((int)slow.st.runs, 4);
+  EXPECT_EQ_INT((int)slow.st.overruns, 0);
+  EXPECT_TRUE(slow.st.release - t0 == TimerCore::ms2tick(20));
+  EXPECT_TRUE(slow.st.exec_max >= slow_work.clocks);
+  // fast: blocked 3 ms by slow each 5 ms -> late and skipped releases
+  EXPECT_EQ_INT((int)(fast.st.runs + fast.st.skipped), 20);
+  EXPECT_TRUE(fast.st.skipped > 0);
+  EXPECT_TRUE(fast.st.overruns > 0);
+  EXPECT_TRUE(fast.st.jitter_max >= TimerCore::ms2tick(1));
+  EXPECT_TRUE((fast.st.release - t0_fast) % TimerCore::ms2tick(1) == 0);
+
+  EXPECT_TRUE(s.next_release() == t0 + TimerCore::ms2tick(20));
+  s.report();
+  s.clear_stats();
+  EXPECT_EQ_INT((int)fast.st.runs, 0);
+  EXPECT_EQ_INT((int)fast.st.jitter_max, 0);
+}
+
+// timer callback: logs the firing time; arg is the timer's TwTest
+struct TwTest {
+  TwTimer tmr;
+  int fired;
+  uint64_t last;     // tick of the last firing
+  int early;         // fired before its expiry
+  uint64_t late_max;
+};
+static TimerWheel *g_wheel;
+static void tw_cb(void *arg) {
+  TwTest *t = (TwTest *)arg;
+  uint64_t now = sim_bus().timer.count();
+  uint64_t due = t->tmr.pending ? t->tmr.expire - t->tmr.period : t->tmr.expire;
+
+  t->fired++;
+  t->last = now;
+  if (now < due)
+    t->early++;
+  else if (now - due > t->late_max)
+    t->late_max = now - due;
+}
+static void tw_cancel_cb(void *arg) {   // cancels the timer in arg
+  g_wheel->cancel((TwTimer *)arg);
+}
+
+static void test_twheel() {
+  std::puts("\n=== test timer wheel ===");
+  const uint64_t GRAN = 1ULL << TW_GRAN_BIT;
+  const uint64_t POLL = TimerCore::us2tick(500);
+  TimerWheel w;
+  TwTest a = {}, b = {}, c = {}, d = {}, e = {}, p = {};
+  TwTimer killer = {tw_cancel_cb, &e.tmr, {0, 0}, 0, 0, 0};
+  TwTest *all[] = {&a, &b, &c, &d, &e, &p};
+  unsigned long rd0;
+  uint64_t t0, nt;
+  int n_poll = 0, bad_rd = 0, early = 0;
+
+  g_wheel = &w;
+  for (TwTest *t : all) {
+    t->tmr.func = tw_cb;
+    t->tmr.arg = t;
+  }
+  w.poll();                                              // reads the time base
+  t0 = sim_bus().timer.count();
+  w.start(&a.tmr, TimerCore::ms2tick(1));                    // level 0
+  w.start(&b.tmr, TimerCore::ms2tick(100));                  // level 1
+  w.start(&c.tmr, TimerCore::ms2tick(3000));                 // level 2
+  w.start(&d.tmr, TimerCore::ms2tick(50));                   // cancelled below
+  w.start(&e.tmr, TimerCore::ms2tick(40));                   // cancelled by killer
+  w.start(&killer, TimerCore::ms2tick(20));
+  w.start(&p.tmr, TimerCore::ms2tick(10), TimerCore::ms2tick(10));   // periodic
+  EXPECT_EQ_INT(w.count(), 7);
+  nt = w.next_tick();
+  EXPECT_TRUE(nt == a.tmr.expire);
+  w.cancel(&d.tmr);
+  w.cancel(&d.tmr);                                      // no effect
+  EXPECT_EQ_INT(w.count(), 6);
+
+  while (sim_bus().timer.count() - t0 < TimerCore::ms2tick(3100)) {
+    sim_bus().advance(POLL);
+    rd0 = sim_bus().reads();
+    w.poll();
+    if (sim_bus().reads() - rd0 != 1)
+      bad_rd++;
+    n_poll++;
+  }
+  EXPECT_EQ_INT(bad_rd, 0);                              // 1 bus read per pass
+  EXPECT_EQ_INT(a.fired, 1);
+  EXPECT_EQ_INT(b.fired, 1);
+  EXPECT_EQ_INT(c.fired, 1);
+  EXPECT_EQ_INT(d.fired, 0);
+  EXPECT_EQ_INT(e.fired, 0);
+  EXPECT_TRUE(p.fired >= 309 && p.fired <= 310);         // every 10 ms, no drift
+  for (TwTest *t : all) {
+    early += t->early;
+    EXPECT_TRUE(t->late_max <= GRAN + POLL + 100);
+  }
+  EXPECT_EQ_INT(early, 0);
+  EXPECT_EQ_INT(w.count(), 1);                           // periodic p only
+  EXPECT_TRUE(w.next_tick() == p.tmr.expire);
+
+  // callback restarting from service(); cancel of the periodic timer
+  w.cancel(&p.tmr);
+  EXPECT_EQ_INT(w.count(), 0);
+  EXPECT_TRUE(w.next_tick() == ~0ULL);
+  w.start_at(&a.tmr, sim_bus().timer.count() + GRAN / 2);
+  EXPECT_EQ_INT(w.service(sim_bus().timer.count()), 0);
+  EXPECT_EQ_INT(w.service(sim_bus().timer.count() + 2 * GRAN), 1);
+  EXPECT_EQ_INT(a.fired, 2);
+}
+
+static void test_watchdog() {
+  std::puts("\n=== test watchdog ===");
+  WdtCore w(get_slot_addr(BRIDGE_BASE, S4_WDT));
+  SimBus &bus = sim_bus();
+  const uint32_t TMO = TimerCore::us2tick(100);
+
+  EXPECT_EQ_INT(w.fired(), 0);
+  w.start(TMO);
+  for (int i = 0; i < 10; i++) {
+    bus.advance(TMO / 2);
+    w.kick(7);
+  }
+  EXPECT_EQ_INT((int)bus.wdt.resets(), 0);
+  EXPECT_TRUE(w.remaining() > TMO / 2);
+  io_write(get_slot_addr(BRIDGE_BASE, S4_WDT), WdtCore::KICK_REG, 0x12340009);   // bad key
+  EXPECT_EQ_INT(w.tag(), 7);
+  bus.advance(TMO);
+  EXPECT_EQ_INT((int)bus.wdt.resets(), 1);
+  EXPECT_EQ_INT(w.fired(), 1);
+  EXPECT_EQ_INT(w.tag(), 7);
+  w.clear_flag();
+  EXPECT_EQ_INT(w.fired(), 0);
+  bus.advance(2 * TMO);                 // disabled after firing
+  EXPECT_EQ_INT((int)bus.wdt.resets(), 1);
+
+  // a task that hangs: watchdog names it; deadline monitor records it
+  SchedWork ok_work = {'o', 100};
+  SchedWork hang_work = {'h', 3 * TMO};
+  SchedTask ok = {"ok", sched_work, &ok_work, TimerCore::us2tick(50)};
+  SchedTask hang = {"hang", sched_work, &hang_work, TimerCore::ms2tick(1), 0, TimerCore::us2tick(200)};
+  Scheduler s;
+
+  s.add(&ok);
+  s.add(&hang);
+  w.start(TMO);
+  s.set_watchdog(&w);
+  s.run_until(bus.timer.count() + TimerCore::us2tick(600));
+  w.stop();
+  EXPECT_EQ_INT((int)bus.wdt.resets(), 2);
+  EXPECT_EQ_INT(w.fired(), 1);
+  EXPECT_TRUE(std::string(s.task_name(w.tag())) == "hang");
+  EXPECT_TRUE(std::string(s.task_name(0)) == "idle");
+  EXPECT_TRUE(s.worst_task() == &ok);   // delayed behind hang
+  EXPECT_TRUE(s.busy_max() >= 3 * TMO);
+  EXPECT_TRUE(bus.wdt.reset_cycle() > 0);
+  w.clear_flag();
+}
+
+// Test Implementations
+int main() {
+  test_io_map();
+  test_timer();
+  test_tick_div();
+  test_timer_alarm();
+  test_sched();
+  test_twheel();
+  test_watchdog();
+  test_uart();
+  test_uart_ring();
+  test_uart_level();
+  test_uart_baud();
+  test_fmt();
+  test_fmt_fix();
+  test_print();
+  test_telem();
+  test_log();
+  test_gpio();
+  test_xadc();
+  test_pwm();
+  test_sseg();
+  test_shadow();
+  test_batch();
+  test_i2c();
+  test_trace();
+  test_prof();
+  test_timer_snapshot();   // last: moves the clock past a 2^32 boundary
+
+  if (g_fail == 0) {
+    std::puts("\nALL TESTS PASSED ");
+    return 0;
+  }
+  std::printf("\nTESTS FAILED   count=%d\n", g_fail);
+  return 1;
+}
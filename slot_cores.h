@@ -0,0 +1,428 @@
+/*****************************************************************//**
+ * @file slot_cores.h
+ *
+ * @brief Slot-addressed (compile-time) variants of the MMIO core drivers
+ *
+ * Detailed description:
+ *  - each class is a template on the io slot # (e.g., S8_SSEG)
+ *  - the core base address is a compile-time constant, so each
+ *    io_read()/io_write() folds to a load/store at an absolute address;
+ *    no base_addr member and no per-access address add
+ *  - objects carry no data; driver state (e.g., 7-seg pattern buffer)
+ *    is kept in static members, one copy per slot
+ *  - register maps, field masks and the value computations (divisors,
+ *    clamps, conversions, 7-seg packing, i2c transactions) are the
+ *    static helpers of the original classes; a template only adds the
+ *    compile-time base address and per-slot state, so the variants
+ *    cannot drift apart
+ *  - constructors perform the same initialization as the original ones
+ *  - write-only cores (gpo, pwm, sseg) drop repeated writes through the
+ *    same IoShadow logic as the original classes (one copy per slot)
+ *  - usage:
+ *      SlotSsegCore<S8_SSEG> sseg;
+ *      sseg.write_1ptn(sseg.h2s(3), 0);
+ *  - see slot_cores_bench.cpp for a size/cycle comparison
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _SLOT_CORES_H_INCLUDED
+#define _SLOT_CORES_H_INCLUDED
+
+#include "chu_init.h"
+#include "gpio_cores.h"
+#include "xadc_core.h"
+#include "sseg_core.h"
+#include "i2c_core.h"
+#include "chu_io_shadow.h"
+
+/**********************************************************************
+ * timer core
+ **********************************************************************/
+/**
+ * slot-addressed timer core driver (see TimerCore)
+ */
+template <int SLOT>
+class SlotTimerCore {
+public:
+   static const uint32_t BASE = get_slot_addr(BRIDGE_BASE, SLOT);
+
+   SlotTimerCore() {
+      ctrl = 0x01;
+      clear();
+      io_write(BASE, TimerCore::CTRL_REG, ctrl);  // enable the timer
+   }
+
+   void pause() {
+      ctrl = ctrl & ~TimerCore::GO_FIELD;
+      io_write(BASE, TimerCore::CTRL_REG, ctrl);
+   }
+
+   void go() {
+      ctrl = ctrl | TimerCore::GO_FIELD;
+      io_write(BASE, TimerCore::CTRL_REG, ctrl);
+   }
+
+   void clear() {
+      io_write(BASE, TimerCore::CTRL_REG, ctrl | TimerCore::CLR_FIELD);
+   }
+
+   uint64_t read_tick() {
+      uint64_t upper, lower;
+
+      lower = (uint64_t) io_read(BASE, TimerCore::COUNTER_LOWER_REG);
+      upper = (uint64_t) io_read(BASE, TimerCore::COUNTER_UPPER_REG);
+      return ((upper << 32) | lower);
+   }
+
+   uint64_t read_time() {
+      return (TimerCore::tick2us(read_tick()));
+   }
+
+   void sleep(uint64_t us) {
+      uint64_t start, ticks = TimerCore::us2tick(us);
+
+      start = read_tick();
+      while ((read_tick() - start) < ticks) {
+      }
+   }
+
+private:
+   static uint32_t ctrl;
+};
+
+template <int SLOT> uint32_t SlotTimerCore<SLOT>::ctrl = 0x01;
+
+/**********************************************************************
+ * uart core (byte i/o only)
+ **********************************************************************/
+/**
+ * slot-addressed uart core driver (see UartCore)
+ *
+ * @note only byte and string i/o; number formatting stays in UartCore
+ */
+template <int SLOT>
+class SlotUartCore {
+public:
+   static const uint32_t BASE = get_slot_addr(BRIDGE_BASE, SLOT);
+
+   SlotUartCore() {
+      set_baud_rate(9600);
+   }
+
+   // same clamp and divisor selection as UartCore::set_baud_rate()
+   void set_baud_rate(int baud) {
+      io_write(BASE, UartCore::DVSR_REG, UartCore::dvsr_word(UartCore::baud_dvsr_q8(baud)));
+   }
+
+   int rx_fifo_empty() {
+      return ((int) io_read_field(BASE, uart_regs::RX_EMPT));
+   }
+
+   int tx_fifo_full() {
+      return ((int) io_read_field(BASE, uart_regs::TX_FULL));
+   }
+
+   void tx_byte(uint8_t byte) {
+      while (tx_fifo_full()) {
+      };  // busy waiting
+      io_write(BASE, UartCore::WR_DATA_REG, (uint32_t) byte);
+   }
+
+   int rx_byte() {
+      uint32_t data;
+
+      data = io_read(BASE, UartCore::RD_DATA_REG);
+      if (data & UartCore::RX_EMPT_FIELD)
+         return (-1);
+      io_write(BASE, UartCore::RM_RD_DATA_REG, 0);
+      return ((int) (data & UartCore::RX_DATA_FIELD));
+   }
+
+   void disp(char ch) {
+      tx_byte(ch);
+   }
+
+   void disp(const char *str) {
+      while ((uint8_t) *str) {
+         tx_byte(*str);
+         str++;
+      }
+   }
+};
+
+/**********************************************************************
+ * gpi/gpo cores
+ **********************************************************************/
+/**
+ * slot-addressed gpi core driver (see GpiCore)
+ */
+template <int SLOT>
+class SlotGpiCore {
+public:
+   static const uint32_t BASE = get_slot_addr(BRIDGE_BASE, SLOT);
+
+   uint32_t read() {
+      return (io_read(BASE, GpiCore::DATA_REG));
+   }
+
+   int read(int bit_pos) {
+      uint32_t rd_data = io_read(BASE, GpiCore::DATA_REG);
+      return ((int) bit_read(rd_data, bit_pos));
+   }
+};
+
+/**
+ * slot-addressed gpo core driver (see GpoCore)
+ */
+template <int SLOT>
+class SlotGpoCore {
+public:
+   static const uint32_t BASE = get_slot_addr(BRIDGE_BASE, SLOT);
+
+   SlotGpoCore() {
+      wr_data = 0;
+   }
+
+   void write(uint32_t data) {
+      wr_data = data;
+      if (regs.update(GpoCore::DATA_REG, wr_data))
+         io_write(BASE, GpoCore::DATA_REG, wr_data);
+   }
+
+   void write(int bit_value, int bit_pos) {
+      bit_write(wr_data, bit_pos, bit_value);
+      if (regs.update(GpoCore::DATA_REG, wr_data))
+         io_write(BASE, GpoCore::DATA_REG, wr_data);
+   }
+
+   unsigned long suppressed_writes() {
+      return (regs.suppressed());
+   }
+
+   void invalidate() {
+      regs.invalidate();
+   }
+
+private:
+   static uint32_t wr_data;   // same as GPO core data reg
+   static IoShadow<1> regs;   // last value written to data reg
+};
+
+template <int SLOT> uint32_t SlotGpoCore<SLOT>::wr_data = 0;
+template <int SLOT> IoShadow<1> SlotGpoCore<SLOT>::regs;
+
+/**********************************************************************
+ * pwm core
+ **********************************************************************/
+/**
+ * slot-addressed pwm core driver (see PwmCore)
+ */
+template <int SLOT>
+class SlotPwmCore {
+public:
+   static const uint32_t BASE = get_slot_addr(BRIDGE_BASE, SLOT);
+
+   SlotPwmCore() {
+      set_freq(1000);
+   }
+
+   void set_freq(int freq) {
+      uint32_t dvsr = PwmCore::freq_dvsr(freq);
+
+      if (regs.update(PwmCore::DVSR_REG, dvsr))
+         io_write(BASE, PwmCore::DVSR_REG, dvsr);
+   }
+
+   void set_duty(int duty, int channel) {
+      uint32_t d;
+
+      if (!PwmCore::channel_ok(channel))
+         return;
+      d = PwmCore::duty_val(duty);
+      if (regs.update(PwmCore::DUTY_REG_BASE + channel, d))
+         io_write(BASE, PwmCore::DUTY_REG_BASE + channel, d);
+   }
+
+   void set_duty(double f, int channel) {
+      set_duty((int) (f * PwmCore::MAX), channel);
+   }
+
+   unsigned long suppressed_writes() {
+      return (regs.suppressed());
+   }
+
+   void invalidate() {
+      regs.invalidate();
+   }
+
+private:
+   // divisor and duty regs
+   static IoShadow<PwmCore::DUTY_REG_BASE + PWM_DUTY_REG_BASE_COUNT> regs;
+};
+
+template <int SLOT>
+IoShadow<PwmCore::DUTY_REG_BASE + PWM_DUTY_REG_BASE_COUNT> SlotPwmCore<SLOT>::regs;
+
+/**********************************************************************
+ * xadc core
+ **********************************************************************/
+/**
+ * slot-addressed xadc core driver (see XadcCore)
+ */
+template <int SLOT>
+class SlotXadcCore {
+public:
+   static const uint32_t BASE = get_slot_addr(BRIDGE_BASE, SLOT);
+
+   uint16_t read_raw(int n) {
+      return ((uint16_t) io_read(BASE, n) & 0x0000ffff);
+   }
+
+   double read_adc_in(int n) {
+      return (XadcCore::raw2adc_in(read_raw(n)));
+   }
+
+   double read_fpga_vcc() {
+      return (XadcCore::adc_in2vcc(read_adc_in(XadcCore::VCC_REG)));
+   }
+
+   double read_fpga_temp() {
+      return (XadcCore::adc_in2temp(read_adc_in(XadcCore::TMP_REG)));
+   }
+};
+
+/**********************************************************************
+ * seven-segment LED core
+ **********************************************************************/
+/**
+ * slot-addressed seven-segment LED core driver (see SsegCore)
+ */
+template <int SLOT>
+class SlotSsegCore {
+public:
+   static const uint32_t BASE = get_slot_addr(BRIDGE_BASE, SLOT);
+
+   SlotSsegCore() {
+      // pattern for "HI"
+      const uint8_t HI_PTN[] = {0xff,0xf9,0x89,0xff,0xff,0xff,0xff,0xff};
+      write_8ptn((uint8_t*) HI_PTN);
+      set_dp(0x02);
+   }
+
+   uint8_t h2s(int hex) {
+      return (SsegCore::h2s(hex));
+   }
+
+   void write_1ptn(uint8_t pattern, int pos) {
+      ptn_buf[pos] = pattern;
+      write_led();
+   }
+
+   void write_8ptn(uint8_t *ptn_array) {
+      for (int i = 0; i < 8; i++)
+         ptn_buf[i] = ptn_array[i];
+      write_led();
+   }
+
+   void set_dp(uint8_t pt) {
+      dp = ~pt;     // active low
+      write_led();
+   }
+
+   unsigned long suppressed_writes() {
+      return (regs.suppressed());
+   }
+
+   void invalidate() {
+      regs.invalidate();
+   }
+
+private:
+   static uint8_t ptn_buf[8];    // led pattern buffer
+   static uint8_t dp;            // decimal point
+   static IoShadow<2> regs;      // last words written to data regs
+
+   void write_led() {
+      uint32_t word;
+
+      word = SsegCore::pack(ptn_buf, dp, 0);
+      if (regs.update(SsegCore::DATA_LOW_REG, word))
+         io_write(BASE, SsegCore::DATA_LOW_REG, word);
+      word = SsegCore::pack(ptn_buf, dp, 4);
+      if (regs.update(SsegCore::DATA_HIGH_REG, word))
+         io_write(BASE, SsegCore::DATA_HIGH_REG, word);
+   }
+};
+
+template <int SLOT> uint8_t SlotSsegCore<SLOT>::ptn_buf[8];
+template <int SLOT> uint8_t SlotSsegCore<SLOT>::dp;
+template <int SLOT> IoShadow<2> SlotSsegCore<SLOT>::regs;
+
+/**********************************************************************
+ * i2c core
+ **********************************************************************/
+/**
+ * slot-addressed i2c core driver (see I2cCore)
+ */
+template <int SLOT>
+class SlotI2cCore {
+public:
+   static const uint32_t BASE = get_slot_addr(BRIDGE_BASE, SLOT);
+
+   SlotI2cCore() {
+      set_freq(100000);  // default 100K Hz
+   }
+
+   void set_freq(int freq) {
+      io_write(BASE, I2cCore::DVSR_REG, I2cCore::freq_dvsr(freq));
+   }
+
+   int ready() {
+      return ((int) io_read_field(BASE, i2c_regs::READY));
+   }
+
+   void start() {
+      cmd(I2cCore::I2C_START_CMD);
+   }
+
+   void restart() {
+      cmd(I2cCore::I2C_RESTART_CMD);
+   }
+
+   void stop() {
+      cmd(I2cCore::I2C_STOP_CMD);
+   }
+
+   int write_byte(uint8_t data) {
+      cmd(data | I2cCore::I2C_WR_CMD);
+      while (!ready()) {
+      }
+      return (io_read_field(BASE, i2c_regs::ACK) ? -1 : 0);
+   }
+
+   int read_byte(int last) {
+      cmd(last | I2cCore::I2C_RD_CMD);
+      while (!ready()) {
+      }
+      return ((int) io_read_field(BASE, i2c_regs::DOUT));
+   }
+
+   int read_transaction(uint8_t dev, uint8_t *bytes, int num, int rstart) {
+      return (i2c_read_transaction(*this, dev, bytes, num, rstart));
+   }
+
+   int write_transaction(uint8_t dev, uint8_t *bytes, int num, int rstart) {
+      return (i2c_write_transaction(*this, dev, bytes, num, rstart));
+   }
+
+private:
+   void cmd(uint32_t acc_data) {
+      while (!ready()) {
+      }
+      io_write(BASE, I2cCore::WR_REG, acc_data);
+   }
+};
+
+#endif  // _SLOT_CORES_H_INCLUDED
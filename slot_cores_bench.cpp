@@ -0,0 +1,115 @@
+// Size/cycle comparison of the base_addr-member drivers against the
+// slot-addressed templates in slot_cores.h.
+//
+// target (MicroBlaze MCS): build as the application instead of
+//   main_sampler_test.cpp; results are printed over uart in clocks
+//   (SYS_CLK_FREQ) per call
+//   - build with -DBENCH_VARIANT=1 (class only) and -DBENCH_VARIANT=2
+//     (template only) and compare mb-size output for code size
+// host:
+//   g++ -O2 -D_SIM_IO_ACCESS_USED -I. slot_cores_bench.cpp chu_io_sim.cpp
+//       chu_init.cpp timer_core.cpp uart_core.cpp gpio_cores.cpp
+//       xadc_core.cpp sseg_core.cpp i2c_core.cpp -o slot_cores_bench
+//   - clocks are simulated bus clocks; equal numbers for both columns
+//     confirm both variants issue the same bus transactions (both drop
+//     repeated writes to gpo/pwm/sseg through IoShadow; the loops write
+//     a new value per call, so each call reaches the bus); the host
+//     bus charges every access the same, so the gain of the constant
+//     base address shows only in target clocks and mb-size
+
+#include "chu_init.h"
+#include "gpio_cores.h"
+#include "xadc_core.h"
+#include "sseg_core.h"
+#include "slot_cores.h"
+
+// 0: both variants; 1: class only; 2: template only
+#ifndef BENCH_VARIANT
+#define BENCH_VARIANT 0
+#endif
+
+#define BENCH_N 1000
+
+// lower 32 bits of the system timer (enough for short intervals)
+static inline uint32_t bench_tick() {
+   return (io_read(get_slot_addr(BRIDGE_BASE, TIMER_SLOT),
+                   TimerCore::COUNTER_LOWER_REG));
+}
+
+// measure the clocks of BENCH_N executions of stmt
+#define BENCH(result, stmt) do { \
+   uint32_t t0 = bench_tick(); \
+   for (int i = 0; i < BENCH_N; i++) { \
+      stmt; \
+   } \
+   result = bench_tick() - t0; \
+} while (0)
+
+struct BenchResult {
+   const char *name;
+   uint32_t cls;
+   uint32_t slot;
+};
+
+#if BENCH_VARIANT != 2
+GpoCore led(get_slot_addr(BRIDGE_BASE, S2_LED));
+GpiCore sw(get_slot_addr(BRIDGE_BASE, S3_SW));
+XadcCore adc(get_slot_addr(BRIDGE_BASE, S5_XDAC));
+PwmCore pwm(get_slot_addr(BRIDGE_BASE, S6_PWM));
+SsegCore sseg(get_slot_addr(BRIDGE_BASE, S8_SSEG));
+#endif
+
+#if BENCH_VARIANT != 1
+SlotGpoCore<S2_LED> led_s;
+SlotGpiCore<S3_SW> sw_s;
+SlotXadcCore<S5_XDAC> adc_s;
+SlotPwmCore<S6_PWM> pwm_s;
+SlotSsegCore<S8_SSEG> sseg_s;
+#endif
+
+static void disp_result(BenchResult *r) {
+   uart.disp(r->name);
+   uart.disp((int) (r->cls / BENCH_N), 10, 8);
+   uart.disp((int) (r->slot / BENCH_N), 10, 8);
+   uart.disp("\n\r");
+}
+
+int main() {
+   BenchResult r[5];
+   volatile uint32_t sink = 0;
+
+   r[0].name = "gpo write      ";
+   r[1].name = "gpi read bit   ";
+   r[2].name = "pwm set_duty   ";
+   r[3].name = "sseg write_1ptn";
+   r[4].name = "xadc read_raw  ";
+   for (int k = 0; k < 5; k++) {
+      r[k].cls = 0;
+      r[k].slot = 0;
+   }
+#if BENCH_VARIANT != 2
+   BENCH(r[0].cls, led.write((uint32_t) i));
+   BENCH(r[1].cls, sink = sink + sw.read(i & 0x0f));
+   BENCH(r[2].cls, pwm.set_duty(i & 0x3ff, i & 0x07));
+   BENCH(r[3].cls, sseg.write_1ptn((uint8_t) i, i & 0x07));
+   BENCH(r[4].cls, sink = sink + adc.read_raw(XadcCore::TMP_REG));
+#endif
+#if BENCH_VARIANT != 1
+   BENCH(r[0].slot, led_s.write((uint32_t) i));
+   BENCH(r[1].slot, sink = sink + sw_s.read(i & 0x0f));
+   BENCH(r[2].slot, pwm_s.set_duty(i & 0x3ff, i & 0x07));
+   BENCH(r[3].slot, sseg_s.write_1ptn((uint8_t) i, i & 0x07));
+   BENCH(r[4].slot, sink = sink + adc_s.read_raw(XadcCore::TMP_REG));
+#endif
+   uart.disp("clocks per call    class    slot\n\r");
+   for (int k = 0; k < 5; k++)
+      disp_result(&r[k]);
+#if BENCH_VARIANT == 0
+   uart.disp("object bytes (sseg) ");
+   uart.disp((int) sizeof(sseg));
+   uart.disp(" / ");
+   uart.disp((int) sizeof(sseg_s));
+   uart.disp("\n\r");
+#endif
+   return (0);
+}
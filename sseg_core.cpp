@@ -5,6 +5,8 @@ SsegCore::SsegCore(uint32_t core_base_addr) {
    // i.e., HI_PTN[0] is the leftmost led
    const uint8_t HI_PTN[]={0xff,0xf9,0x89,0xff,0xff,0xff,0xff,0xff};
    base_addr = core_base_addr;
+   batch = 0;
+   dp = 0xff;
    write_8ptn((uint8_t*) HI_PTN);
    set_dp(0x02);
 }
@@ -13,31 +15,33 @@ SsegCore::~SsegCore() {
 }
 // not used
 
-void SsegCore::write_led() {
+uint32_t SsegCore::pack(const uint8_t *ptn, uint8_t dp, int first) {
    int i, p;
    uint32_t word = 0;
 
-   // pack left 4 patterns into a 32-bit word
-   // ptn_buf[0] is the leftmost led
+   // ptn[0] is the leftmost led
    for (i = 0; i < 4; i++) {
-      word = (word << 8) | ptn_buf[3 - i];
+      word = (word << 8) | ptn[first + 3 - i];
    }
    // incorporate decimal points (bit 7 of pattern)
    for (i = 0; i < 4; i++) {
-      p = bit_read(dp, i);
+      p = bit_read(dp, first + i);
       bit_write(word, 7 + 8 * i, p);
    }
-   io_write(base_addr, DATA_LOW_REG, word);
+   return (word);
+}
+
+void SsegCore::write_led() {
+   uint32_t word;
+
+   // pack left 4 patterns into a 32-bit word
+   word = pack(ptn_buf, dp, 0);
+   if (regs.update(DATA_LOW_REG, word))
+      io_write_or_queue(batch, base_addr, DATA_LOW_REG, word);
    // pack right 4 patterns into a 32-bit word
-   for (i = 0; i < 4; i++) {
-      word = (word << 8) | ptn_buf[7 - i];
-   }
-   // incorporate decimal points
-   for (i = 0; i < 4; i++) {
-      p = bit_read(dp, 4 + i);
-      bit_write(word, 7 + 8 * i, p);
-   }
-   io_write(base_addr, DATA_HIGH_REG, word);
+   word = pack(ptn_buf, dp, 4);
+   if (regs.update(DATA_HIGH_REG, word))
+      io_write_or_queue(batch, base_addr, DATA_HIGH_REG, word);
 }
 
 void SsegCore::write_8ptn(uint8_t *ptn_array) {
@@ -62,6 +66,18 @@ void SsegCore::set_dp(uint8_t pt) {
    write_led();
 }
 
+unsigned long SsegCore::suppressed_writes() {
+   return (regs.suppressed());
+}
+
+void SsegCore::invalidate() {
+   regs.invalidate();
+}
+
+void SsegCore::set_batch(IoBatch *b) {
+   batch = b;
+}
+
 // convert a hex digit to
 uint8_t SsegCore::h2s(int hex) {
    /* active-low hex digit 7-seg patterns (0-9,a-f); MSB assigned to 1 */
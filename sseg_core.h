@@ -23,6 +23,8 @@
 #define _SSEG_CORE_H_INCLUDED
 
 #include "chu_init.h"
+#include "chu_io_shadow.h"
+#include "chu_io_batch.h"
 
 /**
  * seven-segment LED core driver
@@ -34,8 +36,8 @@ public:
     * Register map
     */
    enum {
-      DATA_LOW_REG = 0, /**< 32-bit data for right 4 digits */
-      DATA_HIGH_REG = 1 /**<  32-bit data for left 4 digits */
+      DATA_LOW_REG = SSEG_DATA_LOW_REG,  /**< 32-bit data for right 4 digits */
+      DATA_HIGH_REG = SSEG_DATA_HIGH_REG /**<  32-bit data for left 4 digits */
    };
 
    /**
@@ -52,7 +54,17 @@ public:
     * @return 7-seg pattern w/ MSB equal to 1
     * @note return 0xff if hex exceeds 15
     */
-   uint8_t h2s(int hex);
+   static uint8_t h2s(int hex);
+
+   /**
+    * pack 4 patterns and their decimal points into a data word
+    * (also used by slot_cores.h)
+    * @param ptn 8-element pattern buffer
+    * @param dp decimal points (active low)
+    * @param first 0: DATA_LOW_REG word; 4: DATA_HIGH_REG word
+    * @return data word (pattern first + i in bits 8i+7..8i)
+    */
+   static uint32_t pack(const uint8_t *ptn, uint8_t dp, int first);
 
    /**
     * write one 7-seg pattern to a specific position
@@ -77,11 +89,32 @@ public:
     */
    void set_dp(uint8_t pt);
 
+   /**
+    * number of data word writes dropped because the register already
+    * held the word (e.g., only one half of the display changed)
+    * @return # suppressed writes
+    */
+   unsigned long suppressed_writes();
+
+   /**
+    * forget the shadow copies; next write of both words goes to the core
+    * @note use after the core is reset outside the driver
+    */
+   void invalidate();
+
+   /**
+    * queue data word writes into a batch instead of writing the core
+    * @param b batch flushed by the caller; 0 for immediate writes
+    */
+   void set_batch(IoBatch *b);
+
 private:
    /* variable to keep track of current status */
    uint32_t base_addr;
    uint8_t ptn_buf[8];    // led pattern buffer
    uint8_t dp;            // decimal point
+   IoShadow<2> regs;      // last words written to data regs
+   IoBatch *batch;        // 0: write immediately
    /* methods */
    void write_led();      // write patterns to reg
 }
@@ -0,0 +1,219 @@
+// Decodes the binary telemetry frames (chu_telem.h) of the sampler.
+//
+// build:
+//   g++ -O2 -I. telem_decode.cpp -o telem_decode
+// capture (board running main_sampler_test; send 'b' to switch to binary):
+//   stty -F /dev/ttyUSB1 921600 raw && cat /dev/ttyUSB1 > telem.bin
+// run:
+//   ./telem_decode [-q] telem.bin            capture file
+//   ./telem_decode [-q] [-b baud] /dev/ttyUSB1   live (raw mode; Ctrl-C ends)
+//     -q  statistics only, no CSV
+//     -b  baud rate of a tty (default 921600)
+//
+// - CSV on stdout: seq,time_us,channel,value (one line per sample);
+//   time_us is unwrapped from the 32-bit frame time
+// - chunks between 0x00 delimiters that fail COBS, length or crc are
+//   counted as bad; text output mixed into the stream (e.g., the 's'
+//   report) is skipped: the longest valid tail of a bad chunk is taken
+// - a gap in the 8-bit sequence number counts lost frames (e.g.,
+//   dropped by UartCore::TX_DROP); gaps of 128 or more are ambiguous
+// - statistics on stderr: frames, bad chunks, lost frames, bytes per
+//   frame and sample, frame rate and min/max/mean per channel
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <vector>
+
+#include "chu_telem.h"
+
+#define N_CH 16
+
+struct ChanStat {
+   unsigned long n;
+   double min, max, sum;
+};
+
+static volatile sig_atomic_t stop = 0;
+
+static void on_sigint(int) {
+   stop = 1;
+}
+
+static speed_t baud2speed(long baud) {
+   switch (baud) {
+   case 9600:   return (B9600);
+   case 19200:  return (B19200);
+   case 38400:  return (B38400);
+   case 57600:  return (B57600);
+   case 115200: return (B115200);
+   case 230400: return (B230400);
+   case 460800: return (B460800);
+   case 921600: return (B921600);
+   default:     return (0);
+   }
+}
+
+// raw 8N1 at baud; returns -1 on error
+static int set_raw(int fd, long baud) {
+   struct termios t;
+   speed_t sp = baud2speed(baud);
+
+   if (sp == 0) {
+      fprintf(stderr, "unsupported baud rate %ld\n", baud);
+      return (-1);
+   }
+   if (tcgetattr(fd, &t) < 0) {
+      perror("tcgetattr");
+      return (-1);
+   }
+   cfmakeraw(&t);
+   cfsetispeed(&t, sp);
+   cfsetospeed(&t, sp);
+   t.c_cc[VMIN] = 1;
+   t.c_cc[VTIME] = 0;
+   if (tcsetattr(fd, TCSANOW, &t) < 0) {
+      perror("tcsetattr");
+      return (-1);
+   }
+   return (0);
+}
+
+class Decoder {
+public:
+   unsigned long frames, bad, lost, bytes, samples;
+   uint64_t t_first, t_last;
+   ChanStat ch[N_CH];
+   int csv;
+
+   Decoder() {
+      frames = bad = lost = bytes = samples = 0;
+      t_first = t_last = 0;
+      memset(ch, 0, sizeof(ch));
+      csv = 1;
+      prev_seq = 0;
+      prev_time = 0;
+   }
+
+   // one byte of the stream
+   void put(uint8_t b) {
+      bytes++;
+      if (b != 0) {
+         chunk.push_back(b);
+         return;
+      }
+      if (!chunk.empty())
+         frame();
+      chunk.clear();
+   }
+
+   void report() {
+      double span = (double) (t_last - t_first) / 1e6;
+
+      fprintf(stderr, "frames %lu, bad chunks %lu, lost frames %lu\n", frames, bad, lost);
+      if (frames > 0)
+         fprintf(stderr, "bytes %lu: %.1f per frame, %.1f per sample\n", bytes,
+                 (double) bytes / frames, samples ? (double) bytes / samples : 0.0);
+      if (frames > 1 && span > 0)
+         fprintf(stderr, "span %.3f s, %.2f frames/s\n", span, (frames - 1) / span);
+      fprintf(stderr, "  ch       n         min         max        mean\n");
+      for (int i = 0; i < N_CH; i++) {
+         if (ch[i].n)
+            fprintf(stderr, "%4d%8lu%12.4f%12.4f%12.4f\n", i, ch[i].n, ch[i].min, ch[i].max,
+                    ch[i].sum / ch[i].n);
+      }
+   }
+
+private:
+   std::vector<uint8_t> chunk;
+   uint8_t prev_seq;
+   uint32_t prev_time;
+
+   void frame() {
+      TelemFrame f;
+      size_t k;
+
+      // text before a frame: the frame is the longest valid tail
+      for (k = 0; k < chunk.size(); k++) {
+         if (chunk.size() - k > TELEM_FRAME_MAX)
+            continue;
+         if (telem_decode(&chunk[k], (int) (chunk.size() - k), &f) == 0)
+            break;
+      }
+      if (k == chunk.size()) {
+         bad++;
+         return;
+      }
+      if (frames == 0) {
+         t_first = f.time_us;
+         t_last = f.time_us;
+      } else {
+         lost = lost + (uint8_t) (f.seq - prev_seq - 1);
+         t_last = t_last + (uint32_t) (f.time_us - prev_time);
+      }
+      prev_seq = f.seq;
+      prev_time = f.time_us;
+      frames++;
+      for (int i = 0; i < f.n; i++) {
+         ChanStat &c = ch[f.s[i].ch];
+         double v = (double) f.s[i].v / (1 << f.s[i].frac_bits);
+
+         if (c.n == 0 || v < c.min)
+            c.min = v;
+         if (c.n == 0 || v > c.max)
+            c.max = v;
+         c.sum = c.sum + v;
+         c.n++;
+         samples++;
+         if (csv)
+            printf("%u,%llu,%d,%.4f\n", f.seq, (unsigned long long) t_last, f.s[i].ch, v);
+      }
+   }
+};
+
+int main(int argc, char **argv) {
+   const char *path = 0;
+   long baud = 921600;
+   Decoder dec;
+   uint8_t buf[256];
+   ssize_t n;
+   int fd;
+
+   for (int i = 1; i < argc; i++) {
+      if (strcmp(argv[i], "-q") == 0)
+         dec.csv = 0;
+      else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+         baud = atol(argv[++i]);
+      else
+         path = argv[i];
+   }
+   if (path == 0) {
+      fprintf(stderr, "usage: %s [-q] [-b baud] telem.bin|tty\n", argv[0]);
+      return (2);
+   }
+   fd = open(path, O_RDONLY | O_NOCTTY);
+   if (fd < 0) {
+      perror(path);
+      return (2);
+   }
+   if (isatty(fd)) {
+      if (set_raw(fd, baud) < 0)
+         return (2);
+      signal(SIGINT, on_sigint);
+   }
+   if (dec.csv)
+      printf("seq,time_us,channel,value\n");
+   while (!stop && (n = read(fd, buf, sizeof(buf))) > 0) {
+      for (ssize_t i = 0; i < n; i++)
+         dec.put(buf[i]);
+      if (dec.csv)
+         fflush(stdout);
+   }
+   close(fd);
+   dec.report();
+   return (0);
+}
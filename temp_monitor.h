@@ -0,0 +1,86 @@
+/*****************************************************************//**
+ * @file temp_monitor.h
+ *
+ * @brief dual temperature monitor functions
+ *
+ * Detailed description:
+ *  - internal temp: XADC die sensor; left 4 digits and left RGB
+ *  - external temp: ADT7420 over i2c; right 4 digits and right RGB
+ *  - segsSel/rgbPos: 1 selects the left (internal) side, 0 the right
+ *  - shared by main_sampler_test.cpp and the host benchmarks
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _TEMP_MONITOR_H_INCLUDED
+#define _TEMP_MONITOR_H_INCLUDED
+
+#include "chu_init.h"
+#include "gpio_cores.h"
+#include "xadc_core.h"
+#include "sseg_core.h"
+#include "i2c_core.h"
+
+/**
+ * read the temperature limit (Celsius) from SW8-14 (segsSel 1) or SW0-6
+ */
+int getTempLimit(GpiCore *sw_p, int segsSel);
+
+/**
+ * mirror the two limits on LED0-6 (lower) and LED8-14 (upper)
+ */
+void dispTempLimit(GpoCore *led_p, int lowerLim, int upperLim);
+
+/**
+ * read the format switch: SW15 (segsSel 1) or SW7; 1 for Fahrenheit
+ */
+int getTempFormat(GpiCore *sw_p, int segsSel);
+
+/**
+ * set an RGB led to red (color 1) or green (color 0) at 30% brightness
+ */
+void setRGB(PwmCore *pwm_p, int color, int rgbPos);
+
+/**
+ * read the FPGA die temperature (Celsius) and print it over uart
+ */
+float getIntTempC(XadcCore *adc_p);
+
+/**
+ * convert the ADT7420 temperature registers (2 bytes, MSB first) to Celsius
+ */
+float adt2cel(const uint8_t *bytes);
+
+/**
+ * read the ADT7420 temperature code (Q4, 1/16 C per LSB) without printing
+ */
+int readExtTempCode(I2cCore *adt7420_p);
+
+/**
+ * read the ADT7420 temperature (Celsius) and print it over uart
+ */
+float getExtTempC(I2cCore *adt7420_p);
+
+/**
+ * convert Celsius to Fahrenheit
+ */
+float cel2fer(float tmpC);
+
+/**
+ * blank all digits and decimal points
+ */
+void clearDisp(SsegCore *sseg_p);
+
+/**
+ * display a temperature on 4 digits (value and C/F symbol)
+ * @return true if the displayed value is at least 100 (no tenths digit)
+ */
+bool dispTemp(SsegCore *sseg_p, float tmpC, float tmpF, int isFer, int segsSel);
+
+/**
+ * place the decimal points according to the dispTemp() results
+ */
+void dispDp(SsegCore *sseg_p, bool intIsHundred, bool extIsHundred);
+
+#endif  // _TEMP_MONITOR_H_INCLUDED
@@ -43,22 +43,58 @@ void TimerCore::clear() {
 uint64_t TimerCore::read_tick() {
    uint64_t upper, lower;
 
+   // lower first: the read latches the upper bits
    lower = (uint64_t) io_read(base_addr, COUNTER_LOWER_REG);
    upper = (uint64_t) io_read(base_addr, COUNTER_UPPER_REG);
    return ((upper << 32) | lower);
 }
 
+uint32_t TimerCore::read_tick32() {
+   return (io_read(base_addr, COUNTER_LOWER_REG));
+}
+
 uint64_t TimerCore::read_time() {
    // elapsed time in microsecond (SYS_CLK_FREQ in MHz)
-   return (read_tick() / SYS_CLK_FREQ);
+   return (tick2us(read_tick()));
 }
 
 void TimerCore::sleep(uint64_t us) {
-   uint64_t start_time, now;
+   sleep_tick(us2tick(us));
+}
+
+void TimerCore::sleep_tick(uint64_t ticks) {
+   sleep_until(read_tick() + ticks);
+}
+
+void TimerCore::set_alarm(uint64_t tick) {
+   uint32_t upper;
+
+   // lower first: the lower write disarms, so no match on a half-written value
+   upper = (uint32_t) (tick >> 32) & TIMER_CMP_UPPER_FIELD;
+   io_write(base_addr, CMP_LOWER_REG, (uint32_t) tick);
+   io_write(base_addr, CMP_UPPER_REG, upper | ARM_FIELD);
+}
 
-   start_time = read_time();
-   // busy waiting
-   do {
-      now = read_time();
-   } while ((now - start_time) < us);
+void TimerCore::cancel_alarm() {
+   // arm bit 0: disarm and clear the match flag
+   io_write(base_addr, CMP_UPPER_REG, 0);
+}
+
+int TimerCore::alarm_expired() {
+   return ((io_read(base_addr, STATUS_REG) & MATCH_FIELD) ? 1 : 0);
+}
+
+void TimerCore::sleep_until(uint64_t tick) {
+   set_alarm(tick);
+   // busy waiting on the match flag
+   while (!alarm_expired()) {
+   }
+}
+
+void TimerCore::alarm_irq(int on) {
+   if (on)
+      ctrl = ctrl | IE_FIELD;
+   else
+      ctrl = ctrl & ~IE_FIELD;
+   io_write(base_addr, CTRL_REG, ctrl);
 }
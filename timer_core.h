@@ -13,6 +13,50 @@
 #include "chu_io_rw.h"
 #include "chu_io_map.h"      /* to obtain system clock rate  */
 
+/**********************************************************************
+ * division-free conversion of a 48-bit timer count
+ *  - x / D = (x' * M) >> K, where D = D' * 2^T (D' odd), x' = x >> T,
+ *    K = (48 - T) + ceil(log2(D')) and M = ceil(2^K / D')
+ *  - exact for x < 2^48: the error term x' * (M * D' - 2^K) / 2^K / D'
+ *    is below 1/D', less than the gap to the next multiple
+ *  - the 64x64-bit product is formed from 32x32-bit multiplies, so no
+ *    libgcc 64-bit divide (__udivdi3) is called on the MicroBlaze
+ *********************************************************************/
+constexpr int tick_clog2(uint64_t d) {
+   return ((d <= 1) ? 0 : 1 + tick_clog2((d + 1) / 2));
+}
+
+constexpr int tick_ctz(uint64_t d) {
+   return ((d & 1) ? 0 : 1 + tick_ctz(d >> 1));
+}
+
+/* (a * b) >> k for 0 < k < 64 */
+inline uint64_t tick_mul_shr(uint64_t a, uint64_t b, int k) {
+   uint64_t p0, p1, p2, p3, mid, hi, lo;
+
+   p0 = (uint64_t) (uint32_t) a * (uint32_t) b;
+   p1 = (uint64_t) (uint32_t) a * (uint32_t) (b >> 32);
+   p2 = (uint64_t) (uint32_t) (a >> 32) * (uint32_t) b;
+   p3 = (uint64_t) (uint32_t) (a >> 32) * (uint32_t) (b >> 32);
+   mid = (p0 >> 32) + (uint32_t) p1 + (uint32_t) p2;
+   hi = p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+   lo = (mid << 32) | (uint32_t) p0;
+   return ((hi << (64 - k)) | (lo >> k));
+}
+
+template <uint64_t D>
+inline uint64_t tick_div(uint64_t x) {
+   static constexpr int T = tick_ctz(D);
+   static constexpr uint64_t DO = D >> T;                 // odd part
+   static constexpr int K = (48 - T) + tick_clog2(DO);
+   static_assert(D > 0 && K < 64, "divisor out of range");
+   static constexpr uint64_t M = ((1ULL << K) - 1) / DO + 1;
+
+   if (DO == 1)
+      return (x >> T);
+   return (tick_mul_shr(x >> T, M, K));
+}
+
 /**
  * timer core driver:
  *  - control and retrieve clock count from MMIO timer core.
@@ -25,17 +69,24 @@ public:
     *
     */
    enum {
-      COUNTER_LOWER_REG = 0, /**< lower 32 bits of counter */
-      COUNTER_UPPER_REG = 1, /**< upper 16 bits of counter */
-      CTRL_REG = 2           /**< control register */
+      COUNTER_LOWER_REG = TIMER_COUNTER_LOWER_REG, /**< lower 32 bits of counter */
+      COUNTER_UPPER_REG = TIMER_COUNTER_UPPER_REG, /**< upper 16 bits (latched) */
+      CTRL_REG = TIMER_CTRL_REG,                   /**< control register */
+      STATUS_REG = TIMER_STATUS_REG,               /**< alarm status (read) */
+      CMP_LOWER_REG = TIMER_CMP_LOWER_REG,         /**< lower 32 bits of compare */
+      CMP_UPPER_REG = TIMER_CMP_UPPER_REG          /**< upper 16 bits of compare, arm */
    };
    /**
    * field masks
    *
    */
    enum {
-      GO_FIELD = 0x00000001, /**< bit 0 of ctrl_reg; enable bit  */
-      CLR_FIELD = 0x00000002 /**< bit 1 of ctrl_reg; clear bit */
+      GO_FIELD = TIMER_GO_FIELD,      /**< bit 0 of ctrl_reg; enable bit  */
+      CLR_FIELD = TIMER_CLR_FIELD,    /**< bit 1 of ctrl_reg; clear bit */
+      IE_FIELD = TIMER_IE_FIELD,      /**< bit 2 of ctrl_reg; alarm irq enable */
+      MATCH_FIELD = TIMER_MATCH_FIELD,/**< bit 0 of status_reg; alarm reached */
+      ARMED_FIELD = TIMER_ARMED_FIELD,/**< bit 1 of status_reg; alarm armed */
+      ARM_FIELD = TIMER_ARM_FIELD     /**< bit 16 of cmp_upper_reg; arm bit */
    };
    /* methods */
    /**
@@ -69,9 +120,24 @@ public:
    /**
     * read current timing counter value (# clocks elapsed from last clear)
     *
+    * @note the lower-word read latches the upper 16 bits in chu_timer,
+    *       so the two reads form one snapshot (no carry between them)
+    *       and successive values are monotonic until the next clear()
+    * @note not for use from an interrupt handler that may preempt
+    *       another read_tick() (it would replace the latched bits)
+    *
     */
    uint64_t read_tick();
 
+   /**
+    * read the lower 32 bits of the counter (single bus read)
+    *
+    * @note the difference of two values (uint32_t arithmetic) is exact
+    *       for intervals below 2^32 clocks (about 43 s at 100 MHz)
+    *
+    */
+   uint32_t read_tick32();
+
    /**
     * read current time (microseconds elapsed from last clear)
     *
@@ -89,6 +155,80 @@ public:
     */
    void sleep(uint64_t us);
 
+   /**
+    * idle (busy waiting) for a number of clocks
+    *
+    * @param ticks idle time in clocks
+    * @note waits with the alarm (sleep_until()); replaces a pending alarm
+    *
+    */
+   void sleep_tick(uint64_t ticks);
+
+   /**
+    * arm the alarm: the match flag is set when the counter reaches tick
+    *
+    * @param tick absolute counter value (deadline); a deadline already
+    *        passed matches at once
+    * @note one alarm per timer; arming replaces the pending one and
+    *       clears the match flag
+    *
+    */
+   void set_alarm(uint64_t tick);
+
+   /**
+    * disarm the alarm and clear the match flag
+    *
+    */
+   void cancel_alarm();
+
+   /**
+    * check the alarm (single bus read of the status register)
+    *
+    * @return 1 if the armed deadline has been reached; 0 otherwise
+    * @note the flag stays set until the next set_alarm()/cancel_alarm(),
+    *       so a caller may do other work between checks
+    *
+    */
+   int alarm_expired();
+
+   /**
+    * idle until the counter reaches a deadline
+    *
+    * @param tick absolute counter value
+    * @note arms the alarm and polls one status bit per iteration
+    *       (no 48-bit read or comparison in the loop)
+    *
+    */
+   void sleep_until(uint64_t tick);
+
+   /**
+    * enable/disable the alarm interrupt output (irq = match && enable)
+    *
+    * @param on 1 to enable; 0 to disable
+    *
+    */
+   void alarm_irq(int on);
+
+   /**
+    * tick/time conversions (SYS_CLK_FREQ clocks per microsecond)
+    *
+    * @note us2tick()/ms2tick() are compile-time constants for constant
+    *       arguments; tick2us()/tick2ms() use tick_div() (counts < 2^48)
+    *
+    */
+   static constexpr uint64_t us2tick(uint64_t us) {
+      return (us * SYS_CLK_FREQ);
+   }
+   static constexpr uint64_t ms2tick(uint64_t ms) {
+      return (ms * 1000 * SYS_CLK_FREQ);
+   }
+   static uint64_t tick2us(uint64_t tick) {
+      return (tick_div<SYS_CLK_FREQ>(tick));
+   }
+   static uint64_t tick2ms(uint64_t tick) {
+      return (tick_div<1000ULL * SYS_CLK_FREQ>(tick));
+   }
+
 private:
    uint32_t base_addr;
    uint32_t ctrl;    // current state of control register
@@ -9,7 +9,9 @@ module uart
     input logic rd_uart, wr_uart, rx,
     input logic [7:0] w_data,
     input logic [10:0] dvsr,
+    input logic [7:0] dvsr_frac,
     output logic tx_full, rx_empty, tx,
+    output logic [FIFO_W:0] tx_count, rx_count,   // fifo fill levels
     output logic [7:0] r_data
    );
 
@@ -29,11 +31,11 @@ module uart
 
    fifo #(.DATA_WIDTH(DBIT), .ADDR_WIDTH(FIFO_W)) fifo_rx_unit
       (.*, .rd(rd_uart), .wr(rx_done_tick), .w_data(rx_data_out),
-       .empty(rx_empty), .full(), .r_data(r_data));
+       .empty(rx_empty), .full(), .count(rx_count), .r_data(r_data));
 
    fifo #(.DATA_WIDTH(DBIT), .ADDR_WIDTH(FIFO_W)) fifo_tx_unit
       (.*, .rd(tx_done_tick), .wr(wr_uart), .w_data(w_data), .empty(tx_empty),
-       .full(tx_full), .r_data(tx_fifo_out));
+       .full(tx_full), .count(tx_count), .r_data(tx_fifo_out));
 
    assign tx_fifo_not_empty = ~tx_empty;
 endmodule
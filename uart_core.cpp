@@ -8,39 +8,56 @@
  ********************************************************************/
 
 #include "uart_core.h"
+#include "chu_fmt.h"
 
 UartCore::UartCore(uint32_t core_base_addr) {
    base_addr = core_base_addr;
+   tx_mode = TX_DIRECT;
+   tx_head = 0;
+   tx_tail = 0;
+   peak = 0;
+   n_drop = 0;
    set_baud_rate(9600);      //default baud rate
 }
 
 UartCore::~UartCore() {
 }
 
-/* baud rate = sys_clk_freq/16/(dvsr+1) */
+/* baud rate = sys_clk_freq/16/(dvsr+1+dvsr_frac/256) */
 void UartCore::set_baud_rate(int baud) {
-   uint32_t dvsr;
+   // documented range; also keeps baud > 0
+   baud_rate = clamp_baud(baud);
+   dvsr_q8 = baud_dvsr_q8(baud_rate);
+   io_write(base_addr, DVSR_REG, dvsr_word(dvsr_q8));
+}
 
-   dvsr = SYS_CLK_FREQ*1000000 / 16 / baud - 1;
-   io_write(base_addr, DVSR_REG, dvsr);
+int UartCore::get_baud_rate() {
+   return ((int) (((uint32_t) SYS_CLK_FREQ*1000000*16 + dvsr_q8 / 2) / dvsr_q8));
 }
 
-int UartCore::rx_fifo_empty() {
-   uint32_t rd_word;
-   int empty;
+int UartCore::get_baud_error() {
+   int64_t diff, prod;
+
+   // actual/requested - 1 = sys_clk_freq*16/(dvsr_q8*baud) - 1
+   prod = (int64_t) dvsr_q8 * baud_rate;
+   diff = (int64_t) SYS_CLK_FREQ*1000000*16 - prod;
+   return ((int) (diff * 1000000 / prod));
+}
 
-   rd_word = io_read(base_addr, RD_DATA_REG);
-   empty = (int) (rd_word & RX_EMPT_FIELD) >> 8;
-   return (empty);
+int UartCore::rx_fifo_empty() {
+   return (io_read_field(base_addr, uart_regs::RX_EMPT));
 }
 
 int UartCore::tx_fifo_full() {
-   uint32_t rd_word;
-   int full;
+   return (io_read_field(base_addr, uart_regs::TX_FULL));
+}
+
+int UartCore::tx_fifo_free() {
+   return (io_read_field(base_addr, uart_regs::TX_FREE));
+}
 
-   rd_word = io_read(base_addr, RD_DATA_REG);
-   full = (int) (rd_word & TX_FULL_FIELD) >> 9;
-   return (full);
+int UartCore::rx_fifo_used() {
+   return (io_read_field(base_addr, uart_regs::RX_USED));
 }
 
 void UartCore::tx_byte(uint8_t byte) {
@@ -55,69 +72,110 @@ int UartCore::rx_byte() {
    if (rx_fifo_empty())
       return (-1);
    else {
-      data = io_read(base_addr, RD_DATA_REG) & RX_DATA_FIELD;
+      data = io_read_field(base_addr, uart_regs::RX_DATA);
       io_write(base_addr, RM_RD_DATA_REG, 0); //dummy write to remove data from rx FIFO
       return ((int) data);
    }
 }
 
+int UartCore::write(const uint8_t *data, int n) {
+   int free, i;
+
+   free = tx_fifo_free();
+   if (n > free)
+      n = free;
+   for (i = 0; i < n; i++)
+      io_write(base_addr, WR_DATA_REG, (uint32_t) data[i]);
+   return (n);
+}
+
+int UartCore::read(uint8_t *data, int n) {
+   int used, i;
+
+   used = rx_fifo_used();
+   if (n > used)
+      n = used;
+   for (i = 0; i < n; i++) {
+      data[i] = (uint8_t) io_read_field(base_addr, uart_regs::RX_DATA);
+      io_write(base_addr, RM_RD_DATA_REG, 0);
+   }
+   return (n);
+}
+
 void UartCore::disp(const char *str) {
    disp_str(str);
 }
 
 void UartCore::disp(char ch) {
-    tx_byte(ch);
+   if (tx_mode == TX_DIRECT)
+      tx_byte(ch);
+   else
+      tx_put(ch);
+}
+
+/* log2(base) for 2/8/16; 0 for base 10 (any other base is taken as 10) */
+static int base_shift(int base) {
+   if (base == 2)
+      return (1);
+   if (base == 8)
+      return (3);
+   if (base == 16)
+      return (4);
+   return (0);
 }
 
 void UartCore::disp(int n, int base, int len) {
-   char buf[33];         // 32 bit #
-   char *str, ch, sign;
-   int rem, i;
+   char buf[34];         // 32 binary digits, sign, '\0'
+   char *end, *str;
+   int shift;
    unsigned int un;
 
    /* error check */
-   if (base != 2 && base != 8 && base != 16)
-      base = 10;
+   shift = base_shift(base);
    if (len > 32)
       len = 32;
-   /* handle neg decimal # */
-   if (base == 10 && n < 0) {
-      un = (unsigned) -n;
-      sign = '-';
-   } else {
+   /* convert # to string (no division; see chu_fmt.h) */
+   end = &buf[33];
+   *end = '\0';
+   if (shift != 0) {
       un = (unsigned) n; // interpreted as unsigned for hex/bin conversion
-      sign = ' ';
-   }
-   /* convert # to string */
-   str = &buf[33];
-   *str = '\0';
-   i = 0;
-   do {
-      str--;
-      rem = un % base;
-      un = un / base;
-      if (rem < 10)
-         ch = (char) rem + '0';
-      else
-         ch = (char) rem - 10 + 'a';
-      *str = ch;
-      i++;
-   } while (un);
-   /* attach - sign for neg decimal # */
-   if (sign == '-') {
-      str--;
-      *str = sign;
-      i++;
+      str = fmt_pow2_32(end, un, shift);
+   } else if (n < 0) {
+      un = 0u - (unsigned) n;
+      str = fmt_dec32(end, un);
+      *--str = '-';
+   } else {
+      str = fmt_dec32(end, (unsigned) n);
    }
    /* pad with blank */
-   while (i < len) {
-      str--;
-      *str = ' ';
-      i++;
-   };
+   while (end - str < len)
+      *--str = ' ';
    disp_str(str);
 }
 
+void UartCore::disp_u64(uint64_t n, int base, int len) {
+   char buf[65];         // 64 binary digits, '\0'
+   char *end, *str;
+   int shift;
+
+   shift = base_shift(base);
+   if (len > 64)
+      len = 64;
+   end = &buf[64];
+   *end = '\0';
+   if (shift != 0)
+      str = fmt_pow2_64(end, n, shift);
+   else
+      str = fmt_dec64(end, n);
+   while (end - str < len)
+      *--str = ' ';
+   disp_str(str);
+}
+
+void UartCore::disp_u64(uint64_t n) {
+   disp_u64(n, 10, 0);
+}
+
 void UartCore::disp(int n) {
    disp(n, 10, 0);
 }
@@ -126,27 +184,65 @@ void UartCore::disp(int n, int base) {
    disp(n, base, 0);
 }
 
+/* sign, integer part, point and digits of a Q0.32 fraction as one string */
+void UartCore::disp_q32(int neg, uint32_t ip, uint32_t fq, int digit) {
+   char buf[48];         // sign, 10 integer digits, point, 32 digits, '\0'
+   char *str, *p;
+
+   if (digit > 32)
+      digit = 32;
+   str = fmt_dec32(&buf[12], ip);
+   if (neg)
+      *--str = '-';
+   buf[12] = '.';
+   p = fmt_frac_q32(&buf[13], fq, digit);
+   *p = '\0';
+   disp_str(str);
+}
+
 void UartCore::disp(double f, int digit) {
-   double fa, frac; // absolute value of f
-   int n, i, i_part;
+   uint32_t ip, fq;
+   int neg;
 
-   fa = f;
-   if (f < 0.0) {
-      fa = -f;
-      disp_str("-");
-   }
-   // display integer portion
-   i_part = (int) fa; // integer part of f
-   disp(i_part);
-   disp_str(".");
-   // display fraction part
-   frac = fa - (double) i_part;
-   for (n = 0; n < digit; n++) {
-      frac = frac * 10.0;
-      i = (int) frac;
-      disp(i);
-      frac = frac - i;
+   neg = fmt_dbl_split(f, &ip, &fq);
+   disp_q32(neg, ip, fq, digit);
+}
+
+void UartCore::disp_fix(int32_t v, int frac_bits, int digit) {
+   uint32_t uv;
+
+   uv = (v < 0) ? 0u - (uint32_t) v : (uint32_t) v;
+   if (frac_bits <= 0)
+      disp_q32(v < 0, uv, 0, digit);
+   else
+      disp_q32(v < 0, uv >> frac_bits, uv << (32 - frac_bits), digit);
+}
+
+void UartCore::disp_scaled(int n, int point) {
+   char buf[16];         // sign, 10 digits, point, zeros, '\0'
+   char *str, *end;
+   uint32_t un;
+   int i, n_int;
+
+   if (point > 9)
+      point = 9;
+   un = (n < 0) ? 0u - (uint32_t) n : (uint32_t) n;
+   end = &buf[14];
+   *end = '\0';
+   str = fmt_dec32(end, un);
+   if (point > 0) {
+      // at least one integer digit: pad to point+1 digits
+      while (end - str < point + 1)
+         *--str = '0';
+      n_int = (int) (end - str) - point;
+      for (i = 0; i < n_int; i++)
+         str[i - 1] = str[i];       // shift the integer part left
+      str--;
+      str[n_int] = '.';
    }
+   if (n < 0)
+      *--str = '-';
+   disp_str(str);
 }
 
 void UartCore::disp(double f) {
@@ -154,10 +250,83 @@ void UartCore::disp(double f) {
 }
 
 void UartCore::disp_str(const char *str) {
-   while ((uint8_t) *str) {
-      tx_byte(*str);
-      str++;
+   int len;
+
+   for (len = 0; str[len] != '\0'; len++) {
+   }
+   disp_buf(str, len);
+}
+
+void UartCore::disp_buf(const char *buf, int len) {
+   int n, i;
+
+   // direct: one level read per burst instead of a status read per byte
+   if (tx_mode == TX_DIRECT) {
+      while (len > 0) {
+         n = tx_fifo_free();
+         if (n > len)
+            n = len;
+         for (i = 0; i < n; i++)
+            io_write(base_addr, WR_DATA_REG, (uint32_t) (uint8_t) buf[i]);
+         buf = buf + n;
+         len = len - n;
+      }
+      return;
+   }
+   // drop the whole string rather than send a truncated line
+   if (tx_mode == TX_DROP && len > UART_TX_BUF_SIZE - tx_pending()) {
+      n_drop = n_drop + len;
+      return;
+   }
+   for (i = 0; i < len; i++)
+      tx_put(buf[i]);
+}
+
+void UartCore::tx_put(uint8_t byte) {
+   if (tx_head - tx_tail == UART_TX_BUF_SIZE) {
+      if (tx_mode == TX_DROP) {
+         n_drop++;
+         return;
+      }
+      while (tx_poll() == 0) {
+      };  // busy waiting
    }
+   tx_buf[tx_head & (UART_TX_BUF_SIZE - 1)] = byte;
+   tx_head++;
+   if (tx_head - tx_tail > peak)
+      peak = tx_head - tx_tail;
+}
+
+void UartCore::set_tx_mode(int mode) {
+   if (mode == TX_DIRECT)
+      tx_flush();
+   tx_mode = mode;
+}
+
+int UartCore::tx_poll() {
+   int n, i;
+
+   if (tx_tail == tx_head)
+      return (0);
+   n = tx_fifo_free();
+   if (n > tx_pending())
+      n = tx_pending();
+   for (i = 0; i < n; i++) {
+      io_write(base_addr, WR_DATA_REG, (uint32_t) tx_buf[tx_tail & (UART_TX_BUF_SIZE - 1)]);
+      tx_tail++;
+   }
+   return (n);
+}
+
+void UartCore::tx_flush() {
+   while (tx_tail != tx_head)
+      tx_poll();
+}
+
+int UartCore::tx_room() {
+   if (tx_mode == TX_DIRECT)
+      return (tx_fifo_free());
+   return (UART_TX_BUF_SIZE - tx_pending());
 }
 
 
@@ -13,33 +13,64 @@
 
 #include "chu_io_rw.h"
 #include "chu_io_map.h"  // to use SYS_CLK_FREQ
+#include "chu_io_regs.h"
+
+#ifndef UART_TX_BUF_BIT
+#define UART_TX_BUF_BIT 10    // software tx buffer: 1024 bytes
+#endif
+#define UART_TX_BUF_SIZE (1 << UART_TX_BUF_BIT)
+
 /**
  * uart core driver
  * - transmit/receive data via MMIO uart core.
  * - display (print) number and string on serial console
+ * - tx mode: disp() either writes the tx fifo directly (busy-waits when
+ *   it is full) or appends to a software ring buffer that tx_poll()
+ *   moves to the tx fifo; a full buffer drops the string (counted) or
+ *   blocks until tx_poll() makes room
  *
  */
 class UartCore {
+public:
    /**
     * register map
     *
     */
    enum {
-      RD_DATA_REG = 0,   /**< rx data/status register */
-      DVSR_REG = 1,      /**< baud rate divisor register */
-      WR_DATA_REG = 2,   /**< wr data register */
-      RM_RD_DATA_REG = 3 /**< remove read data offset */
+      RD_DATA_REG = UART_RD_DATA_REG,       /**< rx data/status register */
+      DVSR_REG = UART_DVSR_REG,             /**< baud rate divisor register */
+      LEVEL_REG = UART_LEVEL_REG,           /**< fifo level register (read) */
+      WR_DATA_REG = UART_WR_DATA_REG,       /**< wr data register */
+      RM_RD_DATA_REG = UART_RM_RD_DATA_REG  /**< remove read data offset */
    };
   /**
    * mask fields
    *
    */
    enum {
-      TX_FULL_FIELD = 0x00000200, /**< bit 9 of rd_data_reg; full bit  */
-      RX_EMPT_FIELD = 0x00000100, /**< bit 10 of rd_data_reg; empty bit */
-      RX_DATA_FIELD = 0x000000ff  /**< bits 7..0 rd_data_reg; read data */
+      TX_FULL_FIELD = UART_TX_FULL_FIELD, /**< bit 9 of rd_data_reg; full bit  */
+      RX_EMPT_FIELD = UART_RX_EMPT_FIELD, /**< bit 8 of rd_data_reg; empty bit */
+      RX_DATA_FIELD = UART_RX_DATA_FIELD, /**< bits 7..0 rd_data_reg; read data */
+      TX_FREE_FIELD = UART_TX_FREE_FIELD, /**< bits 31..16 level_reg; free tx entries */
+      RX_USED_FIELD = UART_RX_USED_FIELD  /**< bits 15..0 level_reg; rx bytes */
+   };
+  /**
+   * tx mode of disp()
+   *
+   */
+   enum {
+      TX_DIRECT = 0,   /**< write the tx fifo; busy-wait when full (default) */
+      TX_DROP = 1,     /**< buffer; drop a string that does not fit */
+      TX_BLOCK = 2     /**< buffer; drain (busy-wait) when full */
+   };
+  /**
+   * baud rate range of the divisor (set_baud_rate() clamps to it)
+   *
+   */
+   enum {
+      BAUD_MIN = SYS_CLK_FREQ * 1000000 / 16 / 2048 + 1,   /**< dvsr 2047.996 */
+      BAUD_MAX = SYS_CLK_FREQ * 1000000 / 32               /**< dvsr 1 */
    };
-public:
    /* methods */
    /**
     * constructor.
@@ -53,10 +84,62 @@ public:
     * set baud rate
     *
     * @param baud baud rate
-    * @note baud rate = sys_clk_freq/16/(dvsr+1)
+    * @note baud rate = sys_clk_freq/16/(dvsr+1+dvsr_frac/256); the
+    *       closest divisor is selected (error below 0.01% up to
+    *       921600 baud at 100 MHz); the range is sys_clk_freq/16/2048
+    *       to sys_clk_freq/32 (BAUD_MIN to BAUD_MAX); a rate outside it
+    *       is clamped
     */
    void set_baud_rate(int baud);
 
+   /**
+    * clamp a baud rate to BAUD_MIN to BAUD_MAX
+    */
+   static int clamp_baud(int baud) {
+      return ((baud < BAUD_MIN) ? BAUD_MIN : (baud > BAUD_MAX) ? BAUD_MAX : baud);
+   }
+
+   /**
+    * closest divisor of a baud rate (also used by slot_cores.h)
+    *
+    * @param baud baud rate (clamped)
+    * @return (dvsr+1)*256 + dvsr_frac = sys_clk_freq*16/baud, rounded
+    *
+    */
+   static uint32_t baud_dvsr_q8(int baud) {
+      uint32_t b = (uint32_t) clamp_baud(baud);
+      uint32_t q8 = ((uint32_t) SYS_CLK_FREQ * 1000000 * 16 + b / 2) / b;
+
+      if (q8 < 2 * 256)
+         q8 = 2 * 256;                // dvsr=0 stops the baud tick
+      if (q8 > 2048 * 256)
+         q8 = 2048 * 256;
+      return (q8);
+   }
+
+   /**
+    * divisor register word of a baud_dvsr_q8() value
+    */
+   static uint32_t dvsr_word(uint32_t q8) {
+      return (((q8 >> 8) - 1) << UART_DVSR_LSB | (q8 & 0xff) << UART_DVSR_FRAC_LSB);
+   }
+
+   /**
+    * get the actual baud rate of the selected divisor
+    *
+    * @return baud rate
+    *
+    */
+   int get_baud_rate();
+
+   /**
+    * get the error of the actual baud rate
+    *
+    * @return (actual - requested) / requested in ppm
+    *
+    */
+   int get_baud_error();
+
    /**
     * check whether uart receiver fifo is empty
     *
@@ -73,6 +156,22 @@ public:
     */
    int tx_fifo_full();
 
+   /**
+    * get # free entries in the transmitter fifo
+    *
+    * @return 0 (full) to the fifo depth (empty)
+    *
+    */
+   int tx_fifo_free();
+
+   /**
+    * get # bytes in the receiver fifo
+    *
+    * @return 0 (empty) to the fifo depth
+    *
+    */
+   int rx_fifo_used();
+
    /**
     * transmit a byte
     *
@@ -92,6 +191,29 @@ public:
     */
    int rx_byte();
 
+   /**
+    * transmit a block of bytes without waiting
+    *
+    * @param data bytes to be transmitted
+    * @param n # bytes
+    * @return # bytes written to the tx fifo (less than n if it fills)
+    *
+    * @note one level read, then one write per byte (tx_byte() reads the
+    *       status before every byte)
+    */
+   int write(const uint8_t *data, int n);
+
+   /**
+    * receive a block of bytes without waiting
+    *
+    * @param data buffer for the received bytes
+    * @param n buffer size
+    * @return # bytes read (0 if rx fifo empty)
+    *
+    * @note one level read, then one read and one remove per byte
+    */
+   int read(uint8_t *data, int n);
+
    /**
     * display (print) a char on a serial terminal console
     *
@@ -108,6 +230,17 @@ public:
     */
    void disp(const char *str);
 
+   /**
+    * display (print) a block of chars in one bulk transfer
+    *
+    * @param buf chars to be displayed (no terminator needed)
+    * @param len # of chars
+    * @note tx fifo level read once per burst (TX_DIRECT) or one space
+    *       check (TX_DROP: the block is sent or dropped whole)
+    *
+    */
+   void disp_buf(const char *buf, int len);
+
    /**
     * display (print) an integer on a serial terminal console
     *
@@ -143,6 +276,26 @@ public:
     */
    void disp(int n);
 
+   /**
+    * display (print) a 64-bit unsigned integer on a serial terminal console
+    *
+    * @param n integer to be displayed (e.g., timer ticks)
+    * @param base 2/8/10/16 for binary/octal/decimal/hex format
+    * @param len # of digits (length) to be displayed
+    *
+    * @note padding as disp(int n, int base, int len)
+    *
+    */
+   void disp_u64(uint64_t n, int base, int len);
+
+   /**
+    * display (print) a 64-bit unsigned integer in base 10
+    *
+    * @param n integer to be displayed
+    *
+    */
+   void disp_u64(uint64_t n);
+
    /**
     * display (print) a floating-point number on a serial terminal console
     *
@@ -150,6 +303,8 @@ public:
     * @param digit # of digits (length) in fraction portion to be displayed
     * @note base 10 used
     * @note length in integer determined automatically
+    * @note converted once to a fixed-point value with integer operations
+    *       (no soft-float calls); digits are truncated
     *
     */
    void disp(double f, int digit);
@@ -165,9 +320,99 @@ public:
     */
    void disp(double f);
 
+   /**
+    * display (print) a fixed-point (Q-format) number
+    *
+    * @param v value * 2^frac_bits (e.g., ADT7420 13-bit code, Q4)
+    * @param frac_bits # of fraction bits (0 to 31)
+    * @param digit # of digits in fraction portion (truncated)
+    * @note same text as disp((double) v / 2^frac_bits, digit)
+    *
+    */
+   void disp_fix(int32_t v, int frac_bits, int digit);
+
+   /**
+    * display (print) a scaled integer with a decimal point
+    *
+    * @param n value * 10^point (e.g., 2512 for 25.12 with point=2)
+    * @param point # of digits after the decimal point (0 to 9)
+    *
+    */
+   void disp_scaled(int n, int point);
+
+   /**
+    * select the tx mode of disp()
+    *
+    * @param mode TX_DIRECT, TX_DROP or TX_BLOCK
+    * @note buffered data is flushed when switching to TX_DIRECT
+    *
+    */
+   void set_tx_mode(int mode);
+
+   /** current tx mode of disp() */
+   int get_tx_mode() {
+      return (tx_mode);
+   }
+
+   /**
+    * move buffered bytes to the tx fifo until it is full
+    *
+    * @return # bytes moved
+    * @note no bus access when the buffer is empty; call it from the
+    *       main loop (e.g., a scheduler task) often enough that the
+    *       tx fifo does not run dry
+    *
+    */
+   int tx_poll();
+
+   /**
+    * busy-wait until all buffered bytes are in the tx fifo
+    *
+    */
+   void tx_flush();
+
+   /**
+    * get # bytes disp_buf() accepts now without waiting or dropping
+    *
+    * @return tx fifo free entries (TX_DIRECT; 1 bus read) or free
+    *         software buffer space (TX_DROP/TX_BLOCK; no bus access)
+    *
+    */
+   int tx_room();
+
+   /** # bytes in the software buffer */
+   int tx_pending() {
+      return ((int) (tx_head - tx_tail));
+   }
+
+   /** # bytes dropped (TX_DROP) since the last tx_clear_stats() */
+   unsigned long tx_dropped() {
+      return (n_drop);
+   }
+
+   /** highest buffer fill (bytes) since the last tx_clear_stats() */
+   int tx_peak() {
+      return ((int) peak);
+   }
+
+   /** clear the drop count and the peak fill */
+   void tx_clear_stats() {
+      n_drop = 0;
+      peak = tx_head - tx_tail;
+   }
+
 private:
    uint32_t base_addr;
-   int baud_rate;
+   int baud_rate;             // requested
+   uint32_t dvsr_q8;          // (dvsr+1)*256 + dvsr_frac
+   int tx_mode;
+   uint8_t tx_buf[UART_TX_BUF_SIZE];
+   uint32_t tx_head;          // next write (free running)
+   uint32_t tx_tail;          // next read (free running)
+   uint32_t peak;
+   unsigned long n_drop;
+   void tx_put(uint8_t byte);
+   void disp_q32(int neg, uint32_t ip, uint32_t fq, int digit);
    void disp_str(const char *str);
 };
 
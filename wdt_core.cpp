@@ -0,0 +1,52 @@
+/*****************************************************************//**
+ * @file wdt_core.cpp
+ *
+ * @brief implementation of WdtCore class
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#include "wdt_core.h"
+
+WdtCore::WdtCore(uint32_t core_base_addr) {
+   base_addr = core_base_addr;
+}
+
+WdtCore::~WdtCore() {
+}
+
+void WdtCore::start(uint32_t timeout) {
+   // disable first: the counter is reloaded when enabled
+   io_write(base_addr, CTRL_REG, 0);
+   io_write(base_addr, LOAD_REG, timeout);
+   io_write(base_addr, CTRL_REG, EN_FIELD);
+}
+
+void WdtCore::stop() {
+   io_write(base_addr, CTRL_REG, 0);
+}
+
+void WdtCore::kick(int tag) {
+   io_write(base_addr, KICK_REG, KICK_KEY | ((uint32_t) tag & WDT_TAG_FIELD));
+}
+
+int WdtCore::fired() {
+   return ((int) io_read_field(base_addr, wdt_regs::RST_FLAG));
+}
+
+int WdtCore::tag() {
+   return ((int) io_read_field(base_addr, wdt_regs::LAST_TAG));
+}
+
+void WdtCore::clear_flag() {
+   uint32_t en;
+
+   // keep the enable bit
+   en = io_read_field(base_addr, wdt_regs::EN_ST);
+   io_write(base_addr, CTRL_REG, (en ? EN_FIELD : 0) | CLR_FLAG_FIELD);
+}
+
+uint32_t WdtCore::remaining() {
+   return (io_read(base_addr, COUNT_REG));
+}
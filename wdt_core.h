@@ -0,0 +1,113 @@
+/*****************************************************************//**
+ * @file wdt_core.h
+ *
+ * @brief Control the MMIO watchdog core (chu_watchdog)
+ *
+ * Detailed description:
+ *  - the core resets the cpu and the mmio cores unless kicked within
+ *    the timeout; it then disables itself and sets a reset flag
+ *  - each kick stores a 16-bit tag (kicks are ignored while disabled,
+ *    so the tag of the hung task is kept); flag, tag and timeout are cleared
+ *    only by the board reset, so after a watchdog reset the firmware
+ *    can read which tag (e.g., scheduler task) was running
+ *  - the core powers up disabled
+ *
+ * @author SOC_Final_Project
+ * @version v1.0: initial release
+ ********************************************************************/
+
+#ifndef _WDT_CORE_H_INCLUDED
+#define _WDT_CORE_H_INCLUDED
+
+#include "chu_init.h"
+#include "chu_io_regs.h"
+
+/**
+ * watchdog core driver
+ *
+ */
+class WdtCore {
+public:
+   /**
+    * register map
+    *
+    */
+   enum {
+      CTRL_REG = WDT_CTRL_REG,     /**< control (write) */
+      STATUS_REG = WDT_STATUS_REG, /**< status (read) */
+      LOAD_REG = WDT_LOAD_REG,     /**< timeout (write) */
+      COUNT_REG = WDT_COUNT_REG,   /**< clocks left (read) */
+      KICK_REG = WDT_KICK_REG,     /**< kick with key and tag (write) */
+      TAG_REG = WDT_TAG_REG        /**< tag of the last kick (read) */
+   };
+   /**
+    * field masks
+    *
+    */
+   enum {
+      EN_FIELD = WDT_EN_FIELD,             /**< ctrl bit 0: enable */
+      CLR_FLAG_FIELD = WDT_CLR_FLAG_FIELD, /**< ctrl bit 1: clear reset flag */
+      KICK_KEY = WDT_KEY_MAGIC << WDT_KEY_LSB
+   };
+   /* methods */
+   /**
+    * constructor.
+    * @note no bus access: the state left by a watchdog reset is kept
+    *
+    */
+   WdtCore(uint32_t core_base_addr);
+   ~WdtCore();                  // not used
+
+   /**
+    * set the timeout and enable the watchdog
+    *
+    * @param timeout # clocks allowed between kicks
+    *
+    */
+   void start(uint32_t timeout);
+
+   /**
+    * disable the watchdog
+    *
+    */
+   void stop();
+
+   /**
+    * reload the counter (single bus write)
+    *
+    * @param tag 16-bit tag kept across a watchdog reset
+    *
+    */
+   void kick(int tag = 0);
+
+   /**
+    * check whether the last reset was caused by the watchdog
+    *
+    * @return 1 for a watchdog reset; 0 otherwise
+    *
+    */
+   int fired();
+
+   /**
+    * tag of the last kick (before the reset if fired())
+    *
+    */
+   int tag();
+
+   /**
+    * clear the reset flag
+    *
+    */
+   void clear_flag();
+
+   /**
+    * # clocks left before the watchdog resets the system
+    *
+    */
+   uint32_t remaining();
+
+private:
+   uint32_t base_addr;
+};
+
+#endif  // _WDT_CORE_H_INCLUDED
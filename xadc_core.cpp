@@ -15,17 +15,15 @@ uint16_t XadcCore::read_raw(int n) {
 }
 
 double XadcCore::read_adc_in(int n) {
-   uint16_t raw;
-   raw = read_raw(n) >> 4;
-   return ((double) raw / 4096.0);
+   return (raw2adc_in(read_raw(n)));
 }
 
 // input source 5 is connected to vcc reading
 double XadcCore::read_fpga_vcc() {
-   return (read_adc_in(VCC_REG) * 3.0);
+   return (adc_in2vcc(read_adc_in(VCC_REG)));
 }
 
 // input source 4 is connected to temperature reading
 double XadcCore::read_fpga_temp() {
-   return (read_adc_in(TMP_REG) * 503.975 - 273.15);
+   return (adc_in2temp(read_adc_in(TMP_REG)));
 }
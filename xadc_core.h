@@ -31,9 +31,9 @@ public:
     * Register map
     */
    enum {
-      ADC_0_REG = 0, /**< 16-bit data from Nexys-4 adc input #0   */
-      TMP_REG   = 4,   /**< FPGA internal temperature */
-      VCC_REG   = 5,   /**< FPGA internal core volatge */
+      ADC_0_REG = XADC_ADC_0_REG, /**< 16-bit data from Nexys-4 adc input #0   */
+      TMP_REG   = XADC_TMP_REG,   /**< FPGA internal temperature */
+      VCC_REG   = XADC_VCC_REG,   /**< FPGA internal core volatge */
    };
 
    /**
@@ -42,6 +42,22 @@ public:
    XadcCore(uint32_t core_base_addr);
    ~XadcCore(); // not used
 
+   /* conversions of a raw reading (also used by slot_cores.h) */
+   /** adc voltage (0.0 to 1.0) of a raw reading; 12 MSBs used */
+   static double raw2adc_in(uint16_t raw) {
+      return ((double) (raw >> 4) / 4096.0);
+   }
+
+   /** FPGA core vcc of an adc voltage (vcc=3*(adc reading)) */
+   static double adc_in2vcc(double v) {
+      return (v * 3.0);
+   }
+
+   /** FPGA core temperature in Celsius of an adc voltage (ug480) */
+   static double adc_in2temp(double v) {
+      return (v * 503.975 - 273.15);
+   }
+
    /**
     * retrieve raw xadc data.
     *